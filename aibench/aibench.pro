@@ -0,0 +1,23 @@
+# aibench.pro
+# 无界面的 AI 批量对局，只链接 QtCore；消除引擎和 AI 直接编译游戏目录下的源文件。
+# 构建：qmake aibench.pro && make
+
+QT       = core
+CONFIG  += console c++17
+CONFIG  -= app_bundle
+
+TARGET   = aibench
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    main.cpp \
+    ../gameboard.cpp \
+    ../cascaderesolver.cpp \
+    ../aiplayer.cpp
+
+HEADERS += \
+    ../gameboard.h \
+    ../cascaderesolver.h \
+    ../aiplayer.h
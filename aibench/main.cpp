@@ -0,0 +1,197 @@
+// aibench/main.cpp
+// 无界面的 AI 批量对局：只依赖 QtCore，与游戏共用 gameboard / cascaderesolver / aiplayer。
+// 用于数值平衡、AI 回归和消除引擎的 CPU 性能分析。
+//
+// 例：aibench -n 200 -s 1000 -m 500 -d 1 -j 8 -o result.csv
+#include "../gameboard.h"
+#include "../cascaderesolver.h"
+#include "../aiplayer.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QRandomGenerator>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QThread>
+#include <QFile>
+#include <QTextStream>
+#include <QVector>
+
+struct GameConfig {
+    int maxMoves = 300;        // <= 0 不限
+    int timeLimitMs = 0;       // 每局墙钟时间上限，<= 0 不限
+    int searchDepth = 1;
+};
+
+struct GameResult {
+    int game = 0;
+    quint32 seed = 0;
+    int score = 0;
+    int moves = 0;
+    int cascadeSteps = 0;      // 消除轮数（一次交换的每一轮连消各算一次）
+    int rowBombs = 0, colBombs = 0, areaBombs = 0, colorClears = 0;
+    int reshuffles = 0;
+    qint64 elapsedMs = 0;
+    double movesPerSec = 0;
+};
+
+/* 与 Mode_AI 的流程一致：AI 选步 -> 结算到稳定 -> 死局洗牌；计分同 Mode_AI (每格 10 分) */
+static GameResult runGame(int index, quint32 seed, const GameConfig &cfg)
+{
+    GameResult res;
+    res.game = index;
+    res.seed = seed;
+
+    QRandomGenerator rng(seed);
+    GameBoard board;
+    board.setRandomGenerator(&rng);
+    board.initNoThree();
+
+    CascadeResolver resolver(&board, &rng);
+    AiPlayer ai(cfg.searchDepth);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while ((cfg.maxMoves <= 0 || res.moves < cfg.maxMoves)
+           && (cfg.timeLimitMs <= 0 || timer.elapsed() < cfg.timeLimitMs)) {
+        AiPlayer::Move move = ai.bestMove(board.grid());
+        if (move.score <= 0) {
+            // AI 找不到移动，按死局处理
+            board.initNoThree();
+            ++res.reshuffles;
+            continue;
+        }
+
+        Grid g = board.grid();
+        const QVector<CascadeResolver::Event> events =
+            resolver.resolveSwap(g, move.r1, move.c1, move.r2, move.c2);
+        board.m_grid = g;
+        ++res.moves;
+
+        for (const CascadeResolver::Event &ev : events) {
+            if (ev.type == CascadeResolver::Event::Eliminate) {
+                ++res.cascadeSteps;
+                res.score += ev.points.size() * 10;
+                for (const CascadeResolver::Effect &fx : ev.effects) {
+                    switch (fx.type) {
+                    case CascadeResolver::RowBomb:    ++res.rowBombs; break;
+                    case CascadeResolver::ColBomb:    ++res.colBombs; break;
+                    case CascadeResolver::AreaBomb:   ++res.areaBombs; break;
+                    case CascadeResolver::ColorClear: ++res.colorClears; break;
+                    default: break;
+                    }
+                }
+            } else if (ev.type == CascadeResolver::Event::Settled && ev.dead) {
+                board.initNoThree();
+                ++res.reshuffles;
+            }
+        }
+    }
+
+    res.elapsedMs = timer.elapsed();
+    res.movesPerSec = res.elapsedMs > 0 ? res.moves * 1000.0 / res.elapsedMs : 0;
+    return res;
+}
+
+class GameTask : public QRunnable
+{
+public:
+    GameTask(int index, quint32 seed, const GameConfig &cfg, GameResult *out)
+        : m_index(index), m_seed(seed), m_cfg(cfg), m_out(out) {}
+
+    void run() override { *m_out = runGame(m_index, m_seed, m_cfg); }
+
+private:
+    int m_index;
+    quint32 m_seed;
+    GameConfig m_cfg;
+    GameResult *m_out;         // 每局写自己的槽位，线程之间不共享
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("aibench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless AI-vs-board batch runner");
+    parser.addHelpOption();
+
+    QCommandLineOption gamesOpt({"n", "games"}, "Number of games.", "N", "10");
+    QCommandLineOption seedOpt({"s", "seed"}, "Base seed; game i uses seed + i.", "SEED", "1");
+    QCommandLineOption seedsOpt("seeds", "Comma-separated seed list (overrides -n/-s).", "LIST");
+    QCommandLineOption movesOpt({"m", "max-moves"}, "Move limit per game, 0 = none.", "N", "300");
+    QCommandLineOption timeOpt({"t", "time-limit"}, "Wall-clock seconds per game, 0 = none.", "SEC", "0");
+    QCommandLineOption depthOpt({"d", "depth"}, "AI search depth.", "N", "1");
+    QCommandLineOption jobsOpt({"j", "jobs"}, "Parallel games, default = CPU cores.", "N",
+                               QString::number(QThread::idealThreadCount()));
+    QCommandLineOption outOpt({"o", "output"}, "CSV output file, '-' = stdout.", "FILE", "-");
+    parser.addOptions({gamesOpt, seedOpt, seedsOpt, movesOpt, timeOpt, depthOpt, jobsOpt, outOpt});
+    parser.process(app);
+
+    GameConfig cfg;
+    cfg.maxMoves = parser.value(movesOpt).toInt();
+    cfg.timeLimitMs = parser.value(timeOpt).toInt() * 1000;
+    cfg.searchDepth = qMax(0, parser.value(depthOpt).toInt());
+    if (cfg.maxMoves <= 0 && cfg.timeLimitMs <= 0) {
+        QTextStream(stderr) << "aibench: need --max-moves or --time-limit\n";
+        return 1;
+    }
+
+    QVector<quint32> seeds;
+    if (parser.isSet(seedsOpt)) {
+        for (const QString &s : parser.value(seedsOpt).split(',', Qt::SkipEmptyParts))
+            seeds.append(s.trimmed().toUInt());
+    } else {
+        const int games = parser.value(gamesOpt).toInt();
+        const quint32 base = parser.value(seedOpt).toUInt();
+        for (int i = 0; i < games; ++i) seeds.append(base + i);
+    }
+
+    QFile file;
+    const QString outPath = parser.value(outOpt);
+    bool ok;
+    if (outPath == "-") {
+        ok = file.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    } else {
+        file.setFileName(outPath);
+        ok = file.open(QIODevice::WriteOnly | QIODevice::Text);
+    }
+    if (!ok) {
+        QTextStream(stderr) << "aibench: cannot open " << outPath << "\n";
+        return 1;
+    }
+
+    // 并行跑完再统一按局号输出，CSV 顺序与线程调度无关
+    QVector<GameResult> results(seeds.size());
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(1, parser.value(jobsOpt).toInt()));
+
+    QElapsedTimer total;
+    total.start();
+    for (int i = 0; i < seeds.size(); ++i)
+        pool.start(new GameTask(i, seeds[i], cfg, &results[i]));
+    pool.waitForDone();
+    const qint64 totalMs = total.elapsed();
+
+    QTextStream out(&file);
+    out << "game,seed,score,moves,cascade_steps,row_bombs,col_bombs,area_bombs,color_clears,"
+           "reshuffles,elapsed_ms,moves_per_sec\n";
+    qint64 totalMoves = 0;
+    for (const GameResult &r : results) {
+        out << r.game << ',' << r.seed << ',' << r.score << ',' << r.moves << ','
+            << r.cascadeSteps << ',' << r.rowBombs << ',' << r.colBombs << ','
+            << r.areaBombs << ',' << r.colorClears << ',' << r.reshuffles << ','
+            << r.elapsedMs << ',' << QString::number(r.movesPerSec, 'f', 1) << '\n';
+        totalMoves += r.moves;
+    }
+    out.flush();
+
+    QTextStream(stderr) << "aibench: " << results.size() << " games, " << totalMoves << " moves in "
+                        << totalMs << " ms (" << pool.maxThreadCount() << " threads, "
+                        << QString::number(totalMs > 0 ? totalMoves * 1000.0 / totalMs : 0, 'f', 1)
+                        << " moves/sec overall)\n";
+    return 0;
+}
@@ -0,0 +1,171 @@
+// aiplayer.cpp
+#include "aiplayer.h"
+
+AiPlayer::Move AiPlayer::bestMove(const Grid &grid) const
+{
+    Move bestMove = {-1, -1, -1, -1, -1};
+    Grid rootGrid = grid;
+
+    // 搜索深度见 setSearchDepth：深度太深会导致计算非常慢 (指数级爆炸)
+
+    for (int r = 0; r < ROW; ++r) {
+        for (int c = 0; c < COL; ++c) {
+            int dirs[2][2] = {{0, 1}, {1, 0}};
+            for (int k = 0; k < 2; ++k) {
+                int nr = r + dirs[k][0];
+                int nc = c + dirs[k][1];
+                if (nr >= ROW || nc >= COL) continue;
+
+                // 1. 模拟第一步
+                std::swap(rootGrid[r][c].pic, rootGrid[nr][nc].pic);
+
+                // 2. 计算第一步的直接收益
+                ElimResult res1 = getEliminations(r, c, rootGrid);
+                ElimResult res2 = getEliminations(nr, nc, rootGrid);
+
+                int currentScore = 0;
+
+                if (!res1.points.isEmpty() || !res2.points.isEmpty()) {
+                    // --- 基础分计算 (和之前一样) ---
+                    QSet<QPoint> allElims = res1.points;
+                    allElims.unite(res2.points);
+                    currentScore += allElims.size() * 20;
+
+                    auto checkType = [&](EffectType t) {
+                        if (t == CascadeResolver::ColorClear) return 200000;
+                        if (t == CascadeResolver::AreaBomb)   return 80000;
+                        if (t == CascadeResolver::RowBomb || t == CascadeResolver::ColBomb) return 40000;
+                        return 0;
+                    };
+                    currentScore += checkType(res1.type);
+                    currentScore += checkType(res2.type);
+
+                    int lowerRow = qMax(r, nr);
+                    currentScore += lowerRow * 100; // 重力优先
+
+                    // --- 【差异点】 ---
+                    // 不再只调用一次 evaluatePotential，而是调用 recursiveSearch
+                    // 看看"如果我走了这一步，未来还有没有大分"
+
+                    // 只有当这一步不是绝杀(比如5消)时，才去搜后续，节省时间
+                    if (currentScore < 10000) {
+                        // 去掉被消除的点，模拟剩下的残局
+                        // (注：这里为了简化，不真的执行消除下落，直接在当前图上搜，是一种近似)
+                        int futurePotential = recursiveSearch(rootGrid, m_searchDepth, -999999, 999999);
+                        currentScore += futurePotential;
+                    }
+                }
+
+                if (currentScore > bestMove.score) {
+                    bestMove = {r, c, nr, nc, currentScore};
+                }
+
+                // 3. 回溯
+                std::swap(rootGrid[r][c].pic, rootGrid[nr][nc].pic);
+            }
+        }
+    }
+    return bestMove;
+}
+
+int AiPlayer::evaluatePotential(const Grid& g, const QSet<QPoint>& ignoreCells) const
+{
+    int potentialScore = 0;
+
+    // 遍历全盘（横向和纵向扫描相邻对）
+    for (int r = 0; r < ROW; ++r) {
+        for (int c = 0; c < COL; ++c) {
+            // 如果这个格子已经被消除了，跳过
+            if (ignoreCells.contains(QPoint(r, c))) continue;
+
+            int color = g[r][c].pic;
+            if (color == -1) continue;
+
+            // 检查右边
+            if (c + 1 < COL && !ignoreCells.contains(QPoint(r, c+1))) {
+                if (g[r][c+1].pic == color) potentialScore += 15; // 发现一个横向二连，加分
+            }
+            // 检查下边
+            if (r + 1 < ROW && !ignoreCells.contains(QPoint(r+1, c))) {
+                if (g[r+1][c].pic == color) potentialScore += 15; // 发现一个纵向二连，加分
+            }
+        }
+    }
+    return potentialScore;
+}
+
+
+int AiPlayer::recursiveSearch(Grid g, int depth, int alpha, int beta) const
+{
+    // --- 1. 叶子节点 (Base Case) ---
+    // 如果搜索深度耗尽，或者当前盘面已经死局，停止递归，返回当前盘面的“静态估值”
+    if (depth == 0) {
+        // 这里的估值 = 盘面潜在连击分 (evaluatePotential)
+        // 注意：这里我们不计算消除分，只计算“好坏程度”，因为消除分已经在上一层叠加了
+        return evaluatePotential(g, QSet<QPoint>());
+    }
+
+    int maxVal = -100000; // 初始化为极小值
+
+    // --- 2. 树的展开 (Branching) ---
+    // 遍历所有可能的移动（子节点）
+    for (int r = 0; r < ROW; ++r) {
+        for (int c = 0; c < COL; ++c) {
+
+            // 优化：只向右和向下交换，去重
+            int dirs[2][2] = {{0, 1}, {1, 0}};
+
+            for (int k = 0; k < 2; ++k) {
+                int nr = r + dirs[k][0];
+                int nc = c + dirs[k][1];
+                if (nr >= ROW || nc >= COL) continue;
+
+                // 模拟交换
+                std::swap(g[r][c].pic, g[nr][nc].pic);
+
+                // 获取这一步的直接消除收益
+                ElimResult res = getEliminations(r, c, g); // 注意：getEliminations 需要适配传入 g
+                ElimResult res2 = getEliminations(nr, nc, g);
+
+                int moveScore = 0;
+                // 如果能消除
+                if (!res.points.isEmpty() || !res2.points.isEmpty()) {
+                    QSet<QPoint> allPts = res.points;
+                    allPts.unite(res2.points);
+
+                    // 1. 基础分
+                    moveScore += allPts.size() * 10;
+
+                    // 2. 特效分 (简化计算)
+                    if (res.type != CascadeResolver::Normal && res.type != CascadeResolver::None) moveScore += 500;
+                    if (res2.type != CascadeResolver::Normal && res2.type != CascadeResolver::None) moveScore += 500;
+
+                    // 【关键递归】
+                    // 这一步的价值 = 当前得分 + 下一步能得到的最大分 (递归调用)
+                    // 注意：真实消消乐消除后会掉落，很难模拟。
+                    // 这里我们采用"贪心近似"：假设消除后盘面不变，继续搜下一层。
+                    // 这是一个权衡，为了能在有限时间内算出结果。
+                    int futureVal = recursiveSearch(g, depth - 1, alpha, beta);
+                    int totalVal = moveScore + futureVal;
+
+                    if (totalVal > maxVal) {
+                        maxVal = totalVal;
+                    }
+
+                    // Alpha-Beta 剪枝 (可选，加速搜索)
+                    alpha = qMax(alpha, maxVal);
+                    if (beta <= alpha) {
+                        std::swap(g[r][c].pic, g[nr][nc].pic); // 还原
+                        return maxVal; // 剪枝
+                    }
+                }
+
+                // 还原交换 (Backtracking)
+                std::swap(g[r][c].pic, g[nr][nc].pic);
+            }
+        }
+    }
+
+    // 如果这一层没有任何可行步，返回0
+    return (maxVal == -100000) ? 0 : maxVal;
+}
@@ -0,0 +1,42 @@
+// aiplayer.h
+#ifndef AIPLAYER_H
+#define AIPLAYER_H
+
+#include <QSet>
+#include <QPoint>
+#include "gameboard.h"
+#include "cascaderesolver.h"
+
+/* AI 决策：只读 Grid，不依赖任何控件。Mode_AI 演示和命令行批量对局 (aibench) 共用 */
+class AiPlayer
+{
+public:
+    struct Move {
+        int r1, c1;
+        int r2, c2;
+        int score; // 权重，<= 0 表示没有可走的步
+    };
+
+    explicit AiPlayer(int searchDepth = 1) : m_searchDepth(searchDepth) {}
+
+    // 1 已经配合 evaluatePotential 很强了，设为 2 会显著变慢
+    void setSearchDepth(int depth) { m_searchDepth = depth; }
+    int searchDepth() const { return m_searchDepth; }
+
+    Move bestMove(const Grid &grid) const;
+
+private:
+    using EffectType = CascadeResolver::EffectType;
+    using ElimResult = CascadeResolver::ElimResult;
+    static ElimResult getEliminations(int r, int c, const Grid& g) { return CascadeResolver::eliminationsAt(r, c, g); }
+
+    int evaluatePotential(const Grid& g, const QSet<QPoint>& ignoreCells) const;
+
+    // 递归搜索：返回该分支的最高期望得分
+    // depth: 剩余搜索深度
+    int recursiveSearch(Grid g, int depth, int alpha, int beta) const;
+
+    int m_searchDepth;
+};
+
+#endif // AIPLAYER_H
@@ -0,0 +1,61 @@
+// boardcodec.cpp
+#include "boardcodec.h"
+
+QByteArray BoardCodec::pack(const Grid &g)
+{
+    QByteArray out(PackedSize, '\0');
+    uchar *p = reinterpret_cast<uchar*>(out.data());
+
+    int bit = 0;
+    for (int r = 0; r < ROW; ++r) {
+        for (int c = 0; c < COL; ++c, bit += 3) {
+            const uint v = uint(qBound(-1, g[r][c].pic, COLOR_COUNT - 1) + 1) & 0x7;
+            p[bit >> 3] |= uchar(v << (bit & 7));
+            if ((bit & 7) > 5) p[(bit >> 3) + 1] |= uchar(v >> (8 - (bit & 7)));  // 跨字节
+        }
+    }
+    return out;
+}
+
+bool BoardCodec::unpack(const QByteArray &bytes, Grid &g)
+{
+    if (bytes.size() != PackedSize) return false;
+    const uchar *p = reinterpret_cast<const uchar*>(bytes.constData());
+
+    Grid out = g;
+    int bit = 0;
+    for (int r = 0; r < ROW; ++r) {
+        for (int c = 0; c < COL; ++c, bit += 3) {
+            uint v = p[bit >> 3] >> (bit & 7);
+            if ((bit & 7) > 5) v |= uint(p[(bit >> 3) + 1]) << (8 - (bit & 7));
+            v &= 0x7;
+            if (v > uint(COLOR_COUNT)) return false;
+            out[r][c].pic = int(v) - 1;
+        }
+    }
+    g = out;
+    return true;
+}
+
+QJsonArray BoardCodec::toJson(const Grid &g)
+{
+    QJsonArray array;
+    for (int r = 0; r < ROW; ++r)
+        for (int c = 0; c < COL; ++c)
+            array.append(g[r][c].pic);
+    return array;
+}
+
+bool BoardCodec::fromJson(const QJsonArray &array, Grid &g)
+{
+    if (array.size() != ROW * COL) return false;
+
+    Grid out = g;
+    for (int i = 0; i < ROW * COL; ++i) {
+        const int v = array[i].toInt(-2);
+        if (v < -1 || v >= COLOR_COUNT) return false;
+        out[i / COL][i % COL].pic = v;
+    }
+    g = out;
+    return true;
+}
@@ -0,0 +1,23 @@
+// boardcodec.h
+#ifndef BOARDCODEC_H
+#define BOARDCODEC_H
+
+#include <QByteArray>
+#include <QJsonArray>
+#include "gameboard.h"
+
+/* 棋盘编码：客户端、服务器共用。
+ * 二进制：每格 3 位（存 pic + 1，-1 空 → 0），行优先、低位在前，64 格正好 24 字节；
+ * JSON：64 个整数的数组，协商为 JSON 的连接和界面层用 */
+namespace BoardCodec
+{
+    const int PackedSize = ROW * COL * 3 / 8;
+
+    QByteArray pack(const Grid &g);
+    bool unpack(const QByteArray &bytes, Grid &g);   // 长度或取值不对返回 false，g 不变
+
+    QJsonArray toJson(const Grid &g);
+    bool fromJson(const QJsonArray &array, Grid &g);
+}
+
+#endif // BOARDCODEC_H
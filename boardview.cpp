@@ -0,0 +1,568 @@
+// boardview.cpp
+#include "boardview.h"
+#include "tilesprites.h"
+#include "tweenscheduler.h"
+#include <QPainter>
+#include <QFontMetrics>
+#include <QMouseEvent>
+#include <QShowEvent>
+#include <QWindow>
+
+BoardView::BoardView(QWidget *parent, int gap)
+    : QWidget(parent), m_tweens(new TweenScheduler(this)), m_gap(gap)
+{
+    // 容器的样式表（边框、底色）不往自绘棋盘上层叠
+    setStyleSheet("background: transparent; border: none;");
+
+    // 调度器每推进一帧，整盘只重绘一次
+    connect(m_tweens, &TweenScheduler::frameAdvanced, this, [this]() { update(); });
+    // 跳过动画 / 退出时补间被整体丢弃：方块归位，选中框停在原处，特效直接清掉
+    connect(m_tweens, &TweenScheduler::stopped, this, [this]() {
+        settleTiles();
+        m_overlays.clear();
+        for (MarkerState &st : m_markers) {
+            st.opacity = 1.0;
+            st.dx = 0;
+        }
+        update();
+    });
+}
+
+void BoardView::setGrid(const Grid &g)
+{
+    cancelTileTweens();
+    for (int r = 0; r < ROW; ++r)
+        for (int c = 0; c < COL; ++c) {
+            Tile &t = m_tiles[r * COL + c];
+            t = Tile();
+            t.color = g[r][c].pic;
+        }
+    update();
+}
+
+bool BoardView::isAnimating() const
+{
+    return m_tweens->isBusy();
+}
+
+/* ========================================================= */
+/* 方块动画 */
+/* ========================================================= */
+
+void BoardView::animateTile(int idx, TileChannel channel, qreal from, qreal to, int duration,
+                            QEasingCurve::Type easing, int phase, int delay)
+{
+    Tile *t = &m_tiles[idx];
+    TweenScheduler::Setter setter;
+    switch (channel) {
+    case OffsetX: setter = [t](qreal v) { t->dx = v; }; break;
+    case OffsetY: setter = [t](qreal v) { t->dy = v; }; break;
+    case Scale:   setter = [t](qreal v) { t->scale = v; }; break;
+    case Opacity: setter = [t](qreal v) { t->opacity = v; }; break;
+    }
+    m_tweens->animate(t, channel, from, to, duration, std::move(setter), easing, phase, delay);
+}
+
+void BoardView::cancelTileTweens()
+{
+    for (int i = 0; i < ROW * COL; ++i) m_tweens->cancel(&m_tiles[i]);
+}
+
+void BoardView::settleTiles()
+{
+    for (Tile &t : m_tiles) {
+        if (t.dying) {
+            t = Tile();
+            continue;
+        }
+        t.dx = t.dy = 0;
+        t.scale = t.opacity = 1.0;
+    }
+}
+
+void BoardView::playDropIn(int dropHeight, int rowPeriod, std::function<void()> onFinished)
+{
+    cancelTileTweens();
+    settleTiles();
+
+    const int phase = m_tweens->beginPhase();
+    // dropHeight < 0：从棋盘顶上整盘高度落下
+    const qreal fromDy = -(dropHeight < 0 ? ROW * m_cellSize + 100 : dropHeight) / qreal(pitch());
+
+    // 最底行先落，每隔 rowPeriod 开始下一行（< 0：上一行落完再停 1ms）；没轮到的行透明度为 0
+    int delay = 0;
+    for (int r = ROW - 1; r >= 0; --r) {
+        const int duration = 180 + (ROW - 1 - r) * 15;
+        for (int c = 0; c < COL; ++c) {
+            const int idx = r * COL + c;
+            if (m_tiles[idx].color < 0) continue;
+            animateTile(idx, OffsetY, fromDy, 0, duration, QEasingCurve::OutBounce, phase, delay);
+            animateTile(idx, Opacity, 0.0, 1.0, 300, QEasingCurve::Linear, phase, delay);
+        }
+        delay += rowPeriod < 0 ? duration + 1 : rowPeriod;
+    }
+    update();
+    m_tweens->endPhase(phase, std::move(onFinished));
+}
+
+void BoardView::playSwap(int r1, int c1, int r2, int c2, std::function<void()> onFinished)
+{
+    const int a = r1 * COL + c1;
+    const int b = r2 * COL + c2;
+    m_tweens->cancel(&m_tiles[a]);
+    m_tweens->cancel(&m_tiles[b]);
+    std::swap(m_tiles[a], m_tiles[b]);
+
+    // 换完格位后从原位置滑过去
+    const int phase = m_tweens->beginPhase();
+    if (c1 != c2) {
+        animateTile(a, OffsetX, c2 - c1, 0, 300, QEasingCurve::Linear, phase);
+        animateTile(b, OffsetX, c1 - c2, 0, 300, QEasingCurve::Linear, phase);
+    }
+    if (r1 != r2) {
+        animateTile(a, OffsetY, r2 - r1, 0, 300, QEasingCurve::Linear, phase);
+        animateTile(b, OffsetY, r1 - r2, 0, 300, QEasingCurve::Linear, phase);
+    }
+    update();
+    m_tweens->endPhase(phase, std::move(onFinished));
+}
+
+void BoardView::playRotate(int r, int c, std::function<void()> onFinished)
+{
+    const int tl = r * COL + c, tr = tl + 1;
+    const int bl = tl + COL, br = bl + 1;
+    for (int idx : { tl, tr, bl, br }) m_tweens->cancel(&m_tiles[idx]);
+
+    // 与 GameBoard 的旋转一致：TL ← BL, BL ← BR, BR ← TR, TR ← TL
+    const Tile oldTL = m_tiles[tl];
+    m_tiles[tl] = m_tiles[bl];
+    m_tiles[bl] = m_tiles[br];
+    m_tiles[br] = m_tiles[tr];
+    m_tiles[tr] = oldTL;
+
+    const int phase = m_tweens->beginPhase();
+    const QEasingCurve::Type ease = QEasingCurve::OutQuad;
+    animateTile(tl, OffsetY,  1, 0, 200, ease, phase);   // 从下面上来
+    animateTile(tr, OffsetX, -1, 0, 200, ease, phase);   // 从左边过来
+    animateTile(br, OffsetY, -1, 0, 200, ease, phase);   // 从上面下来
+    animateTile(bl, OffsetX,  1, 0, 200, ease, phase);   // 从右边过来
+    update();
+    m_tweens->endPhase(phase, std::move(onFinished));
+}
+
+void BoardView::playTransform(int r, int c, int color, std::function<void()> onFinished)
+{
+    const int idx = r * COL + c;
+    const int disappear = m_tweens->beginPhase();
+    animateTile(idx, Scale, 1.0, 0.0, 150, QEasingCurve::Linear, disappear);
+
+    m_tweens->endPhase(disappear, [this, idx, color, onFinished]() {
+        m_tiles[idx].color = color;
+        // 加一点弹跳效果，感觉更生动
+        const int appear = m_tweens->beginPhase();
+        animateTile(idx, Scale, 0.0, 1.0, 150, QEasingCurve::OutBack, appear);
+        m_tweens->endPhase(appear, onFinished);
+    });
+}
+
+void BoardView::playEliminate(const QSet<QPoint> &points, std::function<void()> onFinished)
+{
+    for (const QPoint &p : points) m_tiles[p.x() * COL + p.y()].dying = true;
+
+    const int phase = m_tweens->beginPhase();
+    for (const QPoint &p : points) {
+        const int idx = p.x() * COL + p.y();
+        if (m_tiles[idx].color < 0) continue;
+        animateTile(idx, Scale, 1.0, 0.0, 250, QEasingCurve::Linear, phase);
+        animateTile(idx, Opacity, 1.0, 0.0, 250, QEasingCurve::Linear, phase);
+    }
+
+    m_tweens->endPhase(phase, [this, points, onFinished]() {
+        // 只清理仍处于消失状态的格子（中途被 playFall 接管的不动）
+        for (const QPoint &p : points) {
+            Tile &t = m_tiles[p.x() * COL + p.y()];
+            if (t.dying) t = Tile();
+        }
+        update();
+        if (onFinished) onFinished();
+    });
+}
+
+void BoardView::playFall(const Grid &target, std::function<void()> onFinished)
+{
+    // 方块要换格位，先让进行中的动画落定
+    cancelTileTweens();
+
+    const int phase = m_tweens->beginPhase();
+    const qreal spawnDy = -(ROW * m_cellSize + 100) / qreal(pitch());
+
+    Tile next[ROW * COL];
+    for (int c = 0; c < COL; ++c) {
+        // 从下往上收集幸存者
+        int survivorRows[ROW];
+        int survivorCount = 0;
+        for (int r = ROW - 1; r >= 0; --r) {
+            const Tile &t = m_tiles[r * COL + c];
+            if (t.color >= 0 && !t.dying) survivorRows[survivorCount++] = r;
+        }
+
+        int survivorIdx = 0;
+        for (int r = ROW - 1; r >= 0; --r) {
+            Tile &t = next[r * COL + c];
+            const int finalColor = target[r][c].pic;
+            if (finalColor < 0) continue;
+
+            t.color = finalColor;
+            if (survivorIdx < survivorCount) {
+                t.dy = survivorRows[survivorIdx++] - r;
+            } else {
+                t.dy = spawnDy;
+                t.opacity = 0.0;
+            }
+        }
+    }
+
+    for (int i = 0; i < ROW * COL; ++i) {
+        m_tiles[i] = next[i];
+        if (m_tiles[i].color < 0) continue;
+        if (m_tiles[i].dy != 0)
+            animateTile(i, OffsetY, m_tiles[i].dy, 0, 500, QEasingCurve::OutBounce, phase);
+        if (m_tiles[i].opacity < 1.0)
+            animateTile(i, Opacity, m_tiles[i].opacity, 1.0, 500, QEasingCurve::Linear, phase);
+    }
+    update();
+    m_tweens->endPhase(phase, std::move(onFinished));
+}
+
+void BoardView::playShake(int r, int c)
+{
+    Tile *t = &m_tiles[r * COL + c];
+    // 左 4px → 右 4px → 回原位
+    m_tweens->shake(t, OffsetX, 4.0 / pitch(), 120, [t](qreal v) { t->dx = v; });
+}
+
+void BoardView::playPause(int duration, std::function<void()> onFinished)
+{
+    // 空补间占住阶段（目标用调度器自己，不和方块、标记撞通道）：停顿跟着播放速度缩放，
+    // stop() 时连同回调一起作废
+    const int phase = m_tweens->beginPhase();
+    m_tweens->animate(m_tweens, 0, 0, 1, duration, [](qreal) {}, QEasingCurve::Linear, phase);
+    m_tweens->endPhase(phase, std::move(onFinished));
+}
+
+/* ========================================================= */
+/* 标记 */
+/* ========================================================= */
+
+void BoardView::setMarker(int id, const Marker &marker)
+{
+    // 已有同 id 的标记：只换位置和样式，进行中的呼吸、抖动继续
+    auto it = m_markers.find(id);
+    if (it == m_markers.end()) it = m_markers.insert(id, MarkerState());
+    it->marker = marker;
+    update();
+}
+
+void BoardView::removeMarker(int id)
+{
+    m_tweens->cancel(this, id * 2);
+    m_tweens->cancel(this, id * 2 + 1);
+    if (m_markers.remove(id)) update();
+}
+
+void BoardView::pulseMarker(int id, qreal low, int period)
+{
+    if (!m_markers.contains(id)) return;
+    m_tweens->pulse(this, id * 2, 1.0, low, period, [this, id](qreal v) {
+        auto it = m_markers.find(id);
+        if (it != m_markers.end()) it->opacity = v;
+    });
+}
+
+void BoardView::shakeMarker(int id, qreal amplitude, int duration)
+{
+    if (!m_markers.contains(id)) return;
+    m_tweens->shake(this, id * 2 + 1, amplitude, duration, [this, id](qreal v) {
+        auto it = m_markers.find(id);
+        if (it != m_markers.end()) it->dx = v;
+    });
+}
+
+/* ========================================================= */
+/* 特效 */
+/* ========================================================= */
+
+void BoardView::addOverlay(const Overlay &overlay, int duration, std::function<void()> onFinished)
+{
+    const int id = m_nextOverlay++;
+    m_overlays.insert(id, overlay);
+
+    const int phase = m_tweens->beginPhase();
+    m_tweens->animate(&m_overlays, id, 0.0, 1.0, duration, [this, id](qreal v) {
+        auto it = m_overlays.find(id);
+        if (it != m_overlays.end()) it->progress = v;
+    }, QEasingCurve::Linear, phase);
+    m_tweens->endPhase(phase, [this, id, onFinished]() {
+        m_overlays.remove(id);
+        update();
+        if (onFinished) onFinished();
+    });
+    update();
+}
+
+void BoardView::playBeam(Qt::Orientation orientation, int index, const QColor &color)
+{
+    Overlay ov;
+    ov.kind = Overlay::Beam;
+    ov.color = color;
+    ov.orientation = orientation;
+    ov.index = index;
+    addOverlay(ov, 400);
+}
+
+void BoardView::playShockwave(int r, int c, int radius, const QColor &color)
+{
+    Overlay ov;
+    ov.kind = Overlay::Shockwave;
+    ov.color = color;
+    ov.cell = QPoint(r, c);
+    ov.radius = radius;
+    addOverlay(ov, 500);
+}
+
+void BoardView::playFlash(const QColor &color, int duration)
+{
+    Overlay ov;
+    ov.kind = Overlay::Flash;
+    ov.color = color;
+    addOverlay(ov, duration);
+}
+
+void BoardView::showBanner(const Banner &banner, std::function<void()> onFinished)
+{
+    Overlay ov;
+    ov.kind = Overlay::Text;
+    ov.color = banner.color;
+    ov.banner = banner;
+    addOverlay(ov, banner.fadeIn + banner.hold + banner.fadeOut, std::move(onFinished));
+}
+
+/* ========================================================= */
+/* 几何 */
+/* ========================================================= */
+
+void BoardView::recompute()
+{
+    // 放得下的最大格子，向下取到档位；400px 的棋盘正好是 48
+    const int fitW = (width() + m_gap) / COL - m_gap;
+    const int fitH = (height() + m_gap) / ROW - m_gap;
+    const int cellSize = TileSprites::bucketFor(qMin(fitW, fitH));
+    const bool changed = cellSize != m_cellSize;
+    m_cellSize = cellSize;
+    // 档位和 DPR 都没变时是空操作
+    TileSprites::instance().rasterize(m_cellSize, devicePixelRatioF());
+
+    const int totalW = COL * pitch() - m_gap;
+    const int totalH = ROW * pitch() - m_gap;
+    m_origin = QPoint((width() - totalW) / 2, (height() - totalH) / 2);
+
+    if (changed) emit cellSizeChanged(m_cellSize);
+}
+
+QRect BoardView::cellRect(int r, int c) const
+{
+    return QRect(m_origin + QPoint(c * pitch(), r * pitch()), QSize(m_cellSize, m_cellSize));
+}
+
+QRect BoardView::cellsRect(const QRect &cells) const
+{
+    return QRect(m_origin + QPoint(cells.x() * pitch(), cells.y() * pitch()),
+                 QSize(cells.width() * pitch() - m_gap, cells.height() * pitch() - m_gap));
+}
+
+bool BoardView::cellAt(const QPoint &pos, int &r, int &c) const
+{
+    const int x = pos.x() - m_origin.x();
+    const int y = pos.y() - m_origin.y();
+    if (x < 0 || y < 0) return false;
+
+    c = x / pitch();
+    r = y / pitch();
+    if (r >= ROW || c >= COL) return false;
+    // 落在格间缝隙里不算
+    return (x % pitch()) < m_cellSize && (y % pitch()) < m_cellSize;
+}
+
+void BoardView::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+
+    // 窗口拖到另一块屏幕（DPR 可能不同）：顶层窗口的 QWindow 显示后才有，每次显示重连一次
+    disconnect(m_screenChanged);
+    if (QWindow *win = window()->windowHandle()) {
+        m_screenChanged = connect(win, &QWindow::screenChanged, this, [this]() {
+            recompute();
+            update();
+        });
+    }
+}
+
+void BoardView::resizeEvent(QResizeEvent *event)
+{
+    recompute();
+    QWidget::resizeEvent(event);
+}
+
+/* ========================================================= */
+/* 绘制与命中 */
+/* ========================================================= */
+
+void BoardView::mousePressEvent(QMouseEvent *event)
+{
+    int r, c;
+    if (event->button() == Qt::LeftButton && cellAt(event->pos(), r, c)) {
+        emit cellClicked(r, c);
+        return;
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void BoardView::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    p.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    const qreal dpr = devicePixelRatioF();
+    const QPixmap &sheet = TileSprites::instance().atlas(m_cellSize, dpr);
+    const qreal src = qRound(m_cellSize * dpr);
+
+    for (int r = 0; r < ROW; ++r) {
+        for (int c = 0; c < COL; ++c) {
+            const Tile &t = m_tiles[r * COL + c];
+            if (t.color < 0 || t.opacity <= 0 || t.scale <= 0) continue;
+
+            QRectF rect = QRectF(cellRect(r, c)).translated(t.dx * pitch(), t.dy * pitch());
+            if (t.scale != 1.0) {
+                QPointF center = rect.center();
+                rect.setSize(rect.size() * t.scale);
+                rect.moveCenter(center);
+            }
+
+            p.setOpacity(t.opacity);
+            p.drawPixmap(rect, sheet, QRectF(t.color * src, 0, src, src));
+        }
+    }
+
+    p.setRenderHint(QPainter::Antialiasing);
+    for (const MarkerState &st : m_markers) paintMarker(p, st);
+    for (const Overlay &ov : m_overlays) paintOverlay(p, ov);
+}
+
+void BoardView::paintMarker(QPainter &p, const MarkerState &st) const
+{
+    const Marker &m = st.marker;
+    if (st.opacity <= 0) return;
+
+    const QRectF rect = QRectF(cellsRect(m.cells))
+                            .adjusted(-m.margin, -m.margin, m.margin, m.margin)
+                            .translated(st.dx, 0);
+    p.setOpacity(st.opacity);
+
+    if (m.glow) {
+        // 由外向内逐圈加深，近似阴影模糊
+        const int spread = 8;
+        p.setBrush(Qt::NoBrush);
+        for (int i = spread; i >= 1; --i) {
+            QColor c = m.color;
+            c.setAlphaF(c.alphaF() * (1.0 - qreal(i) / (spread + 1)) * 0.5);
+            p.setPen(QPen(c, 2));
+            p.drawRoundedRect(rect.adjusted(-i, -i, i, i), m.radius + i, m.radius + i);
+        }
+    }
+
+    p.setPen(m.width > 0 ? QPen(m.color, m.width) : QPen(Qt::NoPen));
+    p.setBrush(m.fill);
+    const qreal inset = m.width / 2.0;
+    p.drawRoundedRect(rect.adjusted(inset, inset, -inset, -inset), m.radius, m.radius);
+}
+
+void BoardView::paintOverlay(QPainter &p, const Overlay &ov) const
+{
+    const qreal t = ov.progress;
+    QColor clear = ov.color;
+    clear.setAlpha(0);
+    p.setPen(Qt::NoPen);
+
+    switch (ov.kind) {
+    case Overlay::Beam: {
+        // 细线瞬间张开到 50px，同时淡出；横截面中间亮、两边透明
+        const qreal thick = 4 + 46 * TweenScheduler::curve(QEasingCurve::OutExpo).valueForProgress(t);
+        const QRectF board = boardRect();
+        QRectF rect;
+        QLinearGradient grad;
+        if (ov.orientation == Qt::Horizontal) {
+            const qreal y = cellRect(ov.index, 0).center().y();
+            rect = QRectF(board.left(), y - thick / 2, board.width(), thick);
+            grad = QLinearGradient(0, rect.top(), 0, rect.bottom());
+        } else {
+            const qreal x = cellRect(0, ov.index).center().x();
+            rect = QRectF(x - thick / 2, board.top(), thick, board.height());
+            grad = QLinearGradient(rect.left(), 0, rect.right(), 0);
+        }
+        grad.setColorAt(0, clear);
+        grad.setColorAt(0.5, ov.color);
+        grad.setColorAt(1, clear);
+        p.setOpacity(1 - t);
+        p.setBrush(grad);
+        p.drawRect(rect);
+        break;
+    }
+    case Overlay::Shockwave: {
+        const qreal radius = ov.radius * TweenScheduler::curve(QEasingCurve::OutQuad).valueForProgress(t);
+        if (radius <= 0) break;
+        const QPointF center = QRectF(cellRect(ov.cell.x(), ov.cell.y())).center();
+        QRadialGradient grad(center, radius);
+        grad.setColorAt(0, clear);
+        grad.setColorAt(0.7, ov.color);
+        grad.setColorAt(1, clear);
+        p.setOpacity(1.0);
+        p.setBrush(grad);
+        p.drawEllipse(center, radius, radius);
+        break;
+    }
+    case Overlay::Flash:
+        p.setOpacity(1 - t);
+        p.fillRect(rect(), ov.color);
+        break;
+    case Overlay::Text: {
+        // 进度换算回毫秒，按淡入 / 停留 / 淡出三段算透明度
+        const Banner &b = ov.banner;
+        const qreal ms = t * (b.fadeIn + b.hold + b.fadeOut);
+        const QEasingCurve &ease = TweenScheduler::curve(QEasingCurve::InOutQuad);
+        qreal opacity = 1.0;
+        if (ms < b.fadeIn) opacity = ease.valueForProgress(ms / b.fadeIn);
+        else if (ms > b.fadeIn + b.hold && b.fadeOut > 0)
+            opacity = 1 - ease.valueForProgress((ms - b.fadeIn - b.hold) / b.fadeOut);
+        if (opacity <= 0) break;
+
+        QFont font("Microsoft YaHei", b.pointSize, QFont::Bold);
+        const QSize text = QFontMetrics(font).size(Qt::TextSingleLine, b.text);
+        QRectF box(0, 0, b.width > 0 ? b.width : text.width() + 2 * b.padding.width(),
+                   text.height() + 2 * b.padding.height());
+        box.moveCenter(QRectF(rect()).center());
+        if (b.top >= 0) box.moveTop(b.top);
+
+        p.setOpacity(opacity);
+        if (b.boxed) {
+            p.setPen(b.border > 0 ? QPen(b.color, b.border) : QPen(Qt::NoPen));
+            p.setBrush(QColor(0, 0, 0, 180));
+            const qreal inset = b.border / 2.0;
+            p.drawRoundedRect(box.adjusted(inset, inset, -inset, -inset), b.radius, b.radius);
+        }
+        p.setFont(font);
+        p.setPen(b.color);
+        p.drawText(box, Qt::AlignCenter, b.text);
+        break;
+    }
+    }
+}
@@ -0,0 +1,156 @@
+// boardview.h
+#ifndef BOARDVIEW_H
+#define BOARDVIEW_H
+
+#include <QWidget>
+#include <QColor>
+#include <QEasingCurve>
+#include <QMap>
+#include <QSet>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <functional>
+
+#include "gameboard.h"
+
+class TweenScheduler;
+
+/* 自绘棋盘：64 个方块在一次 paintEvent 里从精灵图集贴出，自己做点击命中。
+ * 所有方块动画（掉落、交换、旋转、变身、消除、抖动）、选中框和特效（激光、冲击波、
+ * 闪光、文字横幅）都交给本棋盘的 TweenScheduler 推进，每帧只重绘一次。
+ * 几何只在尺寸变化时重算：格子取放得下的最大档位（见 TileSprites::bucketFor），居中留白 */
+class BoardView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit BoardView(QWidget *parent = nullptr, int gap = 2);
+
+    TweenScheduler *tweens() const { return m_tweens; }
+
+    void setGrid(const Grid &g);                   // 无动画直接显示，丢弃进行中的方块补间
+    int colorAt(int r, int c) const { return m_tiles[r * COL + c].color; }
+
+    // 动画接口：全部方块播完后回调一次（异步）
+    // 开局逐行掉落，最底行先落。dropHeight < 0 = 从整盘高度之上落下；rowPeriod < 0 = 上一行落完才开始
+    void playDropIn(int dropHeight, int rowPeriod, std::function<void()> onFinished = {});
+    void playSwap(int r1, int c1, int r2, int c2,
+                  std::function<void()> onFinished = {});              // 两格互换
+    void playRotate(int r, int c, std::function<void()> onFinished = {}); // (r,c) 为左上角的 2x2 顺时针
+    void playTransform(int r, int c, int color,
+                       std::function<void()> onFinished = {});         // 缩没 → 换色 → 弹出
+    void playEliminate(const QSet<QPoint> &points,
+                       std::function<void()> onFinished = {});         // 缩小 + 淡出，结束后置空
+    void playFall(const Grid &target, std::function<void()> onFinished = {}); // 幸存者下沉 + 顶部补新
+    void playShake(int r, int c);
+    void playPause(int duration, std::function<void()> onFinished);   // 什么都不动，停一会儿再回调
+    bool isAnimating() const;
+
+    // 标记：选中框、提示框等画在方块上面，跟着棋盘几何走。id 由调用方定，同 id 覆盖
+    struct Marker {
+        QRect cells;                               // 覆盖的格子：x = 列, y = 行
+        QColor color;
+        int width = 3;                             // 边框线宽，0 = 不画边框
+        int radius = 10;
+        int margin = 2;                            // 向格子外扩的像素
+        QColor fill = Qt::transparent;
+        bool glow = false;                         // 外发光（代替 QGraphicsDropShadowEffect）
+    };
+    void setMarker(int id, const Marker &marker);
+    void removeMarker(int id);
+    bool hasMarker(int id) const { return m_markers.contains(id); }
+    void pulseMarker(int id, qreal low, int period = 800);  // 透明度 1 → low → 1 循环，直到移除或覆盖
+    void shakeMarker(int id, qreal amplitude, int duration);
+
+    // 特效：画在方块和标记上面，播完自动移除；stop() 时一并丢弃，不回调
+    void playBeam(Qt::Orientation orientation, int index, const QColor &color);  // 整行/整列激光，400ms
+    void playShockwave(int r, int c, int radius, const QColor &color);            // 从格子中心扩散，500ms
+    void playFlash(const QColor &color, int duration);                            // 整块棋盘闪一下后淡出
+
+    // 文字横幅（开局、死局、技能提示）：淡入 → 停留 → 淡出，整段结束后回调
+    struct Banner {
+        QString text;
+        QColor color = Qt::white;
+        int pointSize = 24;
+        bool boxed = false;                        // 半透明黑底 + 同色描边的圆角框
+        int border = 2;
+        int radius = 15;
+        QSize padding = QSize(30, 20);             // 文字到框边的距离
+        int width = 0;                             // 框宽，0 = 随文字
+        int top = -1;                              // 距棋盘控件顶部的像素，< 0 = 垂直居中
+        int fadeIn = 0, hold = 0, fadeOut = 300;   // ms
+    };
+    void showBanner(const Banner &banner, std::function<void()> onFinished = {});
+
+    // 几何
+    int cellSize() const { return m_cellSize; }
+    int gap() const { return m_gap; }
+    int pitch() const { return m_cellSize + m_gap; }
+    QRect cellRect(int r, int c) const;
+    QRect cellsRect(const QRect &cells) const;     // 多格区域（x = 列, y = 行）
+    QRect boardRect() const { return cellsRect(QRect(0, 0, COL, ROW)); }
+    bool cellAt(const QPoint &pos, int &r, int &c) const;
+
+signals:
+    void cellClicked(int r, int c);
+    void cellSizeChanged(int cellSize);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    enum TileChannel { OffsetX, OffsetY, Scale, Opacity };
+
+    struct Tile {
+        int color = -1;
+        qreal dx = 0, dy = 0;      // 相对格位的偏移，单位：格距
+        qreal scale = 1.0;
+        qreal opacity = 1.0;
+        bool dying = false;        // 正在播放消除，下落时不算幸存者
+    };
+
+    struct MarkerState {
+        Marker marker;
+        qreal opacity = 1.0;
+        qreal dx = 0;              // 抖动偏移 (px)
+    };
+
+    // 特效只有一个 0 → 1 的线性进度，缓动和透明度包络在绘制时按进度算
+    struct Overlay {
+        enum Kind { Beam, Shockwave, Flash, Text } kind;
+        QColor color;
+        Qt::Orientation orientation = Qt::Horizontal;
+        int index = 0;             // 激光所在的行/列
+        QPoint cell;               // 冲击波中心格 (x = 行, y = 列)
+        int radius = 0;
+        Banner banner;
+        qreal progress = 0;
+    };
+
+    void animateTile(int idx, TileChannel channel, qreal from, qreal to, int duration,
+                     QEasingCurve::Type easing, int phase, int delay = 0);
+    void cancelTileTweens();
+    void settleTiles();            // 补间被丢弃后把方块归位
+    void recompute();
+    void paintMarker(QPainter &p, const MarkerState &state) const;
+    void addOverlay(const Overlay &overlay, int duration, std::function<void()> onFinished = {});
+    void paintOverlay(QPainter &p, const Overlay &overlay) const;
+
+    TweenScheduler *m_tweens;
+    Tile m_tiles[ROW * COL];
+    QMap<int, MarkerState> m_markers;
+    QMap<int, Overlay> m_overlays;
+    int m_nextOverlay = 0;
+
+    int m_cellSize = 48;
+    int m_gap;
+    QPoint m_origin;               // 首格左上角
+    QMetaObject::Connection m_screenChanged;   // 顶层窗口换屏（DPR 可能不同）
+};
+
+#endif // BOARDVIEW_H
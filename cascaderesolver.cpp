@@ -0,0 +1,190 @@
+// cascaderesolver.cpp
+#include "cascaderesolver.h"
+#include <QRandomGenerator>
+#include <QDebug>
+
+CascadeResolver::CascadeResolver(GameBoard *board, QRandomGenerator *rng)
+    : m_board(board), m_rng(rng)
+{
+}
+
+QVector<CascadeResolver::Event> CascadeResolver::resolveSwap(Grid &g, int r1, int c1, int r2, int c2)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QVector<Event> events;
+
+    std::swap(g[r1][c1].pic, g[r2][c2].pic);
+    Event swap;
+    swap.type = Event::Swap;
+    swap.a = QPoint(r1, c1);
+    swap.b = QPoint(r2, c2);
+    swap.grid = g;
+    events.append(swap);
+
+    resolveInto(g, events);
+    recordTime(timer);
+    return events;
+}
+
+QVector<CascadeResolver::Event> CascadeResolver::resolve(Grid &g)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QVector<Event> events;
+    resolveInto(g, events);
+    recordTime(timer);
+    return events;
+}
+
+QVector<CascadeResolver::Event> CascadeResolver::resolveClear(Grid &g, const QSet<QPoint> &points,
+                                                             const QVector<Effect> &effects)
+{
+    QVector<Event> events;
+    if (points.isEmpty()) return events;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    Event elim;
+    elim.type = Event::Eliminate;
+    elim.points = points;
+    elim.effects = effects;
+    for (const QPoint &p : points) g[p.x()][p.y()].pic = -1;
+    elim.grid = g;
+    events.append(elim);
+
+    collapse(g, events);
+    resolveInto(g, events);
+    recordTime(timer);
+    return events;
+}
+
+void CascadeResolver::recordTime(const QElapsedTimer &timer)
+{
+    m_lastUs = timer.nsecsElapsed() / 1000;
+    m_maxUs = qMax(m_maxUs, m_lastUs);
+}
+
+void CascadeResolver::resolveInto(Grid &g, QVector<Event> &events)
+{
+    int rounds = 0;
+    forever {
+        // 1. 全盘找消除（同一中心的特效只触发一次）
+        Event elim;
+        elim.type = Event::Eliminate;
+        QSet<QPoint> processedCenters;
+
+        for (int r = 0; r < ROW; ++r) {
+            for (int c = 0; c < COL; ++c) {
+                ElimResult res = eliminationsAt(r, c, g);
+                if (res.points.isEmpty()) continue;
+                elim.points.unite(res.points);
+                if (res.type != Normal && res.type != None && !processedCenters.contains(res.center)) {
+                    elim.effects.append({res.type, res.center});
+                    processedCenters.insert(res.center);
+                }
+            }
+        }
+
+        // 保险丝：理论上不会无限连消，防止随机数源异常时卡死
+        if (elim.points.isEmpty() || ++rounds > 200) {
+            if (rounds > 200) qDebug() << "Warning: cascade safety break triggered.";
+            Event settled;
+            settled.type = Event::Settled;
+            settled.grid = g;
+            settled.dead = m_board->isDead(g);
+            events.append(settled);
+            return;
+        }
+
+        // 2. 置空
+        for (const QPoint &p : elim.points) g[p.x()][p.y()].pic = -1;
+        elim.grid = g;
+        events.append(elim);
+
+        // 3. 下落补位
+        collapse(g, events);
+    }
+}
+
+void CascadeResolver::collapse(Grid &g, QVector<Event> &events)
+{
+    // 每列幸存者下沉，顶部补新；补位按列从左到右、每列自下而上取随机数，
+    // 联机对战双方的界面下落也按这个顺序取，同一种子推演结果才一致
+    for (int c = 0; c < COL; ++c) {
+        int write = ROW - 1;
+        for (int r = ROW - 1; r >= 0; --r) {
+            if (g[r][c].pic < 0) continue;
+            g[write--][c].pic = g[r][c].pic;
+        }
+        for (; write >= 0; --write) g[write][c].pic = m_rng->bounded(COLOR_COUNT);
+    }
+
+    Event fall;
+    fall.type = Event::Fall;
+    fall.grid = g;
+    events.append(fall);
+}
+
+CascadeResolver::ElimResult CascadeResolver::eliminationsAt(int r, int c, const Grid &g)
+{
+    ElimResult res;
+    res.center = QPoint(r, c);
+    int color = g[r][c].pic;
+    if (color == -1) return res;
+
+    auto countDir = [&](int row, int col, int dr, int dc) {
+        int cnt = 0;
+        int nr = row + dr, nc = col + dc;
+        while (nr >= 0 && nr < ROW && nc >= 0 && nc < COL && g[nr][nc].pic == color) {
+            cnt++; nr += dr; nc += dc;
+        }
+        return cnt;
+    };
+
+    int up = countDir(r, c, -1, 0);
+    int down = countDir(r, c, 1, 0);
+    int left = countDir(r, c, 0, -1);
+    int right = countDir(r, c, 0, 1);
+
+    // 规则 1: 全屏消除 (魔鸟/闪电)
+    if ((up + down >= 4) || (left + right >= 4)) {
+        res.type = ColorClear;
+        for (int i = 0; i < ROW; ++i) for (int j = 0; j < COL; ++j)
+                if (g[i][j].pic == color) res.points.insert(QPoint(i, j));
+        return res;
+    }
+
+    // 规则 2: 行/列消除
+    if (up + down == 3) {
+        res.type = ColBomb;
+        for (int i = 0; i < ROW; ++i) res.points.insert(QPoint(i, c));
+        return res;
+    }
+    if (left + right == 3) {
+        res.type = RowBomb;
+        for (int j = 0; j < COL; ++j) res.points.insert(QPoint(r, j));
+        return res;
+    }
+
+    // 规则 3: 5x5 炸弹 (T/L型)
+    if (up + down >= 2 && left + right >= 2) {
+        res.type = AreaBomb;
+        for (int i = r - 2; i <= r + 2; ++i) for (int j = c - 2; j <= c + 2; ++j)
+                if (i >= 0 && i < ROW && j >= 0 && j < COL) res.points.insert(QPoint(i, j));
+        return res;
+    }
+
+    // 规则 4: 普通三消
+    if (up + down >= 2) {
+        for (int i = r - up; i <= r + down; ++i) res.points.insert(QPoint(i, c));
+        res.type = Normal;
+    }
+    if (left + right >= 2) {
+        for (int j = c - left; j <= c + right; ++j) res.points.insert(QPoint(r, j));
+        res.type = Normal;
+    }
+
+    return res;
+}
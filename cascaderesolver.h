@@ -0,0 +1,68 @@
+// cascaderesolver.h
+#ifndef CASCADERESOLVER_H
+#define CASCADERESOLVER_H
+
+#include <QSet>
+#include <QPoint>
+#include <QVector>
+#include <QElapsedTimer>
+#include "gameboard.h"
+
+class QRandomGenerator;
+
+/* 连消结算：只改 Grid，不碰任何控件。一次交换立即结算到棋盘稳定，
+ * 过程记录成事件序列，界面按自己的播放速度消费（1x / 2x / 4x / 瞬间）。
+ * 消除规则与 Mode_1 相同：五连全屏、四连行/列、T/L 型 5x5、普通三消 */
+class CascadeResolver
+{
+public:
+    enum EffectType { None, Normal, RowBomb, ColBomb, AreaBomb, ColorClear };
+
+    struct ElimResult {
+        QSet<QPoint> points;
+        EffectType type = None;
+        QPoint center = QPoint(-1, -1);
+    };
+
+    struct Effect {
+        EffectType type;
+        QPoint center;
+    };
+
+    struct Event {
+        enum Type { Swap, Eliminate, Fall, Settled };
+        Type type;
+        QPoint a, b;                    // Swap：交换的两格 (row, col)
+        QSet<QPoint> points;            // Eliminate：本轮消除的格子
+        QVector<Effect> effects;        // Eliminate：本轮触发的特效
+        Grid grid;                      // 事件结束后的棋盘（Fall 的补位颜色从这里取）
+        bool dead = false;              // Settled：稳定后是否死局
+    };
+
+    CascadeResolver(GameBoard *board, QRandomGenerator *rng);
+
+    static ElimResult eliminationsAt(int r, int c, const Grid &g);
+
+    // 交换并结算到稳定，g 就地变为最终棋盘；最后一个事件总是 Settled
+    QVector<Event> resolveSwap(Grid &g, int r1, int c1, int r2, int c2);
+    // 不交换，直接从当前棋盘结算连消
+    QVector<Event> resolve(Grid &g);
+    // 先消掉指定格子（技能），再下落补位并结算连消；points 为空时什么也不做
+    QVector<Event> resolveClear(Grid &g, const QSet<QPoint> &points, const QVector<Effect> &effects = {});
+
+    // 结算耗时（微秒，只算逻辑，不含动画播放）：最近一次 / 历次最长，-1 = 还没结算过
+    qint64 lastResolveUs() const { return m_lastUs; }
+    qint64 maxResolveUs() const { return m_maxUs; }
+
+private:
+    void recordTime(const QElapsedTimer &timer);
+    void resolveInto(Grid &g, QVector<Event> &events);
+    void collapse(Grid &g, QVector<Event> &events);
+
+    GameBoard *m_board;                 // 只用来做死局判定
+    QRandomGenerator *m_rng;            // 补位颜色；传入固定种子即可复现整局
+    qint64 m_lastUs = -1;
+    qint64 m_maxUs = -1;
+};
+
+#endif // CASCADERESOLVER_H
@@ -0,0 +1,90 @@
+// framecodec.cpp
+#include "framecodec.h"
+#include <QIODevice>
+#include <QtEndian>
+
+QByteArray FrameCodec::encode(const QByteArray &payload)
+{
+    QByteArray frame;
+    frame.reserve(HeaderSize + payload.size());
+    frame.resize(HeaderSize);
+    qToBigEndian<quint32>(quint32(payload.size()), reinterpret_cast<uchar*>(frame.data()));
+    frame.append(payload);
+    return frame;
+}
+
+FrameReader::FrameReader(int maxFrameSize)
+    : m_maxFrameSize(maxFrameSize)
+{
+}
+
+qint64 FrameReader::readFrom(QIODevice *device)
+{
+    const qint64 avail = device->bytesAvailable();
+    if (avail <= 0) return 0;
+
+    compact();
+    const int old = m_buf.size();
+    m_buf.resize(old + int(avail));
+    const qint64 got = device->read(m_buf.data() + old, avail);
+    m_buf.resize(old + int(qMax<qint64>(got, 0)));
+    return got;
+}
+
+void FrameReader::append(const QByteArray &data)
+{
+    compact();
+    m_buf.append(data);
+}
+
+bool FrameReader::next(QByteArray &payload)
+{
+    if (m_error || buffered() < FrameCodec::HeaderSize) return false;
+
+    const uchar *head = reinterpret_cast<const uchar*>(m_buf.constData() + m_pos);
+    const quint32 len = qFromBigEndian<quint32>(head);
+    if (len > quint32(m_maxFrameSize)) {
+        m_error = true;
+        return false;
+    }
+    if (buffered() - FrameCodec::HeaderSize < int(len)) return false;
+
+    payload = QByteArray::fromRawData(m_buf.constData() + m_pos + FrameCodec::HeaderSize, int(len));
+    m_pos += FrameCodec::HeaderSize + int(len);
+    return true;
+}
+
+int FrameReader::pendingFrames(int *partialBytes) const
+{
+    // 只读长度头往后跳，不碰负载
+    int frames = 0;
+    int pos = m_pos;
+    const int end = m_buf.size();
+    while (!m_error && end - pos >= FrameCodec::HeaderSize) {
+        const quint32 len = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(m_buf.constData() + pos));
+        if (len > quint32(m_maxFrameSize) || end - pos - FrameCodec::HeaderSize < int(len)) break;
+        pos += FrameCodec::HeaderSize + int(len);
+        ++frames;
+    }
+    if (partialBytes) *partialBytes = end - pos;
+    return frames;
+}
+
+void FrameReader::clear()
+{
+    m_buf.clear();
+    m_pos = 0;
+    m_error = false;
+}
+
+void FrameReader::compact()
+{
+    if (m_pos == 0) return;
+    if (m_pos == m_buf.size()) {
+        m_buf.truncate(0);                // 全部消费完，直接清空
+        m_pos = 0;
+    } else if (m_pos >= m_buf.size() / 2) {
+        m_buf.remove(0, m_pos);
+        m_pos = 0;
+    }
+}
@@ -0,0 +1,49 @@
+// framecodec.h
+#ifndef FRAMECODEC_H
+#define FRAMECODEC_H
+
+#include <QByteArray>
+
+class QIODevice;
+
+/* 客户端与服务器共用的帧格式：4 字节大端长度 + 负载（一条紧凑 JSON 或 CBOR，见 WireCodec）。
+ * 以前靠数 { } 切分消息，字符串里带括号、一条消息被 TCP 拆成两段都会切错。
+ * 不带长度头的旧版对端不再支持：它发来的 "{\"ty" 读成长度远超上限，当作协议错误断开 */
+namespace FrameCodec
+{
+    const int HeaderSize = 4;
+    const int MaxFrameSize = 4 * 1024 * 1024;   // 超过即视为协议错误
+
+    QByteArray encode(const QByteArray &payload);
+}
+
+/* 每条连接一个的接收缓冲区：readyRead 时把字节直接读进缓冲区尾部，
+ * 再按长度头逐帧取出。取出的负载直接指向缓冲区内部，不复制；
+ * 已消费的前缀攒到缓冲区一半以上才整体前移，总开销与字节数成线性 */
+class FrameReader
+{
+public:
+    explicit FrameReader(int maxFrameSize = FrameCodec::MaxFrameSize);
+
+    qint64 readFrom(QIODevice *device);   // 读入设备里现有的全部字节，返回读到的字节数
+    void append(const QByteArray &data);
+
+    // 取下一帧，不够一帧返回 false。payload 只在下次 readFrom/append/clear 前有效
+    bool next(QByteArray &payload);
+
+    bool hasError() const { return m_error; }   // 长度头超过上限，后面的字节已无法对齐
+    int buffered() const { return m_buf.size() - m_pos; }
+    // 缓冲区里已收全、还没被 next 取走的帧数；partialBytes 给出末尾那一帧已收到的字节数（没有半帧为 0）
+    int pendingFrames(int *partialBytes = nullptr) const;
+    void clear();
+
+private:
+    void compact();
+
+    QByteArray m_buf;
+    int m_pos = 0;                        // 下一帧在 m_buf 里的起点
+    int m_maxFrameSize;
+    bool m_error = false;
+};
+
+#endif // FRAMECODEC_H
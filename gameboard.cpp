@@ -29,7 +29,7 @@ void GameBoard::initNoThree()
 /* 只生成无三连，不管死局 */
 void GameBoard::generateNoThreeAlone(Grid &g)
 {
-    auto &rng = *QRandomGenerator::global();
+    auto &rng = m_rng ? *m_rng : *QRandomGenerator::global();
     // 必须重置棋盘数据，防止脏数据干扰
     for(int r=0; r<ROW; ++r)
         for(int c=0; c<COL; ++c)
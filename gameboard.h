@@ -6,8 +6,11 @@
 #include <QVector>
 #include <QPoint>
 
+class QRandomGenerator;
+
 constexpr int ROW = 8;
 constexpr int COL = 8;
+constexpr int COLOR_COUNT = 6;   // 方块颜色数 (pic 取 0..5)
 
 struct Spot {
     int pic = 0;      // 0..5 颜色，-1 空
@@ -25,6 +28,7 @@ public:
     void initNoThree(); // 初始化
     bool trySwap(int r1, int c1, int r2, int c2); // UI 调用的交换判断
     bool isDead(const Grid &g); // 死局判断
+    void setRandomGenerator(QRandomGenerator *rng) { m_rng = rng; } // 固定种子复现棋盘，nullptr = 全局
 
 
     // gameboard.h (添加到 public 区域)
@@ -47,6 +51,7 @@ private:
     };
 
     void generateNoThreeAlone(Grid &g);
+    QRandomGenerator *m_rng = nullptr;
 
     // 内部使用的辅助函数
     bool hasMatchInCross(const Grid &g, int r, int c);
@@ -0,0 +1,191 @@
+// logger.cpp
+#include "logger.h"
+#include <QDateTime>
+#include <QThread>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <chrono>
+
+std::atomic<int> Logger::s_level{int(LogLevel::Info)};
+
+static const char *levelName(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::Trace: return "trace";
+    case LogLevel::Debug: return "debug";
+    case LogLevel::Info:  return "info";
+    case LogLevel::Warn:  return "warn";
+    case LogLevel::Error: return "error";
+    case LogLevel::Off:   break;
+    }
+    return "off";
+}
+
+Logger &Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : m_slots(new Slot[Capacity])
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Logger::Capacity must be a power of two");
+    for (size_t i = 0; i < size_t(Capacity); ++i) m_slots[i].seq.store(i, std::memory_order_relaxed);
+
+    const QByteArray levelEnv = qgetenv("MATCH3_LOG_LEVEL").toLower();
+    for (int l = int(LogLevel::Trace); l <= int(LogLevel::Off); ++l) {
+        if (levelEnv == levelName(LogLevel(l))) setLevel(LogLevel(l));
+    }
+
+    const QByteArray fileEnv = qgetenv("MATCH3_LOG_FILE");
+    if (!fileEnv.isEmpty()) {
+        if (FILE *f = std::fopen(fileEnv.constData(), "a")) m_out = f;
+    }
+
+    m_writer = std::thread([this]() { writerLoop(); });
+}
+
+Logger::~Logger()
+{
+    // 进程退出：写线程把队列里剩下的写完再停
+    m_running.store(false, std::memory_order_release);
+    if (m_writer.joinable()) m_writer.join();
+    if (m_out != stderr) std::fclose(m_out);
+}
+
+void Logger::stamp(Record &rec, LogLevel level, const char *category, const char *format)
+{
+    rec.msecs = QDateTime::currentMSecsSinceEpoch();
+    rec.level = level;
+    rec.category = category;
+    rec.format = format;
+    rec.thread = quintptr(QThread::currentThreadId());
+}
+
+void Logger::push(Record &&rec)
+{
+    // 有界 MPMC 队列（Vyukov）：每个槽的序号表示它当前轮到谁，CAS 抢到位置后独占写入
+    size_t pos = m_head.load(std::memory_order_relaxed);
+    Slot *slot;
+    forever {
+        slot = &m_slots[pos & (Capacity - 1)];
+        const size_t seq = slot->seq.load(std::memory_order_acquire);
+        const intptr_t diff = intptr_t(seq) - intptr_t(pos);
+        if (diff == 0) {
+            if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);   // 满了：丢弃，不等
+            return;
+        } else {
+            pos = m_head.load(std::memory_order_relaxed);
+        }
+    }
+    slot->rec = std::move(rec);
+    slot->seq.store(pos + 1, std::memory_order_release);
+}
+
+bool Logger::pop(Record &rec)
+{
+    Slot &slot = m_slots[m_tail & (Capacity - 1)];
+    if (slot.seq.load(std::memory_order_acquire) != m_tail + 1) return false;
+    rec = std::move(slot.rec);
+    slot.rec = Record();
+    slot.seq.store(m_tail + Capacity, std::memory_order_release);
+    ++m_tail;
+    return true;
+}
+
+void Logger::writerLoop()
+{
+    Record rec;
+    quint64 reportedDrops = 0;
+    forever {
+        const bool running = m_running.load(std::memory_order_acquire);
+
+        bool wrote = false;
+        while (pop(rec)) {
+            writeRecord(rec);
+            wrote = true;
+        }
+
+        const quint64 drops = m_dropped.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            std::fprintf(m_out, "level=warn cat=log msg=\"dropped %llu records (queue full)\"\n",
+                         static_cast<unsigned long long>(drops - reportedDrops));
+            reportedDrops = drops;
+            wrote = true;
+        }
+        if (wrote) std::fflush(m_out);
+
+        if (!running) return;
+        // 空闲时低频轮询：生产者那边不做任何唤醒，入队路径上没有锁和系统调用
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+static QString argText(const QVariant &v)
+{
+    switch (v.userType()) {
+    case QMetaType::QJsonObject:
+        return QString::fromUtf8(QJsonDocument(v.toJsonObject()).toJson(QJsonDocument::Compact));
+    case QMetaType::QJsonArray:
+        return QString::fromUtf8(QJsonDocument(v.toJsonArray()).toJson(QJsonDocument::Compact));
+    default:
+        return v.toString();
+    }
+}
+
+/* 一遍扫完格式串替换 %1..%9：参数文本原样拷进结果，不会再被扫描，
+ * 所以参数里自带的 "%2" 之类不会被后面的参数替换掉。没有对应参数的 %N 原样保留 */
+static QString formatMessage(const char *format, const std::array<QVariant, Logger::MaxArgs> &args, int argc)
+{
+    const QString fmt = QString::fromUtf8(format);
+    QString msg;
+    msg.reserve(fmt.size() + 32);
+    for (int i = 0; i < fmt.size(); ++i) {
+        const QChar ch = fmt.at(i);
+        if (ch == QLatin1Char('%') && i + 1 < fmt.size()) {
+            const int n = fmt.at(i + 1).digitValue();
+            if (n >= 1 && n <= argc) {
+                msg += argText(args[size_t(n - 1)]);
+                ++i;
+                continue;
+            }
+        }
+        msg += ch;
+    }
+    return msg;
+}
+
+/* logfmt 一条记录一行：引号、反斜杠和换行都转义 */
+static QString escapeValue(const QString &text)
+{
+    QString out;
+    out.reserve(text.size());
+    for (const QChar ch : text) {
+        switch (ch.unicode()) {
+        case '"':  out += QLatin1String("\\\""); break;
+        case '\\': out += QLatin1String("\\\\"); break;
+        case '\n': out += QLatin1String("\\n"); break;
+        case '\r': out += QLatin1String("\\r"); break;
+        default:   out += ch; break;
+        }
+    }
+    return out;
+}
+
+void Logger::writeRecord(const Record &rec)
+{
+    const QString msg = escapeValue(formatMessage(rec.format, rec.args, rec.argc));
+
+    // 消息放最后单独拼接，不走 arg()，里面的 % 不会被再解释
+    const QByteArray line = (QString("ts=%1 level=%2 cat=%3 tid=%4 msg=\"")
+                                 .arg(QDateTime::fromMSecsSinceEpoch(rec.msecs).toString(Qt::ISODateWithMs),
+                                      QLatin1String(levelName(rec.level)),
+                                      QLatin1String(rec.category),
+                                      QString::number(rec.thread, 16))
+                             + msg + QLatin1String("\"\n")).toUtf8();
+    std::fwrite(line.constData(), 1, size_t(line.size()), m_out);
+}
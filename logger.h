@@ -0,0 +1,121 @@
+// logger.h
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QVariant>
+#include <QString>
+#include <atomic>
+#include <array>
+#include <initializer_list>
+#include <memory>
+#include <thread>
+#include <cstdio>
+
+/* 异步结构化日志：客户端、服务器共用。
+ * 一条记录 = 时间、级别、分类、线程、格式串 (%1 %2 ...) 和最多 4 个参数（按值存成 QVariant）。
+ * 调用线程只做级别判断和把记录放进无锁环形队列，格式化和写出都在后台写线程里做；
+ * 队列满了直接丢弃并计数，事件循环永远不会卡在 I/O 上。
+ *
+ * 两级过滤：
+ *   编译期 MATCH3_LOG_MIN_LEVEL（默认 Release 为 Info，Debug 为 Trace），低于它的 LOG_xxx 整句编译掉；
+ *   运行期 Logger::setLevel / 环境变量 MATCH3_LOG_LEVEL=trace|debug|info|warn|error|off（默认 info）。
+ * 关掉的级别只花一次原子读，参数表达式不会求值。
+ * 输出默认 stderr，环境变量 MATCH3_LOG_FILE 可改成追加写文件。
+ *
+ * 用法：LOG_DEBUG("net", "发送 %1，%2 字节", type, data.size()); */
+enum class LogLevel { Trace, Debug, Info, Warn, Error, Off };
+
+#ifndef MATCH3_LOG_MIN_LEVEL
+#  ifdef QT_NO_DEBUG
+#    define MATCH3_LOG_MIN_LEVEL 2
+#  else
+#    define MATCH3_LOG_MIN_LEVEL 0
+#  endif
+#endif
+
+#define MATCH3_LOG(level, category, ...) \
+    do { \
+        if (int(level) >= MATCH3_LOG_MIN_LEVEL && Logger::isEnabled(level)) \
+            Logger::instance().log(level, category, __VA_ARGS__); \
+    } while (0)
+
+#define LOG_TRACE(category, ...) MATCH3_LOG(LogLevel::Trace, category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) MATCH3_LOG(LogLevel::Debug, category, __VA_ARGS__)
+#define LOG_INFO(category, ...)  MATCH3_LOG(LogLevel::Info,  category, __VA_ARGS__)
+#define LOG_WARN(category, ...)  MATCH3_LOG(LogLevel::Warn,  category, __VA_ARGS__)
+#define LOG_ERROR(category, ...) MATCH3_LOG(LogLevel::Error, category, __VA_ARGS__)
+
+class Logger
+{
+public:
+    static const int MaxArgs = 4;
+    static const int Capacity = 8192;      // 环形队列槽数，必须是 2 的幂
+
+    struct Record {
+        qint64 msecs = 0;                  // 墙钟时间，入队时取
+        LogLevel level = LogLevel::Info;
+        const char *category = nullptr;    // 只接受字符串字面量，不拷贝
+        const char *format = nullptr;      // 同上
+        quintptr thread = 0;
+        int argc = 0;
+        std::array<QVariant, MaxArgs> args;
+    };
+
+    static Logger &instance();
+
+    static bool isEnabled(LogLevel level)
+    {
+        return int(level) >= s_level.load(std::memory_order_relaxed);
+    }
+    static void setLevel(LogLevel level) { s_level.store(int(level), std::memory_order_relaxed); }
+    static LogLevel level() { return LogLevel(s_level.load(std::memory_order_relaxed)); }
+
+    template <typename... Args>
+    void log(LogLevel level, const char *category, const char *format, const Args &...args)
+    {
+        static_assert(sizeof...(Args) <= MaxArgs, "Logger: too many arguments");
+        Record rec;
+        stamp(rec, level, category, format);
+        rec.argc = int(sizeof...(Args));
+        int i = 0;
+        (void)std::initializer_list<int>{ (rec.args[i++] = toVariant(args), 0)... };
+        (void)i;
+        push(std::move(rec));
+    }
+
+    quint64 dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    Logger();
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    struct Slot {
+        std::atomic<size_t> seq;
+        Record rec;
+    };
+
+    template <typename T>
+    static QVariant toVariant(const T &value) { return QVariant::fromValue(value); }
+    static QVariant toVariant(const char *text) { return QString::fromUtf8(text); }
+
+    static void stamp(Record &rec, LogLevel level, const char *category, const char *format);
+    void push(Record &&rec);               // 多生产者，满了返回前计入 m_dropped
+    bool pop(Record &rec);                 // 只有写线程调用
+    void writerLoop();
+    void writeRecord(const Record &rec);
+
+    static std::atomic<int> s_level;
+
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<size_t> m_head{0};   // 生产者争用
+    alignas(64) size_t m_tail = 0;               // 写线程独占
+    std::atomic<quint64> m_dropped{0};
+    std::atomic<bool> m_running{true};
+
+    FILE *m_out = stderr;
+    std::thread m_writer;
+};
+
+#endif // LOGGER_H
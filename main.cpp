@@ -1,10 +1,13 @@
 #include "mainwindow.h"
+#include "tilesprites.h"
 
 #include <QApplication>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    // 方块图片只在启动时解码一次，各模式共享
+    TileSprites::instance().preload(48, a.devicePixelRatio());
     MainWindow w;
     w.show();
     return a.exec();
@@ -6,6 +6,7 @@
 #include "mode_1.h"
 #include "mode_3.h"
 #include "rankmanager.h"
+#include "logger.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -523,7 +524,7 @@ void MainWindow::onNetworkError(const QString &error)
 // 新增：处理服务器消息
 void MainWindow::onServerMessage(const QString &type, const QJsonObject &data)
 {
-    qDebug() << "收到服务器消息:" << type << data;
+    LOG_TRACE("net", "收到服务器消息 %1 %2", type, data);
 }
 
 // 实现AI演示模式槽函数
@@ -0,0 +1,28 @@
+// matchsync.cpp
+#include "matchsync.h"
+
+static const quint32 kFnvOffset = 2166136261u;
+static const quint32 kFnvPrime = 16777619u;
+
+quint32 MatchSync::playerSeed(quint32 matchSeed, const QString &username)
+{
+    // 不用 qHash：它的实现和种子随平台 / 进程变化，两端算出来不一定一样
+    quint32 h = kFnvOffset ^ matchSeed;
+    const QByteArray name = username.toUtf8();
+    for (char ch : name) {
+        h ^= quint8(ch);
+        h *= kFnvPrime;
+    }
+    return h;
+}
+
+quint32 MatchSync::gridHash(const Grid &g)
+{
+    quint32 h = kFnvOffset;
+    for (int r = 0; r < ROW; ++r)
+        for (int c = 0; c < COL; ++c) {
+            h ^= quint8(g[r][c].pic + 1);   // -1 (空) 映射到 0
+            h *= kFnvPrime;
+        }
+    return h;
+}
@@ -0,0 +1,19 @@
+// matchsync.h
+#ifndef MATCHSYNC_H
+#define MATCHSYNC_H
+
+#include <QString>
+#include "gameboard.h"
+
+/* 联机确定性同步的公共约定：服务器在匹配成功时下发一个局种子，
+ * 双方按用户名派生各自的随机数流（开局棋盘、补位、技能随机都只用这条流），
+ * 于是只需要传操作，对方客户端用同一套结算引擎就能推演出同样的棋盘 */
+namespace MatchSync
+{
+    const int HashInterval = 5;          // 每隔几个操作附带一次棋盘哈希做校验
+
+    quint32 playerSeed(quint32 matchSeed, const QString &username);
+    quint32 gridHash(const Grid &g);     // 与平台、Qt 版本无关的 FNV-1a
+}
+
+#endif // MATCHSYNC_H
@@ -13,6 +13,7 @@
 #include "online_menu.h"
 #include "online_game.h"
 #include "musicsetting.h"
+#include "logger.h"
 
 Menu::Menu(QWidget *parent)
     : QWidget(parent)
@@ -63,6 +64,57 @@ void Menu::setupNetworkConnections()
             this, &Menu::onChatMessageReceived);
     connect(m_networkManager, &NetworkManager::gameMoveReceived,
             this, &Menu::onGameMoveReceived);
+
+    // 大厅里掉线同样会自动重连，要让玩家看得到
+    connect(m_networkManager, &NetworkManager::connectionLost,
+            this, &Menu::onConnectionLost);
+    connect(m_networkManager, &NetworkManager::reconnecting,
+            this, &Menu::onReconnecting);
+    connect(m_networkManager, &NetworkManager::sessionResumed,
+            this, [this](bool success) { onSessionResumed(success); });
+}
+
+void Menu::showLinkBanner(const QString &text, const QColor &color, bool sticky)
+{
+    if (!m_linkBanner) {
+        m_linkBanner = new QLabel(this);
+        m_linkBanner->setAlignment(Qt::AlignCenter);
+        m_linkBanner->setAttribute(Qt::WA_TransparentForMouseEvents);
+        m_linkBannerTimer = new QTimer(this);
+        m_linkBannerTimer->setSingleShot(true);
+        connect(m_linkBannerTimer, &QTimer::timeout, m_linkBanner, &QLabel::hide);
+    }
+
+    m_linkBanner->setStyleSheet(QString("background-color: rgba(0, 0, 0, 180);"
+                                        "color: %1;"
+                                        "font: bold 12pt 'Microsoft YaHei';"
+                                        "border-radius: 8px;"
+                                        "padding: 6px 16px;").arg(color.name()));
+    m_linkBanner->setText(text);
+    m_linkBanner->adjustSize();
+    m_linkBanner->move((width() - m_linkBanner->width()) / 2, 12);
+    m_linkBanner->show();
+    m_linkBanner->raise();
+
+    if (sticky) m_linkBannerTimer->stop();
+    else m_linkBannerTimer->start(3000);
+}
+
+void Menu::onConnectionLost(int graceSecs)
+{
+    showLinkBanner(QString("连接中断，%1 秒内自动重连...").arg(graceSecs), QColor("#FF9800"), true);
+}
+
+void Menu::onReconnecting(int secsLeft)
+{
+    showLinkBanner(QString("正在重连服务器...（剩余 %1 秒）").arg(qMax(0, secsLeft)), QColor("#FF9800"), true);
+}
+
+void Menu::onSessionResumed(bool success)
+{
+    // 重连放弃：横幅保留几秒，需要重新登录
+    if (success) showLinkBanner("已重新连接", QColor("#4CAF50"), false);
+    else showLinkBanner("与服务器的连接已断开，请重新登录", QColor("#FF5555"), false);
 }
 
 QString Menu::getMyUsername() const
@@ -506,9 +558,9 @@ void Menu::onChatMessageReceived(const QString &from, const QString &message, co
     // 可以显示聊天消息
 }
 
-void Menu::onGameMoveReceived(const QJsonObject &moveData)
+void Menu::onGameMoveReceived(const Protocol::GameMove &move)
 {
-    qDebug() << "收到游戏操作:" << moveData;
+    LOG_TRACE("game", "收到游戏操作 %1 op=%2 seq=%3", move.player, move.op, move.seq);
     // 如果正在联机游戏中，转发给游戏窗口
     if (m_onlineGame) {
         // 这里需要OnlineGame有处理游戏操作的方法
@@ -16,6 +16,8 @@ class MainWindow;
 class OnlineMenu;
 class OnlineGame;
 class MusicSetting;
+class QLabel;
+class QTimer;
 
 namespace Ui {
 class Menu;
@@ -48,7 +50,10 @@ private slots:
     void onSystemMessage(const QString &message);
     void onServerShutdown(const QString &message);
     void onChatMessageReceived(const QString &from, const QString &message, const QString &timestamp);
-    void onGameMoveReceived(const QJsonObject &moveData);
+    void onGameMoveReceived(const Protocol::GameMove &move);
+    void onConnectionLost(int graceSecs);
+    void onReconnecting(int secsLeft);
+    void onSessionResumed(bool success);
 
     // 联机对战相关槽函数
     void onMatchRequested(const QString &gameMode);
@@ -80,8 +85,13 @@ private:
     // 当前登录用户名
     QString m_currentUsername;
 
+    // 连接状态横幅：断线重连期间常驻，恢复或放弃后停留片刻再隐藏
+    QLabel *m_linkBanner = nullptr;
+    QTimer *m_linkBannerTimer = nullptr;
+
     // 辅助函数
     void setupNetworkConnections();
+    void showLinkBanner(const QString &text, const QColor &color, bool sticky);
     QString getMyUsername() const;
 };
 
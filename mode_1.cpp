@@ -1,14 +1,13 @@
 #include "mode_1.h"
 #include "ui_mode_1.h"
+#include "boardview.h"
+#include "tweenscheduler.h"
+#include "perfmonitor.h"
 #include "gameboard.h"
 #include "networkmanager.h"
 #include <QGridLayout>
 #include <QPushButton>
 #include <QDir>
-#include <QSequentialAnimationGroup>
-#include <QParallelAnimationGroup>
-#include <QPropertyAnimation>
-#include <QGraphicsOpacityEffect>
 #include <QRandomGenerator>
 #include <QLabel>
 #include <QDebug>
@@ -18,7 +17,8 @@
 
 // 1. 修改构造函数，接收 username
 Mode_1::Mode_1(GameBoard *board, QString username, QWidget *parent)
-    : QWidget(parent), ui(new Ui::Mode_1), m_board(board), m_username(username)
+    : QWidget(parent), ui(new Ui::Mode_1), m_board(board),
+      m_resolver(board, QRandomGenerator::global()), m_username(username)
 {
     ui->setupUi(this);
 
@@ -46,10 +46,18 @@ Mode_1::Mode_1(GameBoard *board, QString username, QWidget *parent)
     ui->labelScore_2->setText(QString("分数 %1").arg(m_score));
     ui->labelCountdown->setText("03:00");
 
-    m_dropGroup = new QSequentialAnimationGroup(this);
-    m_gridLayout = new QGridLayout(ui->boardWidget);
-    m_gridLayout->setSpacing(2);
-    m_gridLayout->setContentsMargins(4, 4, 4, 4);
+    // 自绘棋盘铺满 boardWidget：一次 paintEvent 画完 64 格，点击由它自己命中
+    m_view = new BoardView(ui->boardWidget);
+    auto *boardLayout = new QVBoxLayout(ui->boardWidget);
+    boardLayout->setContentsMargins(0, 0, 0, 0);
+    boardLayout->addWidget(m_view);
+    m_tweens = m_view->tweens();
+    connect(m_view, &BoardView::cellClicked, this, &Mode_1::handleCellClick);
+
+    // 性能面板（F3 显示，F4 记录 CSV）
+    m_perf = new PerfMonitor(this, "mode1");
+    m_perf->watch(m_tweens);
+    m_perf->watch(&m_resolver);
 
     connect(m_board, &GameBoard::gridUpdated, this, &Mode_1::rebuildGrid);
 
@@ -94,107 +102,16 @@ Mode_1::~Mode_1()
 void Mode_1::rebuildGrid()
 {
     clearGridLayout();
-    m_cells.resize(ROW * COL);
-    const Grid &gr = m_board->grid();
-
-    /* ===== 取 boardWidget 内部可用区域 ===== */
-    QRect cr      = ui->boardWidget->contentsRect();   // 去掉边框、padding
-    int availW    = cr.width();
-    int availH    = cr.height();
-    int cellSize  = 48;
-    int gap       = 2;
-    int totalW    = COL * (cellSize + gap) - gap;
-    int totalH    = ROW * (cellSize + gap) - gap;
-
-    /* 居中留白 */
-    int ox = cr.left() + (availW - totalW) / 2;   // 首格 X
-    int oy = cr.top()  + (availH - totalH) / 2;   // 首格 Y
-    /* ========================================= */
-
-    /* 创建按钮：父对象 = boardWidget，先手动定位，不落布局 */
-    for (int r = 0; r < ROW; ++r)
-        for (int c = 0; c < COL; ++c) {
-            QPushButton *btn = new QPushButton(ui->boardWidget);
-            btn->setFixedSize(cellSize, cellSize);
-            btn->setStyleSheet("border:none;");
-            QString path = QString("%1%2.png").arg(QDir::currentPath() + "/").arg(gr[r][c].pic);
-            btn->setIcon(QIcon(path));
-            btn->setIconSize(QSize(cellSize, cellSize));
-
-            int targetX = ox + c * (cellSize + gap);
-            int targetY = oy + r * (cellSize + gap);
-
-            /* 初始：头顶外 */
-            btn->move(targetX, targetY - (ROW - r) * (cellSize + gap));
-            auto *eff = new QGraphicsOpacityEffect(btn);
-            eff->setOpacity(0.0);
-            btn->setGraphicsEffect(eff);
-            btn->show();
-            m_cells[r * COL + c] = btn;
-            connect(btn, &QPushButton::clicked, this, [this, r, c]() {
-                handleCellClick(r, c);
-            });
-        }
-
-    /* 启动掉落动画：把原点传进去，动画里继续用 */
-    createDropAnimation(ox, oy);
+    m_view->setGrid(m_board->grid());
+    createDropAnimation();
 }
 
 /* mode_1.cpp - 修复后的 createDropAnimation */
 /* 2. 修改 createDropAnimation 处理开局逻辑 */
-void Mode_1::createDropAnimation(int left0, int top0)
+void Mode_1::createDropAnimation()
 {
-    if (m_dropGroup->state() == QAbstractAnimation::Running) {
-        m_dropGroup->stop();
-    }
-    m_dropGroup->clear();
-    m_dropGroup->disconnect(this);
-
-    int cellSize = 48;
-    int gap      = 2;
-
-    for (int r = ROW - 1; r >= 0; --r) {
-        auto *rowPar = new QParallelAnimationGroup(this);
-        for (int c = 0; c < COL; ++c) {
-            QPushButton *btn = m_cells[r * COL + c];
-            if (!btn) continue;
-
-            auto *eff = qobject_cast<QGraphicsOpacityEffect*>(btn->graphicsEffect());
-            if (!eff) {
-                eff = new QGraphicsOpacityEffect(btn);
-                btn->setGraphicsEffect(eff);
-            }
-
-            int targetX = left0 + c * (cellSize + gap);
-            int targetY = top0  + r * (cellSize + gap);
-
-            auto *drop = new QPropertyAnimation(btn, "pos");
-            drop->setDuration(180 + (ROW - 1 - r) * 15);
-            drop->setStartValue(QPoint(targetX, targetY - 200));
-            drop->setEndValue(QPoint(targetX, targetY));
-            drop->setEasingCurve(QEasingCurve::OutBounce);
-
-            auto *fade = new QPropertyAnimation(eff, "opacity");
-            fade->setDuration(300);
-            fade->setStartValue(0.0);
-            fade->setEndValue(1.0);
-
-            auto *cellAnim = new QParallelAnimationGroup(this);
-            cellAnim->addAnimation(drop);
-            cellAnim->addAnimation(fade);
-            rowPar->addAnimation(cellAnim);
-        }
-        m_dropGroup->addAnimation(rowPar);
-        m_dropGroup->addPause(1);
-    }
-
-    connect(m_dropGroup, &QSequentialAnimationGroup::finished, this, [this]() {
-        for (int r = 0; r < ROW; ++r) {
-            for (int c = 0; c < COL; ++c) {
-                QPushButton *btn = m_cells[r * COL + c];
-                if (btn) m_gridLayout->addWidget(btn, r, c);
-            }
-        }
+    // 最底行先落，每行 300ms 再停 1ms 下一行才开始；整盘全部落完后回调
+    m_view->playDropIn(200, 300 + 1, [this]() {
         m_isLocked = false;
 
         // 【新增逻辑】如果是第一次初始化完成，播放 Start 动画并开始计时
@@ -204,8 +121,6 @@ void Mode_1::createDropAnimation(int left0, int top0)
         }
         // 注意：如果是 handleDeadlock 触发的重建，不会重置 m_hasGameStarted，也就不会重置倒计时
     });
-
-    m_dropGroup->start();
 }
 
 
@@ -218,41 +133,17 @@ void Mode_1::startGameSequence()
     // 【新增】播放游戏过程背景音乐
     MusicManager::instance().playSceneMusic(MusicManager::MusicScene::Playing);
 
-    QLabel *lbl = new QLabel(ui->boardWidget);
-    lbl->setText("Ready Go!");
-    lbl->setAlignment(Qt::AlignCenter);
-    lbl->setStyleSheet(
-        "color: #ffeb3b;"
-        "font: bold 40pt 'Microsoft YaHei';"
-        "background: transparent;"
-        );
-    lbl->adjustSize();
-    QRect cr = ui->boardWidget->rect();
-    lbl->move((cr.width() - lbl->width()) / 2, (cr.height() - lbl->height()) / 2);
-    lbl->show();
-    lbl->setAttribute(Qt::WA_TransparentForMouseEvents);
-
-    QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(lbl);
-    lbl->setGraphicsEffect(eff);
-
-    // 停留一下然后淡出
-    QSequentialAnimationGroup *seq = new QSequentialAnimationGroup(this);
-    seq->addPause(500); // 停 0.5秒
-
-    QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-    fade->setDuration(1000);
-    fade->setStartValue(1.0);
-    fade->setEndValue(0.0);
-
-    seq->addAnimation(fade);
-
-    connect(seq, &QAbstractAnimation::finished, this, [this, lbl](){
-        lbl->deleteLater();
+    // 停留 0.5 秒然后淡出，画在棋盘上
+    BoardView::Banner banner;
+    banner.text = "Ready Go!";
+    banner.color = QColor("#ffeb3b");
+    banner.pointSize = 40;
+    banner.hold = 500;
+    banner.fadeOut = 1000;
+    m_view->showBanner(banner, [this](){
         m_isLocked = false;
         m_gameTimer->start(); // 【关键】开始倒计时
     });
-
-    seq->start(QAbstractAnimation::DeleteWhenStopped);
 }
 
 /* 4. 新增：定时器逻辑 */
@@ -298,32 +189,16 @@ void Mode_1::clearGridLayout()
         m_skillEffectTimer->stop();
     }
 
-    // 1. 如果有掉落动画正在进行，必须停止，否则动画会访问野指针
-    if (m_dropGroup) {
-        m_dropGroup->stop();
-        m_dropGroup->clear();
-    }
+    // 1. 停掉棋盘上所有补间，丢弃尚未触发的阶段回调
+    m_tweens->stop();
 
-    // 2. 优先通过 m_cells 清理按钮
-    // QWidget 析构时会自动把自己从父布局（m_gridLayout）中移除
-    for (QPushButton *b : m_cells) {
-        if (b) {
-            delete b;
-        }
-    }
-    m_cells.clear(); // 清空列表
-
-    // 3. 清理布局中剩余的非 Widget 项目（如弹簧、空占位符等）
-    if (m_gridLayout && ui->boardWidget) {
-        QLayoutItem *item;
-        while ((item = m_gridLayout->takeAt(0)) != nullptr) {
-            // 如果布局里还有没被 m_cells 记录的控件，也一并删掉
-            if (item->widget()) {
-                delete item->widget();
-            }
-            delete item;
-        }
-    }
+    // 2. 选中框和提示框跟着旧棋盘一起撤掉
+    stopHint();
+    m_view->removeMarker(SelectMarker);
+    m_clickCount = 0;
+
+    // 3. 还没播完的事件作废，棋盘数据已经是结算后的状态
+    m_events.clear();
 }
 
 
@@ -338,517 +213,194 @@ void Mode_1::handleCellClick(int r, int c)
     if (m_isLocked || m_isPaused) return;
     if (m_isLocked) return; // 【关键】如果是锁定状态，直接无视点击，但不改变样式
 
-    QPushButton *btn = m_cells[r * COL + c];
-
     if (m_clickCount == 0) {
         /* 第一次点击：仅高亮 */
         m_selR = r; m_selC = c;
-        setSelected(btn, true);
+        setSelected(r, c, true);
         m_clickCount = 1;
         return;
     }
 
     /* 第二次点击 */
-    QPushButton *firstBtn = m_cells[m_selR * COL + m_selC];
-
     if (qAbs(m_selR - r) + qAbs(m_selC - c) != 1) {
         /* 不相邻 → 直接重选，不抖动 */
-        setSelected(firstBtn, false);
         m_selR = r; m_selC = c;
-        setSelected(btn, true);
+        setSelected(r, c, true);
         return;
     }
 
-    /* 相邻 → 尝试交换 */
+    /* 相邻 → 尝试交换；上一步还没播完就先快进到结算后的棋盘 */
+    skipToEnd();
     bool ok = m_board->trySwap(m_selR, m_selC, r, c);
-    setSelected(firstBtn, false);   // 高亮无论成功失败都消失
+    setSelected(m_selR, m_selC, false);   // 高亮无论成功失败都消失
     m_clickCount = 0;
 
     if (!ok) {
         /* 不可交换 → 两个一起抖动 */
-        playShake(firstBtn);
-        playShake(btn);
+        m_view->playShake(m_selR, m_selC);
+        m_view->playShake(r, c);
     }else {
         // 【新增】在产生不可逆变化前，保存当前状态到栈中
         saveState();
-        // 2. 可交换：进入消除流程
-        // 先在逻辑层真正交换数据
-        std::swap(m_board->m_grid[m_selR][m_selC].pic, m_board->m_grid[r][c].pic);
-
-        // 执行消除处理
+        // 2. 可交换：交换和连消由结算器一次算完，再按事件播放
         processInteraction(m_selR, m_selC, r, c);
     }
 
 }
 
-void Mode_1::setSelected(QPushButton *btn, bool on)
+void Mode_1::setSelected(int r, int c, bool on)
 {
     if (on) {
-        auto *shadow = new QGraphicsDropShadowEffect(btn);
-        shadow->setColor(QColor("#ff9de0"));
-        shadow->setBlurRadius(12);
-        shadow->setOffset(0, 0);   // 纯外环，不偏移
-        btn->setGraphicsEffect(shadow);
+        BoardView::Marker m;
+        m.cells = QRect(c, r, 1, 1);
+        m.color = QColor("#ff9de0");
+        m.width = 0;       // 纯外环发光，不画边框
+        m.margin = 0;
+        m.glow = true;
+        m_view->setMarker(SelectMarker, m);
     } else {
-        btn->setGraphicsEffect(nullptr); // 去掉发光
+        m_view->removeMarker(SelectMarker); // 去掉发光
     }
 }
 
-void Mode_1::playShake(QPushButton *btn)
-{
-    auto *anim = new QPropertyAnimation(btn, "pos");
-    QPoint p = btn->pos();
-    anim->setDuration(120);
-    anim->setKeyValueAt(0, p);
-    anim->setKeyValueAt(0.25, p - QPoint(4, 0));
-    anim->setKeyValueAt(0.75, p + QPoint(4, 0));
-    anim->setKeyValueAt(1, p);
-    anim->start(QAbstractAnimation::DeleteWhenStopped);
-}
 
-
-/* 辅助：计算某个方向有多少个连续同色 (不包含中心自己) */
-int Mode_1::countDirection(int r, int c, int dR, int dC)
-{
-    int color = m_board->m_grid[r][c].pic;
-    int count = 0;
-    int nr = r + dR;
-    int nc = c + dC;
-    while(nr >= 0 && nr < ROW && nc >= 0 && nc < COL &&
-           m_board->m_grid[nr][nc].pic == color) {
-        count++;
-        nr += dR;
-        nc += dC;
-    }
-    return count;
-}
-
-/* 核心算法：根据你的规则计算需要消除的点 */
-/* mode_1.cpp - 修改 getEliminations */
-
-Mode_1::ElimResult Mode_1::getEliminations(int r, int c)
+/* 统筹流程：交换后立即结算到稳定，再按事件播放 */
+void Mode_1::processInteraction(int r1, int c1, int r2, int c2)
 {
-    ElimResult res;
-    res.center = QPoint(r, c); // 记录触发点
-
-    int color = m_board->m_grid[r][c].pic;
-    if (color == -1) return res;
-
-    int up    = countDirection(r, c, -1, 0);
-    int down  = countDirection(r, c, 1, 0);
-    int left  = countDirection(r, c, 0, -1);
-    int right = countDirection(r, c, 0, 1);
-
-    // 规则 1: 全屏消除 (魔鸟/闪电)
-    if ((up + down >= 4) || (left + right >= 4)) {
-        res.type = ColorClear;
-        for (int i = 0; i < ROW; ++i) {
-            for (int j = 0; j < COL; ++j) {
-                if (m_board->m_grid[i][j].pic == color) {
-                    res.points.insert(QPoint(i, j));
-                }
-            }
-        }
-        return res;
-    }
-
-    // 规则 2: 行/列消除
-    if (up + down == 3) {
-        res.type = ColBomb;
-        for (int i = 0; i < ROW; ++i) res.points.insert(QPoint(i, c));
-        return res;
-    }
-    if (left + right == 3) {
-        res.type = RowBomb;
-        for (int j = 0; j < COL; ++j) res.points.insert(QPoint(r, j));
-        return res;
-    }
-
-    // 规则 3: 5x5 炸弹 (T/L型)
-    if (up + down >= 2 && left + right >= 2) {
-        res.type = AreaBomb;
-        for (int i = r - 2; i <= r + 2; ++i) {
-            for (int j = c - 2; j <= c + 2; ++j) {
-                if (i >= 0 && i < ROW && j >= 0 && j < COL) {
-                    res.points.insert(QPoint(i, j));
-                }
-            }
-        }
-        return res;
-    }
-
-    // 规则 4: 普通三消
-    if (up + down >= 2) {
-        for (int i = r - up; i <= r + down; ++i) res.points.insert(QPoint(i, c));
-        res.type = Normal;
-    }
-    if (left + right >= 2) {
-        for (int j = c - left; j <= c + right; ++j) res.points.insert(QPoint(r, j));
-        res.type = Normal; // 即使是十字消除，如果没有达到炸弹条件，也算普通，或者你可以加个 CrossBomb
+    // 逻辑层：交换 + 全部连消立即结算完，g 就是稳定后的棋盘
+    Grid g = m_board->grid();
+    const QVector<Event> events = m_resolver.resolveSwap(g, r1, c1, r2, c2);
+
+    // 只有 交换 + 稳定 两个事件 = 没有消除：数据不动，两格抖动
+    if (events.size() == 2) {
+        m_view->playShake(r1, c1);
+        m_view->playShake(r2, c2);
+        return;
     }
 
-    return res;
+    // 棋盘数据已是稳定后的状态，不用等动画播完就能接着操作；只有死局要锁到洗牌
+    m_board->m_grid = g;
+    m_isLocked = events.last().dead;
+    playEvents(events);
 }
-/* 统筹流程：交换后，处理两个点，并执行动画 */
-/* mode_1.cpp - 修复后的 processInteraction */
-
-/* mode_1.cpp - 修复类型匹配错误的 processInteraction */
 
-void Mode_1::processInteraction(int r1, int c1, int r2, int c2)
+/* 技能：先消掉指定格子，再下落补位并结算连消 */
+void Mode_1::clearCells(const QSet<QPoint> &points, const QVector<CascadeResolver::Effect> &effects)
 {
-    m_isLocked = true; // 上锁
-
-    // 1. 【修复点】使用 ElimResult 接收结果，而不是 QSet<QPoint>
-    ElimResult res1 = getEliminations(r1, c1);
-    ElimResult res2 = getEliminations(r2, c2);
-
-    // 2. 提取点集用于合并
-    QSet<QPoint> allToRemove = res1.points;
-    allToRemove.unite(res2.points);
-
-    // 3. 如果没消除，回滚并抖动
-    if (allToRemove.isEmpty()) {
-        std::swap(m_board->m_grid[r1][c1].pic, m_board->m_grid[r2][c2].pic);
-        playShake(m_cells[r1 * COL + c1]);
-        playShake(m_cells[r2 * COL + c2]);
-        ui->boardWidget->setEnabled(true);
-        m_isLocked = false; // 解锁
+    if (points.isEmpty()) {
+        // 没有可消的格子，只放特效
+        for (const CascadeResolver::Effect &fx : effects) playSpecialEffect(fx.type, fx.center, 0);
         return;
     }
 
-    // 4. 视觉交换动画
-    int idx1 = r1 * COL + c1;
-    int idx2 = r2 * COL + c2;
-    QPushButton *btn1 = m_cells[idx1];
-    QPushButton *btn2 = m_cells[idx2];
-
-    // 交换 m_cells 指针
-    std::swap(m_cells[idx1], m_cells[idx2]);
-
-    QParallelAnimationGroup *swapGroup = new QParallelAnimationGroup(this);
-
-    QPropertyAnimation *anim1 = new QPropertyAnimation(btn1, "pos");
-    anim1->setDuration(300);
-    anim1->setStartValue(btn1->pos());
-    anim1->setEndValue(btn2->pos());
-
-    QPropertyAnimation *anim2 = new QPropertyAnimation(btn2, "pos");
-    anim2->setDuration(300);
-    anim2->setStartValue(btn2->pos());
-    anim2->setEndValue(btn1->pos());
-
-    swapGroup->addAnimation(anim1);
-    swapGroup->addAnimation(anim2);
-
-    // 5. 动画结束：播放特效 + 消除
-    // 【关键】lambda 需要捕获 res1 和 res2 以便判断播放哪种特效
-    connect(swapGroup, &QAbstractAnimation::finished, this, [this, swapGroup, allToRemove, res1, res2](){
-        swapGroup->deleteLater();
-
-        // 播放特效 (如果有)
-        // 简单策略：只要触发了高级特效就播，如果两个都有则都播
-        if (res1.type != Normal && res1.type != None)
-            playSpecialEffect(res1.type, res1.center, 0);
-
-        if (res2.type != Normal && res2.type != None)
-            playSpecialEffect(res2.type, res2.center, 0);
-
-        // 执行消除
-        playEliminateAnim(allToRemove);
-    });
-
-    swapGroup->start();
+    Grid g = m_board->grid();
+    const QVector<Event> events = m_resolver.resolveClear(g, points, effects);
+    m_board->m_grid = g;
+    m_isLocked = events.last().dead;
+    playEvents(events);
 }
 
-/* mode_1.cpp 中的 performFallAnimation 函数 */
+/* =========================================================
+ * 事件播放 (交换、消除、特效、下落)
+ * ========================================================= */
 
-/* 请直接复制这个函数覆盖原有的 performFallAnimation */
-
-/* mode_1.cpp - 最终修复版 performFallAnimation */
-
-void Mode_1::performFallAnimation()
+void Mode_1::playEvents(const QVector<Event> &events)
 {
-    QRect cr = ui->boardWidget->contentsRect();
-    int cellSize = 48;
-    int gap = 2;
-    int totalW = COL * (cellSize + gap) - gap;
-    int totalH = ROW * (cellSize + gap) - gap;
-    int ox = cr.left() + (cr.width() - totalW) / 2;
-    int oy = cr.top()  + (cr.height() - totalH) / 2;
-
-    QParallelAnimationGroup *fallGroup = new QParallelAnimationGroup(this);
-    auto *rng = QRandomGenerator::global();
-
-    // 辅助结构：存方块和它的颜色
-    struct BlockData {
-        QPushButton* btn;
-        int color;
-    };
-
-    /* 【关键步骤 0】：先把所有幸存按钮从 QGridLayout 里"踢"出来
-       这样它们就变成了绝对定位的悬浮控件，不再受布局限制，
-       防止布局管理器把它们强行拽回原来的格子导致"空缺"。 */
-    for (QPushButton *b : m_cells) {
-        if (b) {
-            m_gridLayout->removeWidget(b);
-            // 移除后它们还在 boardWidget 上，只是不受管束了，位置保持不变
-        }
-    }
-
-    for (int c = 0; c < COL; ++c) {
-        QList<BlockData> survivors;
-
-        // 1. 收集幸存者
-        for (int r = ROW - 1; r >= 0; --r) {
-            int idx = r * COL + c;
-            if (m_cells[idx] != nullptr) {
-                survivors.append({m_cells[idx], m_board->m_grid[r][c].pic});
-                m_cells[idx] = nullptr;
-            }
-        }
+    // 视觉层：交换 -> 消除 -> 下落 -> ... -> 稳定
+    for (const Event &ev : events) m_events.enqueue(ev);
+    playNextEvent();
+}
 
-        // 2. 重建这一列
-        int survivorIdx = 0;
-        for (int r = ROW - 1; r >= 0; --r) {
-            QPushButton *btn = nullptr;
-            int finalColor = 0;
-            bool isExistingBtn = false;
-
-            int destX = ox + c * (cellSize + gap);
-            int destY = oy + r * (cellSize + gap);
-
-            if (survivorIdx < survivors.size()) {
-                // --- 旧方块 ---
-                BlockData bd = survivors[survivorIdx];
-                btn = bd.btn;
-                finalColor = bd.color;
-                isExistingBtn = true;
-                survivorIdx++;
-            } else {
-                // --- 新方块 ---
-                finalColor = rng->bounded(6);
-                isExistingBtn = false;
-
-                btn = new QPushButton(ui->boardWidget);
-                btn->setFixedSize(cellSize, cellSize);
-                btn->setStyleSheet("border:none;");
-                QString path = QString("%1%2.png").arg(QDir::currentPath() + "/").arg(finalColor);
-                btn->setIcon(QIcon(path));
-                btn->setIconSize(QSize(cellSize, cellSize));
-                btn->show();
-
-                // 新方块从高空掉落
-                int startY = destY - (ROW * cellSize + 100);
-                btn->move(destX, startY);
-            }
+void Mode_1::playNextEvent()
+{
+    if (m_events.isEmpty()) return;
 
-            // 3. 更新全局状态
-            m_cells[r * COL + c] = btn;
-            m_board->m_grid[r][c].pic = finalColor;
-
-            // 4. 设置信号
-            if (isExistingBtn) btn->disconnect();
-            connect(btn, &QPushButton::clicked, this, [this, r, c]() {
-                handleCellClick(r, c);
-            });
-
-            // 5. 创建动画
-            QPoint startPos = btn->pos();
-            QPoint endPos = QPoint(destX, destY);
-
-            // 只有位置不同才动，防止微小抖动
-            if (startPos != endPos) {
-                QPropertyAnimation *anim = new QPropertyAnimation(btn, "pos");
-                anim->setDuration(500);
-                anim->setStartValue(startPos);
-                anim->setEndValue(endPos);
-                anim->setEasingCurve(QEasingCurve::OutBounce);
-                fallGroup->addAnimation(anim);
-            } else {
-                btn->move(endPos);
-            }
-        }
+    // 瞬间速度：不播动画，直接摆出最终棋盘
+    if (m_tweens->speed() == 0) {
+        skipToEnd();
+        return;
     }
 
-    // 动画结束后，把它们重新收编回布局
-    connect(fallGroup, &QAbstractAnimation::finished, this, [this, fallGroup](){
-
-        /* 【关键步骤 6】：一切尘埃落定，把按钮重新塞回 QGridLayout
-           这样窗口缩放时它们能自动适应，且保证下次操作的基础位置正确 */
-        for (int r = 0; r < ROW; ++r) {
-            for (int c = 0; c < COL; ++c) {
-                QPushButton *btn = m_cells[r * COL + c];
-                if (btn) {
-                    m_gridLayout->addWidget(btn, r, c);
-                }
-            }
-        }
-
+    Event ev = m_events.dequeue();
+    switch (ev.type) {
+    case Event::Swap:
+        m_view->playSwap(ev.a.x(), ev.a.y(), ev.b.x(), ev.b.y(), [this](){ playNextEvent(); });
+        break;
+    case Event::Eliminate: playEliminateAnim(ev); break;
+    case Event::Fall:      performFallAnimation(ev); break;
+    case Event::Settled:   onBoardSettled(ev); break;
+    }
+}
 
-        fallGroup->deleteLater();
-        checkComboMatches();
+void Mode_1::performFallAnimation(const Event &ev)
+{
+    // 补位颜色由结算时决定，这里只负责显示：幸存者下沉，新方块从高空掉落
+    m_view->playFall(ev.grid, [this](){
+        playNextEvent(); // 下一轮消除或稳定
     });
-
-    fallGroup->start();
 }
-/* mode_1.cpp - 新增函数 */
-
-/* mode_1.cpp - 修改 checkComboMatches */
 
-void Mode_1::checkComboMatches()
+void Mode_1::skipToEnd()
 {
-    QSet<QPoint> allMatches;
+    if (m_events.isEmpty()) return;
 
-    // 【新增】用来记录已经播放过特效的中心点，防止重复播放
-    QSet<QPoint> processedCenters;
+    // 进行中的补间连同待触发的阶段回调一起作废；终极爆发那一轮已经播出，标志随之复位
+    m_tweens->stop();
+    m_ultimateBurstActive = false;
 
-    // 扫描全盘连击
-    for (int r = 0; r < ROW; ++r) {
-        for (int c = 0; c < COL; ++c) {
-
-            // 优化：如果这个点已经被标记为待消除了，且不是特殊连消的关键点，理论上可以跳过
-            // 但为了保险起见（因为可能是交叉消除的一部分），我们还是检查一下，主要靠 processedCenters 去重
-
-            ElimResult res = getEliminations(r, c);
-
-            if (!res.points.isEmpty()) {
-                // 1. 收集要消除的点
-                allMatches.unite(res.points);
-
-                // 2. 【新增】检查是否有特殊效果
-                if (res.type != Normal && res.type != None) {
-                    // 如果这个特效组的中心点还没处理过，就播放特效
-                    if (!processedCenters.contains(res.center)) {
-                        playSpecialEffect(res.type, res.center, 0);
-                        processedCenters.insert(res.center); // 标记已处理
-                    }
-                }
-            }
-        }
-    }
-
-    if (!allMatches.isEmpty()) {
-        m_isLocked = true;
-        playEliminateAnim(allMatches); // 继续消除
-    } else {
-        // 死局检测
-        if (m_board->isDead(m_board->grid())) {
-            handleDeadlock();
-        } else {
-            m_isLocked = false;
+    Event last = m_events.last();
+    while (!m_events.isEmpty()) {
+        Event ev = m_events.dequeue();
+        if (ev.type == Event::Eliminate) {
+            addScore(ev.points.size());
         }
     }
+    // 直接摆出最终棋盘
+    m_view->setGrid(last.grid);
+    onBoardSettled(last);
 }
 
+void Mode_1::onBoardSettled(const Event &ev)
+{
+    m_isLocked = false;
 
-
+    // 死局检测
+    if (ev.dead) handleDeadlock();
+}
 
 /* mode_1.cpp - 新增特效函数 */
 
 void Mode_1::playSpecialEffect(EffectType type, QPoint center, int colorCode)
 {
-    if (type == None || type == Normal) return;
-
-    // 计算中心点的像素坐标
-    int cellSize = 48; int gap = 2;
-    // 这里需要重新获取 ox, oy，建议把 ox, oy 变成成员变量，或者重新算一次
-    QRect cr = ui->boardWidget->contentsRect();
-    int totalW = COL * (cellSize + gap) - gap;
-    int totalH = ROW * (cellSize + gap) - gap;
-    int ox = cr.left() + (cr.width() - totalW) / 2;
-    int oy = cr.top()  + (cr.height() - totalH) / 2;
-
-    int centerX = ox + center.y() * (cellSize + gap) + cellSize / 2;
-    int centerY = oy + center.x() * (cellSize + gap) + cellSize / 2;
-
-    // 1. 行/列 激光炮
-    if (type == RowBomb || type == ColBomb) {
-        QLabel *beam = new QLabel(ui->boardWidget);
-        beam->setAttribute(Qt::WA_TransparentForMouseEvents); // 鼠标穿透
-        beam->show();
-
-        // 样式：中间白，两边透明的渐变
-        QString qss = "background: qlineargradient(x1:0, y1:0, x2:%1, y2:%2, "
-                      "stop:0 rgba(255,255,255,0), stop:0.5 rgba(255,255,255,230), stop:1 rgba(255,255,255,0));";
-
-        QPropertyAnimation *anim = new QPropertyAnimation(beam, "geometry");
-        anim->setDuration(400);
-        anim->setEasingCurve(QEasingCurve::OutExpo);
-
-        if (type == RowBomb) {
-            // 横向激光
-            beam->setStyleSheet(qss.arg("0").arg("1")); // 垂直渐变
-            anim->setStartValue(QRect(ox, centerY - 2, totalW, 4)); // 初始细线
-            anim->setEndValue(QRect(ox, centerY - 25, totalW, 50)); // 瞬间变宽
-        } else {
-            // 纵向激光
-            beam->setStyleSheet(qss.arg("1").arg("0")); // 水平渐变
-            anim->setStartValue(QRect(centerX - 2, oy, 4, totalH));
-            anim->setEndValue(QRect(centerX - 25, oy, 50, totalH));
-        }
-
-        // 同时变透明
-        QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(beam);
-        beam->setGraphicsEffect(eff);
-        QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-        fade->setDuration(400);
-        fade->setStartValue(1.0);
-        fade->setEndValue(0.0);
-        fade->start(QAbstractAnimation::DeleteWhenStopped); // 删除 effect
-
-        anim->start(QAbstractAnimation::DeleteWhenStopped); // 动画结束删除 label
-        connect(anim, &QAbstractAnimation::finished, beam, &QLabel::deleteLater);
+    if (type == CascadeResolver::None || type == CascadeResolver::Normal) return;
+
+    // 特效直接画在棋盘上，位置跟着格子走
+    // 1. 行/列 激光炮：中间白，两边透明，细线瞬间变宽并淡出
+    if (type == CascadeResolver::RowBomb) {
+        m_view->playBeam(Qt::Horizontal, center.x(), QColor(255, 255, 255, 230));
+    } else if (type == CascadeResolver::ColBomb) {
+        m_view->playBeam(Qt::Vertical, center.y(), QColor(255, 255, 255, 230));
     }
 
-    // 2. 区域炸弹 (冲击波)
-    else if (type == AreaBomb) {
-        QLabel *shockwave = new QLabel(ui->boardWidget);
-        shockwave->setAttribute(Qt::WA_TransparentForMouseEvents);
-        // 圆形径向渐变
-        shockwave->setStyleSheet(
-            "background: qradialgradient(cx:0.5, cy:0.5, radius:0.5, fx:0.5, fy:0.5, "
-            "stop:0 rgba(255,255,255,0), stop:0.7 rgba(255, 200, 100, 200), stop:1 rgba(255,255,255,0));"
-            "border-radius: 100px;"); // 半径设大一点保证是圆的
-        shockwave->show();
-
-        QPropertyAnimation *anim = new QPropertyAnimation(shockwave, "geometry");
-        anim->setDuration(500);
-        anim->setEasingCurve(QEasingCurve::OutQuad);
-
-        // 从中心扩散
-        QRect startRect(centerX, centerY, 0, 0);
-        QRect endRect(centerX - 150, centerY - 150, 300, 300); // 扩散半径 150
-
-        anim->setStartValue(startRect);
-        anim->setEndValue(endRect);
-
-        anim->start(QAbstractAnimation::DeleteWhenStopped);
-        connect(anim, &QAbstractAnimation::finished, shockwave, &QLabel::deleteLater);
+    // 2. 区域炸弹 (冲击波)，扩散半径 150
+    else if (type == CascadeResolver::AreaBomb) {
+        m_view->playShockwave(center.x(), center.y(), 150, QColor(255, 200, 100, 200));
     }
 
     // 3. 全屏闪光
-    else if (type == ColorClear) {
-        QLabel *flash = new QLabel(ui->boardWidget);
-        flash->setAttribute(Qt::WA_TransparentForMouseEvents);
-        flash->setStyleSheet("background-color: rgba(255, 255, 255, 180);");
-        flash->setGeometry(ui->boardWidget->rect()); // 覆盖整个区域
-        flash->show();
-
-        QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(flash);
-        flash->setGraphicsEffect(eff);
-
-        QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-        fade->setDuration(600);
-        fade->setStartValue(1.0);
-        fade->setEndValue(0.0);
-
-        connect(fade, &QAbstractAnimation::finished, flash, &QLabel::deleteLater);
-        fade->start();
+    else if (type == CascadeResolver::ColorClear) {
+        m_view->playFlash(QColor(255, 255, 255, 180), 600);
     }
 }
 
-void Mode_1::playEliminateAnim(const QSet<QPoint>& points)
+void Mode_1::playEliminateAnim(const Event &ev)
 {
+    const QSet<QPoint> &points = ev.points;
+
+    // 本轮触发的特效 (同一中心只放一次，结算时已去重)
+    for (const CascadeResolver::Effect &fx : ev.effects)
+        playSpecialEffect(fx.type, fx.center, 0);
+
     // 【插入计分】
     if (!points.isEmpty()) {
         addScore(points.size());
@@ -861,101 +413,33 @@ void Mode_1::playEliminateAnim(const QSet<QPoint>& points)
         MusicManager::instance().playMatchSound(elimCount);
     }
 
-    QParallelAnimationGroup *elimGroup = new QParallelAnimationGroup(this);
-
-    for (const QPoint &p : points) {
-        int idx = p.x() * COL + p.y();
-        QPushButton *btn = m_cells[idx];
-        if (!btn) continue;
-
-        // 1. 创建动画：缩小 + 变透明
-        QPropertyAnimation *scale = new QPropertyAnimation(btn, "geometry");
-        scale->setDuration(250);
-        QRect rect = btn->geometry();
-        scale->setStartValue(rect);
-        scale->setEndValue(rect.adjusted(24, 24, -24, -24)); // 向中心缩小
-
-        QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(btn);
-        btn->setGraphicsEffect(eff);
-        QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-        fade->setDuration(250);
-        fade->setStartValue(1.0);
-        fade->setEndValue(0.0);
-
-        elimGroup->addAnimation(scale);
-        elimGroup->addAnimation(fade);
-
-        // 2. 逻辑层先把数据标记为 -1 (空)
-        m_board->m_grid[p.x()][p.y()].pic = -1;
-    }
-
-    // 3. 动画结束后，执行物理删除和下落
-    connect(elimGroup, &QAbstractAnimation::finished, this, [this, elimGroup, points](){
-        // 真正的物理删除
-        for (const QPoint &p : points) {
-            int idx = p.x() * COL + p.y();
-            if (m_cells[idx]) {
-                delete m_cells[idx];    // 释放内存
-                m_cells[idx] = nullptr; // 置空指针
-            }
-        }
-        elimGroup->deleteLater();
-
+    // 方块缩小淡出，结束后棋盘自己置空，接着下落
+    m_view->playEliminate(points, [this](){
         // 【新增】重置终极爆发标志位
         m_ultimateBurstActive = false;
-        // 进入下落阶段
-        performFallAnimation();
+        playNextEvent();
     });
-
-    elimGroup->start();
 }
 
 /* mode_1.cpp - 优化后的 handleDeadlock */
 void Mode_1::handleDeadlock()
 {
-    if (m_isLocked && !ui->btnBack->hasFocus()) return; // 避免重复触发，但允许测试按钮
     m_isLocked = true;
 
-    // 1. 创建提示标签
-    QLabel *lbl = new QLabel(ui->boardWidget);
-    lbl->setText("死局！重新洗牌");
-    lbl->setAlignment(Qt::AlignCenter);
-    lbl->setStyleSheet(
-        "background-color: rgba(0, 0, 0, 180);"
-        "color: #ff9de0;"
-        "font: bold 26pt 'Microsoft YaHei';"
-        "border-radius: 15px;"
-        "border: 2px solid #ff9de0;"
-        );
-    lbl->adjustSize();
-    lbl->resize(lbl->width() + 60, lbl->height() + 40);
-
-    // 居中
-    QRect cr = ui->boardWidget->rect();
-    lbl->move((cr.width() - lbl->width()) / 2, (cr.height() - lbl->height()) / 2);
-    lbl->show();
-    lbl->setAttribute(Qt::WA_TransparentForMouseEvents); // 【关键】让鼠标能穿透，虽然它锁住了
-
-    // 2. 淡入淡出动画
-    QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(lbl);
-    lbl->setGraphicsEffect(eff);
-
-    QPropertyAnimation *anim = new QPropertyAnimation(eff, "opacity");
-    anim->setDuration(2000);
-    anim->setKeyValueAt(0.0, 0.0);
-    anim->setKeyValueAt(0.1, 1.0);
-    anim->setKeyValueAt(0.8, 1.0);
-    anim->setKeyValueAt(1.0, 0.0);
-
-    connect(anim, &QAbstractAnimation::finished, this, [this, lbl](){
-        lbl->deleteLater(); // 销毁标签
-
+    // 提示横幅：淡入 → 停留 → 淡出，共 2 秒
+    BoardView::Banner banner;
+    banner.text = "死局！重新洗牌";
+    banner.color = QColor("#ff9de0");
+    banner.pointSize = 26;
+    banner.boxed = true;
+    banner.fadeIn = 200;
+    banner.hold = 1400;
+    banner.fadeOut = 400;
+    m_view->showBanner(banner, [this](){
         // 重新生成棋盘 -> 这会触发 gridUpdated 信号 -> 进而触发 rebuildGrid -> createDropAnimation
         // createDropAnimation 结束后会自动执行 m_isLocked = false
         m_board->initNoThree();
     });
-
-    anim->start(QAbstractAnimation::DeleteWhenStopped);
 }
 /* mode_1.cpp - 修复后的 gameOver 函数 */
 void Mode_1::gameOver()
@@ -1176,6 +660,27 @@ void Mode_1::onBackButtonClicked()
     }
 }
 
+void Mode_1::on_btnSpeed_clicked()
+{
+    // 1x -> 2x -> 4x -> 瞬间 -> 1x
+    switch (qRound(m_tweens->speed())) {
+    case 1:  setPlaybackSpeed(2); break;
+    case 2:  setPlaybackSpeed(4); break;
+    case 4:  setPlaybackSpeed(0); break;
+    default: setPlaybackSpeed(1); break;
+    }
+}
+
+void Mode_1::setPlaybackSpeed(int speed)
+{
+    m_tweens->setSpeed(speed);
+    ui->btnSpeed->setText(speed == 0 ? "跳过" : QString("%1x").arg(speed));
+
+    // 切到瞬间：正在播的这一步也不再等，直接跳到结算后的棋盘
+    if (speed == 0) skipToEnd();
+}
+
+
 
 /* mode_1.cpp - 新增函数实现 */
 
@@ -1389,6 +894,7 @@ void Mode_1::on_btnSkill_clicked()
         // 连接逻辑 (保持之前的特效逻辑完全不变)
         connect(skillBtn, &QPushButton::clicked, skillDialog, [this, skill, skillDialog, wasRunning]() {
             skillDialog->accept();
+            skipToEnd();   // 技能作用在结算后的棋盘上，没播完的先快进
 
             int scoreToAdd = 0;
             int timeToAdd = 0;
@@ -1398,10 +904,9 @@ void Mode_1::on_btnSkill_clicked()
 
             if (skill->id == "row_clear") {
                 int row = QRandomGenerator::global()->bounded(ROW);
-                playSpecialEffect(RowBomb, QPoint(row, 0), 0); // 特效
                 QSet<QPoint> pts;
                 for (int c = 0; c < COL; ++c) { if (m_board->m_grid[row][c].pic != -1) pts.insert(QPoint(row, c)); }
-                if (!pts.isEmpty()) playEliminateAnim(pts);
+                clearCells(pts, {{CascadeResolver::RowBomb, QPoint(row, 0)}}); // 消除 + 特效
 
             } else if (skill->id == "time_extend") {
                 timeToAdd = 5;
@@ -1410,20 +915,18 @@ void Mode_1::on_btnSkill_clicked()
 
             } else if (skill->id == "rainbow_bomb") {
                 int color = QRandomGenerator::global()->bounded(6);
-                playSpecialEffect(ColorClear, QPoint(ROW/2, COL/2), color); // 特效
                 QSet<QPoint> pts;
                 for (int r=0; r<ROW; ++r) { for (int c=0; c<COL; ++c) { if (m_board->m_grid[r][c].pic == color) pts.insert(QPoint(r, c)); }}
-                if (!pts.isEmpty()) playEliminateAnim(pts);
+                clearCells(pts, {{CascadeResolver::ColorClear, QPoint(ROW/2, COL/2)}});
 
             } else if (skill->id == "cross_clear") {
                 int cR = QRandomGenerator::global()->bounded(ROW);
                 int cC = QRandomGenerator::global()->bounded(COL);
-                playSpecialEffect(RowBomb, QPoint(cR, cC), 0); // 特效
-                playSpecialEffect(ColBomb, QPoint(cR, cC), 0); // 特效
                 QSet<QPoint> pts;
                 for (int c=0; c<COL; ++c) if (m_board->m_grid[cR][c].pic != -1) pts.insert(QPoint(cR, c));
                 for (int r=0; r<ROW; ++r) if (m_board->m_grid[r][cC].pic != -1) pts.insert(QPoint(r, cC));
-                if (!pts.isEmpty()) playEliminateAnim(pts);
+                clearCells(pts, {{CascadeResolver::RowBomb, QPoint(cR, cC)},
+                                 {CascadeResolver::ColBomb, QPoint(cR, cC)}});
 
             } else if (skill->id == "score_double") {
                 m_scoreDoubleActive = true;
@@ -1433,7 +936,6 @@ void Mode_1::on_btnSkill_clicked()
             } else if (skill->id == "color_unify") {
                 m_colorUnifyActive = true;
                 m_skillEffectTimer->start(6000);
-                playSpecialEffect(ColorClear, QPoint(0,0), 0); // 特效
                 int c1 = QRandomGenerator::global()->bounded(6);
                 int c2 = QRandomGenerator::global()->bounded(6);
                 int c3 = QRandomGenerator::global()->bounded(6);
@@ -1443,27 +945,20 @@ void Mode_1::on_btnSkill_clicked()
                         }}}
                 skillMessage = "UNIFY COLOR (6s)";
                 rebuildGrid();
+                playSpecialEffect(CascadeResolver::ColorClear, QPoint(0,0), 0); // 特效放在重建之后，重建会清掉棋盘上的特效
 
             } else if (skill->id == "time_freeze") {
                 timeToAdd = 15;
                 skillMessage = "TIME FREEZE";
-                QLabel *flash = new QLabel(ui->boardWidget);
-                flash->setStyleSheet("background-color: rgba(0, 200, 255, 100);");
-                flash->setGeometry(ui->boardWidget->rect());
-                flash->show(); flash->setAttribute(Qt::WA_TransparentForMouseEvents);
-                QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(flash); flash->setGraphicsEffect(eff);
-                QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-                fade->setDuration(1000); fade->setStartValue(1.0); fade->setEndValue(0.0);
-                connect(fade, &QAbstractAnimation::finished, flash, &QLabel::deleteLater); fade->start();
+                m_view->playFlash(QColor(0, 200, 255, 100), 1000);
 
             } else if (skill->id == "ultimate_burst") {
                 QSet<QPoint> pts;
                 m_ultimateBurstActive = true;
-                playSpecialEffect(ColorClear, QPoint(0,0), 0); // 特效
                 for (int r=0; r<ROW; ++r) for (int c=0; c<COL; ++c) if (m_board->m_grid[r][c].pic != -1) pts.insert(QPoint(r, c));
                 int sc = 3200; if (m_scoreDoubleActive) sc*=2;
                 m_score += sc; ui->labelScore_2->setText(QString("分数 %1").arg(m_score));
-                if (!pts.isEmpty()) playEliminateAnim(pts);
+                clearCells(pts, {{CascadeResolver::ColorClear, QPoint(0,0)}});
             }
 
             // --- 逻辑结束 ---
@@ -1515,56 +1010,15 @@ void Mode_1::on_btnSkill_clicked()
 // 【新增】显示临时消息函数
 void Mode_1::showTempMessage(const QString& message, const QColor& color)
 {
-    if (!ui->boardWidget) return;
-
-    QLabel* lbl = new QLabel(ui->boardWidget);
-    lbl->setText(message);
-    lbl->setAlignment(Qt::AlignCenter);
-
-    // 使用传入的颜色
-    QString colorStr = QString("rgb(%1, %2, %3)").arg(color.red()).arg(color.green()).arg(color.blue());
-    lbl->setStyleSheet(
-        QString(
-            "color: %1;"
-            "font: bold 24pt 'Microsoft YaHei';"
-            "background: transparent;"
-            ).arg(colorStr)
-        );
-
-    lbl->adjustSize();
-    QRect cr = ui->boardWidget->rect();
-    lbl->move((cr.width() - lbl->width()) / 2, (cr.height() - lbl->height()) / 2);
-    lbl->show();
-    lbl->setAttribute(Qt::WA_TransparentForMouseEvents);
-
-    QGraphicsOpacityEffect* eff = new QGraphicsOpacityEffect(lbl);
-    lbl->setGraphicsEffect(eff);
-
-    // 快速淡入淡出动画
-    QSequentialAnimationGroup* seq = new QSequentialAnimationGroup(this);
-
-    QPropertyAnimation* fadeIn = new QPropertyAnimation(eff, "opacity");
-    fadeIn->setDuration(300);
-    fadeIn->setStartValue(0.0);
-    fadeIn->setEndValue(1.0);
-    fadeIn->setEasingCurve(QEasingCurve::OutQuad);
-    seq->addAnimation(fadeIn);
-
-    seq->addPause(1500); // 停留1.5秒
-
-    QPropertyAnimation* fadeOut = new QPropertyAnimation(eff, "opacity");
-    fadeOut->setDuration(300);
-    fadeOut->setStartValue(1.0);
-    fadeOut->setEndValue(0.0);
-    fadeOut->setEasingCurve(QEasingCurve::InQuad);
-    seq->addAnimation(fadeOut);
-
-    connect(seq, &QAbstractAnimation::finished, this, [lbl, seq](){
-        lbl->deleteLater();
-        seq->deleteLater();
-    });
-
-    seq->start();
+    // 快速淡入淡出，停留 1.5 秒
+    BoardView::Banner banner;
+    banner.text = message;
+    banner.color = color;
+    banner.pointSize = 24;
+    banner.fadeIn = 300;
+    banner.hold = 1500;
+    banner.fadeOut = 300;
+    m_view->showBanner(banner);
 }
 
 /* mode_1.cpp - 提示功能实现 */
@@ -1574,7 +1028,8 @@ void Mode_1::on_btnHint_clicked()
 {
     // 校验：没次数了、锁定了、暂停了、或者当前正在播放提示动画，都不处理
     if (m_hintCount <= 0 || m_isLocked || m_isPaused) return;
-    if (m_hintAnimGroup && m_hintAnimGroup->state() == QAbstractAnimation::Running) return;
+    if (!m_hintCells.isEmpty()) return;
+    skipToEnd();   // 提示框要对准结算后的棋盘
 
     // 执行查找逻辑
     int r1, c1, r2, c2;
@@ -1592,9 +1047,9 @@ void Mode_1::on_btnHint_clicked()
         }
 
         // 高亮这两个方块
-        m_hintBtns.clear();
-        m_hintBtns.append(m_cells[r1 * COL + c1]);
-        m_hintBtns.append(m_cells[r2 * COL + c2]);
+        m_hintCells.clear();
+        m_hintCells.append(QPoint(r1, c1));
+        m_hintCells.append(QPoint(r2, c2));
 
         showHint();
     } else {
@@ -1631,56 +1086,33 @@ bool Mode_1::findValidMove(int &r1, int &c1, int &r2, int &c2)
 // 启动高亮动画 (黄色呼吸光晕)
 void Mode_1::showHint()
 {
-    if (m_hintBtns.isEmpty()) return;
-
-    // 创建动画组
-    if (m_hintAnimGroup) { m_hintAnimGroup->deleteLater(); }
-    m_hintAnimGroup = new QSequentialAnimationGroup(this);
-    m_hintAnimGroup->setLoopCount(-1); // 无限循环，直到用户点击
-
-    QParallelAnimationGroup *pulseGroup = new QParallelAnimationGroup(this);
-
-    for (QPushButton *btn : m_hintBtns) {
-        // 给按钮加特效 (黄色光晕)
-        QGraphicsDropShadowEffect *eff = new QGraphicsDropShadowEffect(btn);
-        eff->setColor(QColor(255, 235, 59)); // 黄色
-        eff->setBlurRadius(0);
-        eff->setOffset(0, 0);
-        btn->setGraphicsEffect(eff);
-
-        // 动画：BlurRadius 从 0 -> 40 -> 0 (呼吸效果)
-        QPropertyAnimation *anim = new QPropertyAnimation(eff, "blurRadius");
-        anim->setDuration(800);
-        anim->setStartValue(0);
-        anim->setKeyValueAt(0.5, 40);
-        anim->setEndValue(0);
-        anim->setEasingCurve(QEasingCurve::InOutSine);
-
-        pulseGroup->addAnimation(anim);
+    if (m_hintCells.isEmpty()) return;
+
+    int id = HintMarkerA;
+    for (const QPoint &p : m_hintCells) {
+        // 黄色光晕，呼吸由棋盘调度器循环推进，直到用户点击
+        BoardView::Marker m;
+        m.cells = QRect(p.y(), p.x(), 1, 1);
+        m.color = QColor(255, 235, 59);
+        m.width = 0;
+        m.margin = 0;
+        m.glow = true;
+        m_view->setMarker(id, m);
+        m_view->pulseMarker(id, 0.0, 800);
+        ++id;
     }
-
-    m_hintAnimGroup->addAnimation(pulseGroup);
-    m_hintAnimGroup->start();
 }
 
 // 停止高亮动画
 void Mode_1::stopHint()
 {
     // 如果没有正在进行的提示，直接返回
-    if (!m_hintAnimGroup && m_hintBtns.isEmpty()) return;
-
-    // 1. 停止动画
-    if (m_hintAnimGroup) {
-        m_hintAnimGroup->stop();
-        m_hintAnimGroup->deleteLater();
-        m_hintAnimGroup = nullptr;
-    }
+    if (m_hintCells.isEmpty()) return;
 
-    // 2. 清除特效
-    for (QPushButton *btn : m_hintBtns) {
-        if (btn) btn->setGraphicsEffect(nullptr); // 移除光晕
-    }
-    m_hintBtns.clear();
+    // 移除光晕（呼吸补间随之取消）
+    m_view->removeMarker(HintMarkerA);
+    m_view->removeMarker(HintMarkerB);
+    m_hintCells.clear();
 }
 
 void Mode_1::resetSkills()
@@ -1719,67 +1151,21 @@ void Mode_1::onSkillEffectTimeout()
 // mode_1.cpp - 新增函数：显示技能结束提示（非干扰性）
 void Mode_1::showSkillEndHint(const QString& message)
 {
-    if (!ui->boardWidget) return;
-
-    // 创建提示标签
-    QLabel* hintLabel = new QLabel(ui->boardWidget);
-    hintLabel->setText(message);
-    hintLabel->setAlignment(Qt::AlignCenter);
-
-    // 样式：半透明，不遮挡游戏内容
-    hintLabel->setStyleSheet(
-        "background-color: rgba(0, 0, 0, 180);"
-        "color: #ff9de0;"  // 粉色主题
-        "font: bold 16pt 'Microsoft YaHei';"
-        "border-radius: 8px;"
-        "border: 1px solid #ff9de0;"
-        "padding: 10px;"
-        );
-
-    // 计算位置：显示在棋盘上方，不遮挡主要内容
-    QRect boardRect = ui->boardWidget->rect();
-    int labelWidth = boardRect.width() * 0.8;  // 宽度为棋盘80%
-    int labelHeight = 50;
-    int labelX = boardRect.left() + (boardRect.width() - labelWidth) / 2;
-    int labelY = boardRect.top() + 20;  // 顶部留出空间
-
-    hintLabel->setGeometry(labelX, labelY, labelWidth, labelHeight);
-    hintLabel->show();
-    hintLabel->raise();  // 确保在最上层
-    hintLabel->setAttribute(Qt::WA_TransparentForMouseEvents);  // 鼠标穿透
-
-    // 创建淡入淡出动画
-    QGraphicsOpacityEffect* effect = new QGraphicsOpacityEffect(hintLabel);
-    hintLabel->setGraphicsEffect(effect);
-
-    QSequentialAnimationGroup* animGroup = new QSequentialAnimationGroup(this);
-
-    // 淡入 (0.5秒)
-    QPropertyAnimation* fadeIn = new QPropertyAnimation(effect, "opacity");
-    fadeIn->setDuration(500);
-    fadeIn->setStartValue(0.0);
-    fadeIn->setEndValue(1.0);
-    fadeIn->setEasingCurve(QEasingCurve::InOutQuad);
-
-    // 停留 (2秒)
-    animGroup->addAnimation(fadeIn);
-    animGroup->addPause(2000);
-
-    // 淡出 (0.5秒)
-    QPropertyAnimation* fadeOut = new QPropertyAnimation(effect, "opacity");
-    fadeOut->setDuration(500);
-    fadeOut->setStartValue(1.0);
-    fadeOut->setEndValue(0.0);
-    fadeOut->setEasingCurve(QEasingCurve::InOutQuad);
-    animGroup->addAnimation(fadeOut);
-
-    // 动画结束后清理
-    connect(animGroup, &QAbstractAnimation::finished, this, [hintLabel, animGroup]() {
-        hintLabel->deleteLater();
-        animGroup->deleteLater();
-    });
-
-    animGroup->start(QAbstractAnimation::DeleteWhenStopped);
+    // 样式：半透明框，显示在棋盘上方，不遮挡主要内容
+    BoardView::Banner banner;
+    banner.text = message;
+    banner.color = QColor("#ff9de0");  // 粉色主题
+    banner.pointSize = 16;
+    banner.boxed = true;
+    banner.border = 1;
+    banner.radius = 8;
+    banner.padding = QSize(10, 10);
+    banner.width = m_view->width() * 0.8;  // 宽度为棋盘80%
+    banner.top = 20;                        // 顶部留出空间
+    banner.fadeIn = 500;
+    banner.hold = 2000;
+    banner.fadeOut = 500;
+    m_view->showBanner(banner);
 }
 
 
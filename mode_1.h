@@ -3,24 +3,23 @@
 #define MODE_1_H
 
 #include <QWidget>
-#include <QSequentialAnimationGroup>
-#include <QPropertyAnimation>
-#include <QGraphicsDropShadowEffect>
 #include <QTimer>
-#include <QPushButton>
-#include <QHash>
 #include <QMessageBox>
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
 
 #include <QStack>          // 【新增】栈
+#include <QQueue>
 #include "gameboard.h"     // 确保包含 GameBoard 定义以使用 Grid 类型
 #include "skilltree.h"
+#include "cascaderesolver.h"
 
 #include "musicmanager.h"
 
 class GameBoard;
-class QGridLayout;
+class BoardView;
+class TweenScheduler;
+class PerfMonitor;
 
 namespace Ui { class Mode_1; }
 
@@ -52,7 +51,7 @@ signals:
 
 private slots:
     void rebuildGrid();
-    void createDropAnimation(int left0, int top0);
+    void createDropAnimation();
 
     // 【新增】倒计时槽函数
     void onTimerTick();
@@ -66,6 +65,7 @@ private slots:
     void on_btnUndo_clicked();  // 撤步
     void on_btnHint_clicked();  // 提示 (先占位)
     void on_btnSkill_clicked(); // 技能 (先占位)
+    void on_btnSpeed_clicked(); // 播放速度 1x -> 2x -> 4x -> 瞬间
 
 
 
@@ -73,34 +73,37 @@ private:
     void clearGridLayout();
     Ui::Mode_1            *ui;
     GameBoard             *m_board;
-    QGridLayout           *m_gridLayout;
-    QVector<QPushButton*>  m_cells;
-    QSequentialAnimationGroup *m_dropGroup;
+    BoardView             *m_view;        // 自绘棋盘
+    TweenScheduler        *m_tweens;      // 本棋盘全部动画，由 m_view 持有
+    PerfMonitor           *m_perf;        // 性能面板
     bool m_ultimateBurstActive = false;
 
     // 交互逻辑
     void handleCellClick(int r, int c);
     int m_clickCount = 0;
     int m_selR = -1, m_selC = -1;
-    QHash<QPushButton*, QString> m_originalStyle;
-    void setSelected(QPushButton *btn, bool on);
-    void playShake(QPushButton *btn);
+    enum BoardMarker { SelectMarker, HintMarkerA, HintMarkerB };   // 棋盘上的选中框 / 提示框
+    void setSelected(int r, int c, bool on);
     void processInteraction(int r1, int c1, int r2, int c2);
-    void applyGravity();
-    int countDirection(int r, int c, int dR, int dC);
-    void performFallAnimation();
-    void checkComboMatches();
-    void playEliminateAnim(const QSet<QPoint>& points);
+    void clearCells(const QSet<QPoint> &points, const QVector<CascadeResolver::Effect> &effects);
+
+    // 逻辑与表现分离（同 Mode_AI）：一次操作由 CascadeResolver 立即结算到稳定，
+    // 产生的事件进队列，界面逐个消费
+    using Event = CascadeResolver::Event;
+    CascadeResolver        m_resolver;
+    QQueue<Event>          m_events;
+
+    void playEvents(const QVector<Event> &events);
+    void playNextEvent();
+    void playEliminateAnim(const Event &ev);
+    void performFallAnimation(const Event &ev);
+    void onBoardSettled(const Event &ev);
+    void skipToEnd();                  // 新操作到来或切到瞬间：清空队列，直接摆出最终棋盘
+    void setPlaybackSpeed(int speed);
 
     bool m_isLocked = false;
 
-    enum EffectType { None, Normal, RowBomb, ColBomb, AreaBomb, ColorClear };
-    struct ElimResult {
-        QSet<QPoint> points;
-        EffectType type = None;
-        QPoint center = QPoint(-1, -1);
-    };
-    ElimResult getEliminations(int r, int c);
+    using EffectType = CascadeResolver::EffectType;
     void playSpecialEffect(EffectType type, QPoint center, int colorCode);
     void handleDeadlock();
 
@@ -136,8 +139,7 @@ private:
     // 【新增】提示功能变量
     // ==========================================
     int m_hintCount = 3;                       // 剩余次数
-    QList<QPushButton*> m_hintBtns;            // 当前被高亮的按钮
-    QSequentialAnimationGroup *m_hintAnimGroup = nullptr; // 提示动画组
+    QList<QPoint> m_hintCells;                 // 当前被高亮的格子
 
     // 查找并显示提示
     void showHint();
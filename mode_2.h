@@ -2,19 +2,18 @@
 #define MODE_2_H
 
 #include <QWidget>
-#include <QSequentialAnimationGroup>
-#include <QPropertyAnimation>
-#include <QGraphicsDropShadowEffect>
 #include <QTimer>
-#include <QPushButton>
 #include <QStack>
-#include <QLabel>
+#include <QQueue>
 #include "gameboard.h"
+#include "cascaderesolver.h"
 #include "skilltree.h"
 
 #include "musicmanager.h"
 
-class QGridLayout;
+class BoardView;
+class TweenScheduler;
+class PerfMonitor;
 
 namespace Ui { class mode_2; }
 
@@ -45,46 +44,53 @@ signals:
 
 private slots:
     void rebuildGrid();
-    void createDropAnimation(int left0, int top0);
+    void createDropAnimation();
     void onTimerTick();
     void onBackButtonClicked();
     void on_btnUndo_clicked();
     void on_btnHint_clicked();
     void on_btnSkill_clicked();
+    void on_btnSpeed_clicked(); // 播放速度 1x -> 2x -> 4x -> 瞬间
 
 private:
     Ui::mode_2 *ui;
     GameBoard *m_board;
-    QGridLayout *m_gridLayout;
-    QVector<QPushButton*> m_cells;
-    QSequentialAnimationGroup *m_dropGroup = nullptr;
+    BoardView *m_view;                    // 自绘棋盘
+    TweenScheduler *m_tweens = nullptr;   // 本棋盘全部动画，由 m_view 持有
+    PerfMonitor *m_perf = nullptr;        // 性能面板
     bool m_ultimateBurstActive = false;
 
     // === 旋风模式特有变量 ===
-    QLabel *m_selectorFrame; // 2x2 的选择光圈
+    enum BoardMarker { SelectorMarker };     // 2x2 的选择光圈，画在棋盘上
     int m_selR = -1;         // 当前光圈左上角的行
     int m_selC = -1;         // 当前光圈左上角的列
 
     void updateSelectorPos(QPoint mousePos); // 根据鼠标更新光圈位置
+    void showSelector(int r, int c, int width = 3);
     void tryRotateInteraction();             // 执行旋转交互
     void processRotation(int r, int c);      // 旋转动画
 
     // === 通用逻辑 (保留) ===
     void clearGridLayout();
-    void performFallAnimation();
-    void checkComboMatches();
-    void playEliminateAnim(const QSet<QPoint>& points);
-
-    // 消除判定相关
-    enum EffectType { None, Normal, RowBomb, ColBomb, AreaBomb, ColorClear };
-    struct ElimResult {
-        QSet<QPoint> points;
-        EffectType type = None;
-        QPoint center = QPoint(-1, -1);
-    };
-    ElimResult getEliminations(int r, int c);
+    void clearCells(const QSet<QPoint> &points, const QVector<CascadeResolver::Effect> &effects);
+
+    // 逻辑与表现分离（同 Mode_AI）：一次操作由 CascadeResolver 立即结算到稳定，
+    // 产生的事件进队列，界面逐个消费
+    using Event = CascadeResolver::Event;
+    CascadeResolver m_resolver;
+    QQueue<Event> m_events;
+
+    void playEvents(const QVector<Event> &events);
+    void playNextEvent();
+    void playEliminateAnim(const Event &ev);
+    void performFallAnimation(const Event &ev);
+    void onBoardSettled(const Event &ev);
+    void skipToEnd();                  // 新操作到来或切到瞬间：清空队列，直接摆出最终棋盘
+    void setPlaybackSpeed(int speed);
+
+    // 消除判定在 CascadeResolver
+    using EffectType = CascadeResolver::EffectType;
     void playSpecialEffect(EffectType type, QPoint center, int colorCode); // 修复参数类型匹配
-    int countDirection(int r, int c, int dR, int dC);
 
     // 状态管理
     void handleDeadlock();
@@ -105,7 +111,7 @@ private:
 
     // === 提示功能 (已修改为旋转逻辑) ===
     int m_hintCount = 3;
-    QSequentialAnimationGroup *m_hintAnimGroup = nullptr;
+    bool m_hintActive = false;                // 光圈正在呼吸提示
     bool findValidMove(int &outR, int &outC); // 查找可消除的旋转点
     void showHint(int r, int c);              // 高亮 2x2 区域
     void stopHint();
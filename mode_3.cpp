@@ -1,19 +1,24 @@
 #include "mode_3.h"
 #include "ui_mode_3.h"
+#include "tilesprites.h"
+#include "boardview.h"
+#include "tweenscheduler.h"
+#include "perfmonitor.h"
 #include "networkmanager.h"
 #include <QGridLayout>
+#include <QPushButton>
+#include <QLabel>
 #include <QMouseEvent>
 #include <QDebug>
 #include <QRandomGenerator>
 #include <QDir>
 #include <QMessageBox>
-#include <QParallelAnimationGroup>
-#include <QGraphicsOpacityEffect>
 #include <QDialog>
 #include <QtSql>
 
 Mode_3::Mode_3(GameBoard *board, QString username, QWidget *parent)
-    : QWidget(parent), ui(new Ui::mode_3), m_board(board), m_username(username)
+    : QWidget(parent), ui(new Ui::mode_3), m_board(board),
+      m_resolver(board, QRandomGenerator::global()), m_username(username)
 {
     ui->setupUi(this);
 
@@ -44,22 +49,21 @@ Mode_3::Mode_3(GameBoard *board, QString username, QWidget *parent)
     ui->labelCountdown->setText("03:00");
     ui->btnHint->setText(QString("提示 (%1)").arg(m_hintCount));
 
-    m_gridLayout = new QGridLayout(ui->boardWidget);
-    m_gridLayout->setSpacing(2);
-    m_gridLayout->setContentsMargins(4, 4, 4, 4);
+    // 自绘棋盘铺满 boardWidget；选中指示器也画在棋盘上，跟着棋盘几何走
+    m_view = new BoardView(ui->boardWidget);
+    auto *boardLayout = new QVBoxLayout(ui->boardWidget);
+    boardLayout->setContentsMargins(0, 0, 0, 0);
+    boardLayout->addWidget(m_view);
+    m_tweens = m_view->tweens();
 
-    // 【核心】开启鼠标追踪
-    ui->boardWidget->setMouseTracking(true);
-    ui->boardWidget->installEventFilter(this);
+    // 【核心】开启鼠标追踪，点击和悬停都由事件过滤器处理
+    m_view->setMouseTracking(true);
+    m_view->installEventFilter(this);
 
-    // 创建选中指示器（单个格子）
-    m_selectionIndicator = new QLabel(ui->boardWidget);
-    m_selectionIndicator->setStyleSheet("border: 3px solid #7cffcb; border-radius: 10px; background: rgba(124, 255, 203, 30);");
-    m_selectionIndicator->setAttribute(Qt::WA_TransparentForMouseEvents);
-    m_selectionIndicator->hide();
-
-    // 动画组初始化
-    m_dropGroup = new QSequentialAnimationGroup(this);
+    // 性能面板（F3 显示，F4 记录 CSV）
+    m_perf = new PerfMonitor(this, "mode3");
+    m_perf->watch(m_tweens);
+    m_perf->watch(&m_resolver);
 
     m_gameTimer = new QTimer(this);
     m_gameTimer->setInterval(1000);
@@ -102,12 +106,8 @@ void Mode_3::generateRandomAnimal()
 
 void Mode_3::updateAnimalDisplay()
 {
-    if (m_currentAnimal >= 0 && m_currentAnimal < 6) {
-        QString path = QString("%1%2.png").arg(QDir::currentPath() + "/").arg(m_currentAnimal);
-        QPixmap pix(path);
-        if (!pix.isNull()) {
-            ui->labelCurrentAnimal->setPixmap(pix.scaled(60, 60, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        }
+    if (m_currentAnimal >= 0 && m_currentAnimal < COLOR_COUNT) {
+        ui->labelCurrentAnimal->setPixmap(TileSprites::instance().pixmap(m_currentAnimal, 60));
     }
 }
 
@@ -123,7 +123,7 @@ bool Mode_3::eventFilter(QObject *watched, QEvent *event)
     }
 
     // 棋盘交互
-    if (watched == ui->boardWidget && !m_isLocked && !m_isPaused && m_hasGameStarted) {
+    if (watched == m_view && !m_isLocked && !m_isPaused && m_hasGameStarted) {
         if (event->type() == QEvent::MouseMove) {
             QMouseEvent *me = static_cast<QMouseEvent*>(event);
             updateSelectionPos(me->pos());
@@ -136,7 +136,7 @@ bool Mode_3::eventFilter(QObject *watched, QEvent *event)
             return true;
         }
         else if (event->type() == QEvent::Leave) {
-            m_selectionIndicator->hide();
+            m_view->removeMarker(SelectionMarker);
             m_selectedR = -1; m_selectedC = -1;
         }
     }
@@ -145,50 +145,45 @@ bool Mode_3::eventFilter(QObject *watched, QEvent *event)
 
 void Mode_3::updateSelectionPos(QPoint mousePos)
 {
-    int cellSize = 48; int gap = 2;
-    QRect cr = ui->boardWidget->contentsRect();
-    int totalW = COL * (cellSize + gap) - gap;
-    int totalH = ROW * (cellSize + gap) - gap;
-    int ox = cr.left() + (cr.width() - totalW) / 2;
-    int oy = cr.top()  + (cr.height() - totalH) / 2;
-
-    // 计算鼠标位于哪个格子
-    int c = (mousePos.x() - ox) / (cellSize + gap);
-    int r = (mousePos.y() - oy) / (cellSize + gap);
-
-    if (r < 0 || r >= ROW || c < 0 || c >= COL) {
-        m_selectionIndicator->hide();
+    // 计算鼠标位于哪个格子（格缝算前一格）
+    QPoint origin = m_view->cellRect(0, 0).topLeft();
+    int c = (mousePos.x() - origin.x()) / m_view->pitch();
+    int r = (mousePos.y() - origin.y()) / m_view->pitch();
+
+    if (mousePos.x() < origin.x() || mousePos.y() < origin.y()
+        || r < 0 || r >= ROW || c < 0 || c >= COL) {
+        m_view->removeMarker(SelectionMarker);
         m_selectedR = -1; m_selectedC = -1;
         return;
     }
 
     m_selectedR = r; m_selectedC = c;
+    showSelection(r, c);
+}
 
-    int targetX = ox + c * (cellSize + gap) - 1;
-    int targetY = oy + r * (cellSize + gap) - 1;
-
-    m_selectionIndicator->resize(cellSize + 2, cellSize + 2);
-    m_selectionIndicator->move(targetX, targetY);
-    m_selectionIndicator->show();
-    m_selectionIndicator->raise();
+void Mode_3::showSelection(int r, int c, bool hint)
+{
+    // 单格指示器，向外扩 1px；提示时换成黄色
+    BoardView::Marker m;
+    m.cells = QRect(c, r, 1, 1);
+    m.color = hint ? QColor("#ffeb3b") : QColor("#7cffcb");
+    m.fill = hint ? QColor(255, 235, 59, 60) : QColor(124, 255, 203, 30);
+    m.width = 3;
+    m.radius = 10;
+    m.margin = 1;
+    m_view->setMarker(SelectionMarker, m);
 }
 
 void Mode_3::tryTransformInteraction()
 {
     if (m_selectedR == -1 || m_selectedC == -1) return;
     if (m_currentAnimal < 0) return;
+    skipToEnd();   // 上一步还没播完：先快进到结算后的棋盘
 
     // 检查点击的格子是否已经是当前动物类型
     if (m_board->m_grid[m_selectedR][m_selectedC].pic == m_currentAnimal) {
         // 抖动提示
-        QPropertyAnimation *shake = new QPropertyAnimation(m_selectionIndicator, "pos");
-        shake->setDuration(200);
-        QPoint p = m_selectionIndicator->pos();
-        shake->setKeyValueAt(0, p);
-        shake->setKeyValueAt(0.25, p + QPoint(5, 0));
-        shake->setKeyValueAt(0.75, p - QPoint(5, 0));
-        shake->setKeyValueAt(1, p);
-        shake->start(QAbstractAnimation::DeleteWhenStopped);
+        m_view->shakeMarker(SelectionMarker, -5, 200);   // 先右后左
         return;
     }
 
@@ -201,115 +196,45 @@ void Mode_3::tryTransformInteraction()
 
 void Mode_3::processTransform(int r, int c)
 {
-    m_isLocked = true;
-    m_selectionIndicator->hide();
-
-    // 创建变身动画
-    QPushButton *btn = m_cells[r * COL + c];
-    if (!btn) {
-        m_isLocked = false;
-        return;
-    }
-
-    // 1. [第一阶段] 消失动画：缩小 + 变透明
-    QParallelAnimationGroup *disappearGroup = new QParallelAnimationGroup(this);
-
-    QPropertyAnimation *scaleOut = new QPropertyAnimation(btn, "geometry");
-    scaleOut->setDuration(150);
-    QRect rect = btn->geometry();
-    scaleOut->setStartValue(rect);
-    scaleOut->setEndValue(rect.adjusted(24, 24, -24, -24)); // 向中心缩小
-
-    QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(btn);
-    btn->setGraphicsEffect(eff);
-    QPropertyAnimation *fadeOut = new QPropertyAnimation(eff, "opacity");
-    fadeOut->setDuration(150);
-    fadeOut->setStartValue(1.0);
-    fadeOut->setEndValue(0.0);
-
-    disappearGroup->addAnimation(scaleOut);
-    disappearGroup->addAnimation(fadeOut);
-
-    // 连接第一阶段结束信号
-    connect(disappearGroup, &QAbstractAnimation::finished, this, [this, btn, r, c, eff, disappearGroup](){
-
-        // 2. [逻辑改变] 改变格子数据
-        m_board->m_grid[r][c].pic = m_currentAnimal;
-
-        // 更新按钮图标
-        QString path = QString("%1%2.png").arg(QDir::currentPath() + "/").arg(m_currentAnimal);
-        btn->setIcon(QIcon(path));
-
-        // 3. 生成下一个随机小动物
-        generateRandomAnimal();
-
-        // 4. [第二阶段] 出现动画：放大 + 变实体
-        QPropertyAnimation *scaleIn = new QPropertyAnimation(btn, "geometry");
-        scaleIn->setDuration(150);
-        QRect rect = btn->geometry(); // 此时 rect 已经是缩小后的了，或者需要重新获取原始大小
-
-        // 重新计算原始大小 (为了保险，重新算一遍标准位置)
-        // 注意：btn->geometry() 在 disappear 动画后已被修改，所以这里最好恢复到 grid 布局的大小
-        // 但简单起见，我们利用动画的反向值
-        QRect originalRect = rect.adjusted(-24, -24, 24, 24);
-
-        scaleIn->setStartValue(rect);
-        scaleIn->setEndValue(originalRect);
-        scaleIn->setEasingCurve(QEasingCurve::OutBack); // 加一点弹跳效果，感觉更生动
-
-        QPropertyAnimation *fadeIn = new QPropertyAnimation(eff, "opacity");
-        fadeIn->setDuration(150);
-        fadeIn->setStartValue(0.0);
-        fadeIn->setEndValue(1.0);
-
-        QParallelAnimationGroup *appearGroup = new QParallelAnimationGroup(this);
-        appearGroup->addAnimation(scaleIn);
-        appearGroup->addAnimation(fadeIn);
-
-        // 连接第二阶段结束信号
-        connect(appearGroup, &QAbstractAnimation::finished, this, [this, appearGroup, btn, eff, r, c](){
-
-            // 清理动画残留
-            btn->setGraphicsEffect(nullptr);
-            appearGroup->deleteLater();
-
-            // 5. 检查消除
-            QSet<QPoint> allMatches;
-            ElimResult res = getEliminations(r, c); // 使用捕获的 r, c
-
-            if (!res.points.isEmpty()) {
-                allMatches.unite(res.points);
-            }
-
-            if (!allMatches.isEmpty()) {
-                // 【核心修改】检测到消除后，不要立即消除！
-                // 停顿 300ms，让玩家看清楚“变身成功”的样子
-                QTimer::singleShot(300, this, [this, res, allMatches](){
-
-                    // 延迟后播放特效
-                    if (res.type != Normal && res.type != None) {
-                        playSpecialEffect(res.type, res.center, 0);
-                    }
-
-                    // 延迟后执行消除
-                    playEliminateAnim(allMatches);
-                });
-
-            } else {
-                // 没有消除，直接解锁
-                m_isLocked = false;
-                // 恢复选中指示器显示 (如果鼠标还在棋盘内)
-                if (ui->boardWidget->underMouse()) {
-                    m_selectionIndicator->show();
-                }
-            }
-        });
-
-        appearGroup->start();
-        disappearGroup->deleteLater();
+    m_view->removeMarker(SelectionMarker);
+
+    // 1. [逻辑改变] 改变格子数据，连消一次结算完
+    Grid g = m_board->grid();
+    g[r][c].pic = m_currentAnimal;
+    const QVector<Event> events = m_resolver.resolve(g);
+    commitGrid(g);
+
+    // 棋盘数据已是稳定后的状态，不用等动画播完就能接着操作；只有死局要锁到洗牌。
+    // 事件先进队列，变身途中来了新操作也能一起快进
+    m_isLocked = !m_targetIndex.hasAnyTarget();
+    for (const Event &ev : events) m_events.enqueue(ev);
+
+    // 2. 变身动画：图标缩小到消失 → 换成新动物 → 弹跳放大回原尺寸
+    const bool matched = events.size() > 1;
+    m_view->playTransform(r, c, m_currentAnimal, [this, matched](){
+        if (matched) {
+            // 【核心修改】检测到消除后，不要立即消除！
+            // 停顿 300ms，让玩家看清楚“变身成功”的样子（停顿也走调度器，跟着倍速，快进时一起作废）
+            m_view->playPause(300, [this](){ playNextEvent(); });
+        } else {
+            playNextEvent();   // 没有消除，直接稳定
+        }
     });
 
-    disappearGroup->start();
+    // 3. 生成下一个随机小动物
+    generateRandomAnimal();
+}
+
+/* 把结算后的棋盘写回，变化的格子标脏后立即重算目标索引（写回的就是稳定后的棋盘） */
+void Mode_3::commitGrid(const Grid &g)
+{
+    for (int r = 0; r < ROW; ++r) {
+        for (int c = 0; c < COL; ++c) {
+            if (m_board->m_grid[r][c].pic != g[r][c].pic) m_targetIndex.markDirty(r, c);
+        }
+    }
+    m_board->m_grid = g;
+    m_targetIndex.refresh(m_board->grid());
 }
 
 /* =========================================================
@@ -318,199 +243,99 @@ void Mode_3::processTransform(int r, int c)
 void Mode_3::rebuildGrid()
 {
     clearGridLayout();
-    m_cells.resize(ROW * COL);
-    const Grid &gr = m_board->grid();
-
-    QRect cr = ui->boardWidget->contentsRect();
-    int cellSize = 48; int gap = 2;
-    int totalW = COL * (cellSize + gap) - gap;
-    int totalH = ROW * (cellSize + gap) - gap;
-    int ox = cr.left() + (cr.width() - totalW) / 2;
-    int oy = cr.top()  + (cr.height() - totalH) / 2;
-
-    for(int r=0; r<ROW; ++r)
-        for(int c=0; c<COL; ++c) {
-            QPushButton *btn = new QPushButton(ui->boardWidget);
-            btn->setFixedSize(cellSize, cellSize);
-            btn->setStyleSheet("border:none;");
-            btn->setAttribute(Qt::WA_TransparentForMouseEvents);
-
-            QString path = QString("%1%2.png").arg(QDir::currentPath() + "/").arg(gr[r][c].pic);
-            btn->setIcon(QIcon(path));
-            btn->setIconSize(QSize(cellSize, cellSize));
-
-            int targetX = ox + c * (cellSize + gap);
-            int targetY = oy + r * (cellSize + gap);
-            int startY = targetY - (ROW * cellSize + 100);
-            btn->move(targetX, startY);
-
-            QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(btn);
-            eff->setOpacity(0.0);
-            btn->setGraphicsEffect(eff);
-            btn->show();
-            m_cells[r * COL + c] = btn;
-        }
-
-    createDropAnimation(ox, oy);
+    m_view->setGrid(m_board->grid());
+    m_targetIndex.rebuild(m_board->grid());
+    createDropAnimation();
 }
 
-void Mode_3::createDropAnimation(int left0, int top0)
+void Mode_3::createDropAnimation()
 {
-    if (m_dropGroup->state() == QAbstractAnimation::Running) {
-        m_dropGroup->stop();
-    }
-    m_dropGroup->clear();
-    m_dropGroup->disconnect(this);
-
-    int cellSize = 48; int gap = 2;
-
-    for(int r=ROW-1; r>=0; --r) {
-        auto *rowPar = new QParallelAnimationGroup(this);
-        for(int c=0; c<COL; ++c) {
-            QPushButton *btn = m_cells[r * COL + c];
-            if(!btn) continue;
-
-            auto *eff = qobject_cast<QGraphicsOpacityEffect*>(btn->graphicsEffect());
-            if(!eff) {
-                eff = new QGraphicsOpacityEffect(btn);
-                btn->setGraphicsEffect(eff);
-            }
-
-            int targetX = left0 + c * (cellSize + gap);
-            int targetY = top0  + r * (cellSize + gap);
-
-            auto *drop = new QPropertyAnimation(btn, "pos");
-            drop->setDuration(180 + (ROW-1-r)*15);
-            drop->setStartValue(QPoint(targetX, targetY - (ROW * cellSize + 100)));
-            drop->setEndValue(QPoint(targetX, targetY));
-            drop->setEasingCurve(QEasingCurve::OutBounce);
-
-            auto *fade = new QPropertyAnimation(eff, "opacity");
-            fade->setDuration(300);
-            fade->setStartValue(0.0);
-            fade->setEndValue(1.0);
-
-            auto *cellAnim = new QParallelAnimationGroup(this);
-            cellAnim->addAnimation(drop);
-            cellAnim->addAnimation(fade);
-            rowPar->addAnimation(cellAnim);
-        }
-        m_dropGroup->addAnimation(rowPar);
-    }
-
-    connect(m_dropGroup, &QSequentialAnimationGroup::finished, this, [this](){
-        for(int r=0; r<ROW; ++r)
-            for(int c=0; c<COL; ++c)
-                if(m_cells[r*COL+c]) m_gridLayout->addWidget(m_cells[r*COL+c], r, c);
+    // 最底行先落，每行 300ms 下一行接着开始；从画外（整盘高度之上）落下
+    m_view->playDropIn(-1, 300, [this]() {
         m_isLocked = false;
         if(!m_hasGameStarted) {
             m_hasGameStarted = true;
             startGameSequence();
         }
     });
-    m_dropGroup->start();
 }
 
-void Mode_3::performFallAnimation()
+/* 技能：先消掉指定格子，再下落补位并结算连消 */
+void Mode_3::clearCells(const QSet<QPoint> &points, const QVector<CascadeResolver::Effect> &effects)
 {
-    // 与 Mode_2 逻辑一致，但生成新按钮时要注意属性
-    QRect cr = ui->boardWidget->contentsRect();
-    int cellSize = 48; int gap = 2;
-    int totalW = COL * (cellSize + gap) - gap;
-    int totalH = ROW * (cellSize + gap) - gap;
-    int ox = cr.left() + (cr.width() - totalW) / 2;
-    int oy = cr.top()  + (cr.height() - totalH) / 2;
-
-    QParallelAnimationGroup *fallGroup = new QParallelAnimationGroup(this);
-    auto *rng = QRandomGenerator::global();
-
-    struct BlockData { QPushButton* btn; int color; };
-    for (QPushButton *b : m_cells) if (b) m_gridLayout->removeWidget(b);
-
-    for (int c = 0; c < COL; ++c) {
-        QList<BlockData> survivors;
-        for (int r = ROW - 1; r >= 0; --r) {
-            int idx = r * COL + c;
-            if (m_cells[idx]) {
-                survivors.append({m_cells[idx], m_board->m_grid[r][c].pic});
-                m_cells[idx] = nullptr;
-            }
-        }
+    if (points.isEmpty()) {
+        // 没有可消的格子，只放特效
+        for (const CascadeResolver::Effect &fx : effects) playSpecialEffect(fx.type, fx.center, 0);
+        return;
+    }
 
-        int survivorIdx = 0;
-        for (int r = ROW - 1; r >= 0; --r) {
-            QPushButton *btn = nullptr;
-            int finalColor = 0;
-            int destX = ox + c * (cellSize + gap);
-            int destY = oy + r * (cellSize + gap);
-
-            if (survivorIdx < survivors.size()) {
-                BlockData bd = survivors[survivorIdx++];
-                btn = bd.btn;
-                finalColor = bd.color;
-            } else {
-                finalColor = rng->bounded(6);
-                btn = new QPushButton(ui->boardWidget);
-                btn->setFixedSize(cellSize, cellSize);
-                btn->setStyleSheet("border:none;");
-                btn->setAttribute(Qt::WA_TransparentForMouseEvents);
-
-                QString path = QString("%1%2.png").arg(QDir::currentPath() + "/").arg(finalColor);
-                btn->setIcon(QIcon(path));
-                btn->setIconSize(QSize(cellSize, cellSize));
-                btn->show();
-                btn->move(destX, destY - (ROW * cellSize + 100));
-            }
-            m_cells[r * COL + c] = btn;
-            m_board->m_grid[r][c].pic = finalColor;
-
-            QPropertyAnimation *anim = new QPropertyAnimation(btn, "pos");
-            anim->setDuration(500);
-            anim->setStartValue(btn->pos());
-            anim->setEndValue(QPoint(destX, destY));
-            anim->setEasingCurve(QEasingCurve::OutBounce);
-            fallGroup->addAnimation(anim);
-        }
+    Grid g = m_board->grid();
+    const QVector<Event> events = m_resolver.resolveClear(g, points, effects);
+    commitGrid(g);
+    m_isLocked = !m_targetIndex.hasAnyTarget();
+    playEvents(events);
+}
+
+void Mode_3::playEvents(const QVector<Event> &events)
+{
+    // 视觉层：消除 -> 下落 -> ... -> 稳定
+    for (const Event &ev : events) m_events.enqueue(ev);
+    playNextEvent();
+}
+
+void Mode_3::playNextEvent()
+{
+    if (m_events.isEmpty()) return;
+
+    // 瞬间速度：不播动画，直接摆出最终棋盘
+    if (m_tweens->speed() == 0) {
+        skipToEnd();
+        return;
     }
 
-    connect(fallGroup, &QAbstractAnimation::finished, this, [this, fallGroup](){
-        for (QPushButton *b : m_cells) if (b) m_gridLayout->addWidget(b);
-        fallGroup->deleteLater();
-        checkComboMatches();
+    Event ev = m_events.dequeue();
+    switch (ev.type) {
+    case Event::Swap:      playNextEvent(); break;   // 本模式没有交换
+    case Event::Eliminate: playEliminateAnim(ev); break;
+    case Event::Fall:      performFallAnimation(ev); break;
+    case Event::Settled:   onBoardSettled(ev); break;
+    }
+}
+
+void Mode_3::performFallAnimation(const Event &ev)
+{
+    // 补位颜色由结算时决定，这里只负责显示
+    m_view->playFall(ev.grid, [this](){
+        playNextEvent(); // 下一轮消除或稳定
     });
-    fallGroup->start();
 }
 
-void Mode_3::checkComboMatches()
+void Mode_3::skipToEnd()
 {
-    QSet<QPoint> allMatches;
-    QSet<QPoint> processedCenters;
+    if (m_events.isEmpty()) return;
 
-    for (int r = 0; r < ROW; ++r) {
-        for (int c = 0; c < COL; ++c) {
-            ElimResult res = getEliminations(r, c);
-            if (!res.points.isEmpty()) {
-                allMatches.unite(res.points);
-                if (res.type != Normal && res.type != None) {
-                    if (!processedCenters.contains(res.center)) {
-                        playSpecialEffect(res.type, res.center, 0);
-                        processedCenters.insert(res.center);
-                    }
-                }
-            }
-        }
+    // 进行中的补间连同待触发的阶段回调一起作废；终极爆发那一轮已经播出，标志随之复位
+    m_tweens->stop();
+    m_ultimateBurstActive = false;
+
+    Event last = m_events.last();
+    while (!m_events.isEmpty()) {
+        Event ev = m_events.dequeue();
+        if (ev.type == Event::Eliminate) addScore(ev.points.size());
     }
+    // 直接摆出最终棋盘
+    m_view->setGrid(last.grid);
+    onBoardSettled(last);
+}
 
-    if (!allMatches.isEmpty()) {
-        m_isLocked = true;
-        playEliminateAnim(allMatches);
-    } else {
-        if (m_board->isDead(m_board->grid())) handleDeadlock();
-        else {
-            m_isLocked = false;
-            // 恢复选中指示器显示
-            if (ui->boardWidget->underMouse()) m_selectionIndicator->show();
-        }
+void Mode_3::onBoardSettled(const Event &ev)
+{
+    // 目标索引在写回时已刷新；变身模式的死局 = 任何颜色变身都无法成三
+    if (!m_targetIndex.hasAnyTarget()) handleDeadlock();
+    else {
+        m_isLocked = false;
+        // 恢复选中指示器显示
+        if (m_view->underMouse() && m_selectedR >= 0) showSelection(m_selectedR, m_selectedC);
     }
 }
 
@@ -520,17 +345,10 @@ void Mode_3::clearGridLayout()
     if (m_skillEffectTimer && m_skillEffectTimer->isActive()) {
         m_skillEffectTimer->stop();
     }
-    if (m_dropGroup) { m_dropGroup->stop(); m_dropGroup->clear(); }
-    for (QPushButton *b : m_cells) if (b) delete b;
-    m_cells.clear();
-    // 强制清理布局
-    if (m_gridLayout) {
-        QLayoutItem *item;
-        while ((item = m_gridLayout->takeAt(0)) != nullptr) {
-            if (item->widget()) delete item->widget();
-            delete item;
-        }
-    }
+    m_tweens->stop();
+    stopHint();
+    m_view->removeMarker(SelectionMarker);
+    m_events.clear();   // 没播完的事件作废
 }
 
 /* =========================================================
@@ -539,7 +357,8 @@ void Mode_3::clearGridLayout()
 void Mode_3::on_btnHint_clicked()
 {
     if (m_hintCount <= 0 || m_isLocked || m_isPaused) return;
-    if (m_hintAnimGroup && m_hintAnimGroup->state() == QAbstractAnimation::Running) return;
+    if (m_hintActive) return;
+    skipToEnd();   // 提示框要对准结算后的棋盘
 
     int r, c;
     if (findValidMove(r, c)) {
@@ -555,81 +374,29 @@ void Mode_3::on_btnHint_clicked()
 
 bool Mode_3::findValidMove(int &outR, int &outC)
 {
-    // 遍历所有格子，模拟将其变为当前动物类型，检查是否能消除
-    for (int r = 0; r < ROW; ++r) {
-        for (int c = 0; c < COL; ++c) {
-            // 如果已经是当前类型，跳过
-            if (m_board->m_grid[r][c].pic == m_currentAnimal) continue;
-
-            // 模拟变换
-            int originalType = m_board->m_grid[r][c].pic;
-            m_board->m_grid[r][c].pic = m_currentAnimal;
-
-            // 检查是否有消除
-            ElimResult res = getEliminations(r, c);
-
-            // 恢复原状
-            m_board->m_grid[r][c].pic = originalType;
-
-            if (!res.points.isEmpty()) {
-                outR = r; outC = c;
-                return true;
-            }
-        }
-    }
-    return false;
+    // 直接查目标索引：当前动物能成三的第一个格子（行优先，与逐格扫描结果一致）
+    m_targetIndex.refresh(m_board->grid());
+    return m_targetIndex.firstTarget(m_currentAnimal, outR, outC);
 }
 
 void Mode_3::showHint(int r, int c)
 {
     m_selectedR = r; m_selectedC = c;
 
-    int cellSize = 48; int gap = 2;
-    QRect cr = ui->boardWidget->contentsRect();
-    int totalW = COL * (cellSize + gap) - gap;
-    int totalH = ROW * (cellSize + gap) - gap;
-    int ox = cr.left() + (cr.width() - totalW) / 2;
-    int oy = cr.top()  + (cr.height() - totalH) / 2;
-    int targetX = ox + c * (cellSize + gap) - 1;
-    int targetY = oy + r * (cellSize + gap) - 1;
-
-    m_selectionIndicator->resize(cellSize + 2, cellSize + 2);
-    m_selectionIndicator->move(targetX, targetY);
-
-    // 设置闪烁样式
-    m_selectionIndicator->setStyleSheet("border: 3px solid #ffeb3b; border-radius: 10px; background: rgba(255, 235, 59, 60);");
-    m_selectionIndicator->show();
-    m_selectionIndicator->raise();
-
-    // 闪烁动画
-    if (m_hintAnimGroup) m_hintAnimGroup->deleteLater();
-    m_hintAnimGroup = new QSequentialAnimationGroup(this);
-    m_hintAnimGroup->setLoopCount(-1);
-
-    QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(m_selectionIndicator);
-    m_selectionIndicator->setGraphicsEffect(eff);
-
-    QPropertyAnimation *anim = new QPropertyAnimation(eff, "opacity");
-    anim->setDuration(800);
-    anim->setStartValue(1.0);
-    anim->setKeyValueAt(0.5, 0.3);
-    anim->setEndValue(1.0);
-    anim->setEasingCurve(QEasingCurve::InOutSine);
-
-    m_hintAnimGroup->addAnimation(anim);
-    m_hintAnimGroup->start();
+    // 黄色闪烁样式，透明度 1 → 0.3 → 1 循环，由棋盘调度器推进
+    showSelection(r, c, true);
+    m_view->pulseMarker(SelectionMarker, 0.3, 800);
+    m_hintActive = true;
 }
 
 void Mode_3::stopHint()
 {
-    if (m_hintAnimGroup) {
-        m_hintAnimGroup->stop();
-        m_hintAnimGroup->deleteLater();
-        m_hintAnimGroup = nullptr;
-    }
+    if (!m_hintActive) return;
+    m_hintActive = false;
+
     // 恢复默认样式
-    m_selectionIndicator->setGraphicsEffect(nullptr);
-    m_selectionIndicator->setStyleSheet("border: 3px solid #7cffcb; border-radius: 10px; background: rgba(124, 255, 203, 30);");
+    m_view->removeMarker(SelectionMarker);
+    if (m_selectedR >= 0) showSelection(m_selectedR, m_selectedC);
 }
 
 /* =========================================================
@@ -654,7 +421,11 @@ void Mode_3::on_btnUndo_clicked() {
     rebuildGrid();
 }
 
-void Mode_3::playEliminateAnim(const QSet<QPoint>& points) {
+void Mode_3::playEliminateAnim(const Event &ev) {
+    const QSet<QPoint> &points = ev.points;
+    for (const CascadeResolver::Effect &fx : ev.effects)
+        playSpecialEffect(fx.type, fx.center, 0);
+
     if (!points.isEmpty()) addScore(points.size());
 
     // 【新增】播放消除音效
@@ -664,87 +435,22 @@ void Mode_3::playEliminateAnim(const QSet<QPoint>& points) {
         MusicManager::instance().playMatchSound(elimCount);
     }
 
-    QParallelAnimationGroup *elimGroup = new QParallelAnimationGroup(this);
-    for (const QPoint &p : points) {
-        int idx = p.x() * COL + p.y();
-        QPushButton *btn = m_cells[idx];
-        if (!btn) continue;
-
-        QPropertyAnimation *scale = new QPropertyAnimation(btn, "geometry");
-        scale->setDuration(250);
-        QRect rect = btn->geometry();
-        scale->setStartValue(rect);
-        scale->setEndValue(rect.adjusted(24, 24, -24, -24));
-
-        QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(btn);
-        btn->setGraphicsEffect(eff);
-        QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-        fade->setDuration(250);
-        fade->setStartValue(1.0);
-        fade->setEndValue(0.0);
-
-        elimGroup->addAnimation(scale);
-        elimGroup->addAnimation(fade);
-        m_board->m_grid[p.x()][p.y()].pic = -1;
-    }
-
-    connect(elimGroup, &QAbstractAnimation::finished, this, [this, elimGroup, points](){
-        for (const QPoint &p : points) {
-            int idx = p.x() * COL + p.y();
-            if (m_cells[idx]) { delete m_cells[idx]; m_cells[idx] = nullptr; }
-        }
-        elimGroup->deleteLater();
+    m_view->playEliminate(points, [this](){
         m_ultimateBurstActive = false;
-        performFallAnimation();
+        playNextEvent();
     });
-    elimGroup->start();
-}
-
-Mode_3::ElimResult Mode_3::getEliminations(int r, int c) {
-    ElimResult res; res.center = QPoint(r, c);
-    int color = m_board->m_grid[r][c].pic;
-    if (color == -1) return res;
-    int up = countDirection(r, c, -1, 0); int down = countDirection(r, c, 1, 0);
-    int left = countDirection(r, c, 0, -1); int right = countDirection(r, c, 0, 1);
-
-    if ((up + down >= 4) || (left + right >= 4)) {
-        res.type = ColorClear;
-        for (int i=0; i<ROW; ++i) for (int j=0; j<COL; ++j) if(m_board->m_grid[i][j].pic==color) res.points.insert(QPoint(i,j));
-        return res;
-    }
-    if (up + down == 3) { res.type = ColBomb; for(int i=0; i<ROW; ++i) res.points.insert(QPoint(i, c)); return res; }
-    if (left + right == 3) { res.type = RowBomb; for(int j=0; j<COL; ++j) res.points.insert(QPoint(r, j)); return res; }
-    if (up + down >= 2 && left + right >= 2) {
-        res.type = AreaBomb;
-        for(int i=r-2; i<=r+2; ++i) for(int j=c-2; j<=c+2; ++j) if(i>=0 && i<ROW && j>=0 && j<COL) res.points.insert(QPoint(i, j));
-        return res;
-    }
-    if (up + down >= 2) { res.type = Normal; for(int i=r-up; i<=r+down; ++i) res.points.insert(QPoint(i,c)); }
-    if (left + right >= 2) { res.type = Normal; for(int j=c-left; j<=c+right; ++j) res.points.insert(QPoint(r,j)); }
-    return res;
-}
-
-int Mode_3::countDirection(int r, int c, int dR, int dC) {
-    int color = m_board->m_grid[r][c].pic;
-    int cnt = 0; int nr = r+dR; int nc = c+dC;
-    while(nr>=0 && nr<ROW && nc>=0 && nc<COL && m_board->m_grid[nr][nc].pic == color) { cnt++; nr+=dR; nc+=dC; }
-    return cnt;
 }
 
 void Mode_3::handleDeadlock() {
-    if (m_isLocked && !ui->btnBack->hasFocus()) return;
     m_isLocked = true;
-    QLabel *lbl = new QLabel(ui->boardWidget);
-    lbl->setText("死局！重新洗牌");
-    lbl->setAlignment(Qt::AlignCenter);
-    lbl->setStyleSheet("background-color:rgba(0,0,0,180); color:#7cffcb; font:bold 26pt 'Microsoft YaHei'; border-radius:15px; border:2px solid #7cffcb;");
-    lbl->adjustSize(); lbl->resize(lbl->width()+60, lbl->height()+40);
-    QRect cr = ui->boardWidget->rect();
-    lbl->move((cr.width()-lbl->width())/2, (cr.height()-lbl->height())/2);
-    lbl->show();
-    lbl->setAttribute(Qt::WA_TransparentForMouseEvents);
-    QTimer::singleShot(2000, [this, lbl](){
-        lbl->deleteLater();
+    BoardView::Banner banner;
+    banner.text = "死局！重新洗牌";
+    banner.color = QColor("#7cffcb");
+    banner.pointSize = 26;
+    banner.boxed = true;
+    banner.hold = 2000;
+    banner.fadeOut = 0;
+    m_view->showBanner(banner, [this](){
         m_board->initNoThree();
     });
 }
@@ -757,13 +463,13 @@ void Mode_3::startGameSequence() {
     // 【新增】播放游戏过程背景音乐
     MusicManager::instance().playSceneMusic(MusicManager::MusicScene::Playing);
 
-    QLabel *lbl = new QLabel(ui->boardWidget);
-    lbl->setText("Ready Go!"); lbl->setStyleSheet("color:#7cffcb; font:bold 40pt 'Microsoft YaHei';");
-    lbl->adjustSize();
-    QRect cr = ui->boardWidget->rect();
-    lbl->move((cr.width()-lbl->width())/2, (cr.height()-lbl->height())/2);
-    lbl->show();
-    QTimer::singleShot(1000, [this, lbl](){ lbl->deleteLater(); m_isLocked=false; m_gameTimer->start(); });
+    BoardView::Banner banner;
+    banner.text = "Ready Go!";
+    banner.color = QColor("#7cffcb");
+    banner.pointSize = 40;
+    banner.hold = 1000;
+    banner.fadeOut = 0;
+    m_view->showBanner(banner, [this](){ m_isLocked=false; m_gameTimer->start(); });
 }
 
 void Mode_3::onTimerTick() {
@@ -922,6 +628,7 @@ void Mode_3::on_btnSkill_clicked()
 
         connect(skillBtn, &QPushButton::clicked, skillDialog, [this, skill, skillDialog, wasRunning]() {
             skillDialog->accept();
+            skipToEnd();   // 技能作用在结算后的棋盘上，没播完的先快进
 
             int scoreToAdd = 0;
             int timeToAdd = 0;
@@ -930,10 +637,9 @@ void Mode_3::on_btnSkill_clicked()
             // --- 技能逻辑 (保持原有逻辑不变) ---
             if (skill->id == "row_clear") {
                 int row = QRandomGenerator::global()->bounded(ROW);
-                playSpecialEffect(RowBomb, QPoint(row, 0), 0);
                 QSet<QPoint> pts;
                 for (int c = 0; c < COL; ++c) { if (m_board->m_grid[row][c].pic != -1) pts.insert(QPoint(row, c)); }
-                if (!pts.isEmpty()) playEliminateAnim(pts);
+                clearCells(pts, {{CascadeResolver::RowBomb, QPoint(row, 0)}});
 
             } else if (skill->id == "time_extend") {
                 timeToAdd = 5;
@@ -941,20 +647,18 @@ void Mode_3::on_btnSkill_clicked()
 
             } else if (skill->id == "rainbow_bomb") {
                 int color = QRandomGenerator::global()->bounded(6);
-                playSpecialEffect(ColorClear, QPoint(ROW/2, COL/2), color);
                 QSet<QPoint> pts;
                 for (int r=0; r<ROW; ++r) { for (int c=0; c<COL; ++c) { if (m_board->m_grid[r][c].pic == color) pts.insert(QPoint(r, c)); }}
-                if (!pts.isEmpty()) playEliminateAnim(pts);
+                clearCells(pts, {{CascadeResolver::ColorClear, QPoint(ROW/2, COL/2)}});
 
             } else if (skill->id == "cross_clear") {
                 int cR = QRandomGenerator::global()->bounded(ROW);
                 int cC = QRandomGenerator::global()->bounded(COL);
-                playSpecialEffect(RowBomb, QPoint(cR, cC), 0);
-                playSpecialEffect(ColBomb, QPoint(cR, cC), 0);
                 QSet<QPoint> pts;
                 for (int c=0; c<COL; ++c) if (m_board->m_grid[cR][c].pic != -1) pts.insert(QPoint(cR, c));
                 for (int r=0; r<ROW; ++r) if (m_board->m_grid[r][cC].pic != -1) pts.insert(QPoint(r, cC));
-                if (!pts.isEmpty()) playEliminateAnim(pts);
+                clearCells(pts, {{CascadeResolver::RowBomb, QPoint(cR, cC)},
+                                 {CascadeResolver::ColBomb, QPoint(cR, cC)}});
 
             } else if (skill->id == "score_double") {
                 m_scoreDoubleActive = true;
@@ -964,7 +668,6 @@ void Mode_3::on_btnSkill_clicked()
             } else if (skill->id == "color_unify") {
                 m_colorUnifyActive = true;
                 m_skillEffectTimer->start(6000);
-                playSpecialEffect(ColorClear, QPoint(0,0), 0);
                 int c1 = QRandomGenerator::global()->bounded(6);
                 int c2 = QRandomGenerator::global()->bounded(6);
                 int c3 = QRandomGenerator::global()->bounded(6);
@@ -974,27 +677,20 @@ void Mode_3::on_btnSkill_clicked()
                         }}}
                 skillMessage = "UNIFY COLOR (6s)";
                 rebuildGrid();
+                playSpecialEffect(CascadeResolver::ColorClear, QPoint(0,0), 0); // 特效放在重建之后，重建会清掉棋盘上的特效
 
             } else if (skill->id == "time_freeze") {
                 timeToAdd = 15;
                 skillMessage = "TIME FREEZE";
-                QLabel *flash = new QLabel(ui->boardWidget);
-                flash->setStyleSheet("background-color: rgba(124, 255, 203, 100);"); // 绿色冰冻
-                flash->setGeometry(ui->boardWidget->rect());
-                flash->show(); flash->setAttribute(Qt::WA_TransparentForMouseEvents);
-                QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(flash); flash->setGraphicsEffect(eff);
-                QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-                fade->setDuration(1000); fade->setStartValue(1.0); fade->setEndValue(0.0);
-                connect(fade, &QAbstractAnimation::finished, flash, &QLabel::deleteLater); fade->start();
+                m_view->playFlash(QColor(124, 255, 203, 100), 1000); // 绿色冰冻
 
             } else if (skill->id == "ultimate_burst") {
                 QSet<QPoint> pts;
                 m_ultimateBurstActive = true;
-                playSpecialEffect(ColorClear, QPoint(0,0), 0);
                 for (int r=0; r<ROW; ++r) for (int c=0; c<COL; ++c) if (m_board->m_grid[r][c].pic != -1) pts.insert(QPoint(r, c));
                 int sc = 3200; if (m_scoreDoubleActive) sc*=2;
                 m_score += sc; ui->labelScore_2->setText(QString("分数 %1").arg(m_score));
-                if (!pts.isEmpty()) playEliminateAnim(pts);
+                clearCells(pts, {{CascadeResolver::ColorClear, QPoint(0,0)}});
             }
 
             if (!skillMessage.isEmpty()) showTempMessage(skillMessage, QColor(124, 255, 203)); // 绿色文字
@@ -1049,148 +745,37 @@ void Mode_3::on_btnSkill_clicked()
 // 【新增】显示临时消息函数（Mode_3专用，绿色主题）
 void Mode_3::showTempMessage(const QString& message, const QColor& color)
 {
-    if (!ui->boardWidget) return;
-
-    QLabel* lbl = new QLabel(ui->boardWidget);
-    lbl->setText(message);
-    lbl->setAlignment(Qt::AlignCenter);
-
-    QString colorStr = QString("rgb(%1, %2, %3)").arg(color.red()).arg(color.green()).arg(color.blue());
-    lbl->setStyleSheet(
-        QString(
-            "color: %1;"
-            "font: bold 24pt 'Microsoft YaHei';"
-            "background: transparent;"
-            ).arg(colorStr)
-        );
-
-    lbl->adjustSize();
-    QRect cr = ui->boardWidget->rect();
-    lbl->move((cr.width() - lbl->width()) / 2, (cr.height() - lbl->height()) / 2);
-    lbl->show();
-    lbl->setAttribute(Qt::WA_TransparentForMouseEvents);
-
-    QGraphicsOpacityEffect* eff = new QGraphicsOpacityEffect(lbl);
-    lbl->setGraphicsEffect(eff);
-
-    QSequentialAnimationGroup* seq = new QSequentialAnimationGroup(this);
-
-    QPropertyAnimation* fadeIn = new QPropertyAnimation(eff, "opacity");
-    fadeIn->setDuration(300);
-    fadeIn->setStartValue(0.0);
-    fadeIn->setEndValue(1.0);
-    fadeIn->setEasingCurve(QEasingCurve::OutQuad);
-    seq->addAnimation(fadeIn);
-
-    seq->addPause(1500);
-
-    QPropertyAnimation* fadeOut = new QPropertyAnimation(eff, "opacity");
-    fadeOut->setDuration(300);
-    fadeOut->setStartValue(1.0);
-    fadeOut->setEndValue(0.0);
-    fadeOut->setEasingCurve(QEasingCurve::InQuad);
-    seq->addAnimation(fadeOut);
-
-    connect(seq, &QAbstractAnimation::finished, this, [lbl, seq](){
-        lbl->deleteLater();
-        seq->deleteLater();
-    });
-
-    seq->start();
+    // 快速淡入淡出，停留 1.5 秒
+    BoardView::Banner banner;
+    banner.text = message;
+    banner.color = color;
+    banner.pointSize = 24;
+    banner.fadeIn = 300;
+    banner.hold = 1500;
+    banner.fadeOut = 300;
+    m_view->showBanner(banner);
 }
 
 void Mode_3::playSpecialEffect(EffectType type, QPoint center, int colorCode)
 {
-    if (type == None || type == Normal) return;
-
-    // 重新计算坐标偏移 (确保特效位置准确)
-    int cellSize = 48; int gap = 2;
-    QRect cr = ui->boardWidget->contentsRect();
-    int totalW = COL * (cellSize + gap) - gap;
-    int totalH = ROW * (cellSize + gap) - gap;
-    int ox = cr.left() + (cr.width() - totalW) / 2;
-    int oy = cr.top()  + (cr.height() - totalH) / 2;
-
-    int centerX = ox + center.y() * (cellSize + gap) + cellSize / 2;
-    int centerY = oy + center.x() * (cellSize + gap) + cellSize / 2;
-
-    // 1. 行/列 激光炮 (改为绿色系)
-    if (type == RowBomb || type == ColBomb) {
-        QLabel *beam = new QLabel(ui->boardWidget);
-        beam->setAttribute(Qt::WA_TransparentForMouseEvents);
-        beam->show();
-
-        // 样式：中间青绿，两边透明
-        QString qss = "background: qlineargradient(x1:0, y1:0, x2:%1, y2:%2, "
-                      "stop:0 rgba(124,255,203,0), stop:0.5 rgba(200,255,235,230), stop:1 rgba(124,255,203,0));";
-
-        QPropertyAnimation *anim = new QPropertyAnimation(beam, "geometry");
-        anim->setDuration(400);
-        anim->setEasingCurve(QEasingCurve::OutExpo);
-
-        if (type == RowBomb) {
-            beam->setStyleSheet(qss.arg("0").arg("1"));
-            anim->setStartValue(QRect(ox, centerY - 2, totalW, 4));
-            anim->setEndValue(QRect(ox, centerY - 25, totalW, 50));
-        } else {
-            beam->setStyleSheet(qss.arg("1").arg("0"));
-            anim->setStartValue(QRect(centerX - 2, oy, 4, totalH));
-            anim->setEndValue(QRect(centerX - 25, oy, 50, totalH));
-        }
-
-        QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(beam);
-        beam->setGraphicsEffect(eff);
-        QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-        fade->setDuration(400);
-        fade->setStartValue(1.0);
-        fade->setEndValue(0.0);
-        fade->start(QAbstractAnimation::DeleteWhenStopped);
-
-        anim->start(QAbstractAnimation::DeleteWhenStopped);
-        connect(anim, &QAbstractAnimation::finished, beam, &QLabel::deleteLater);
+    if (type == CascadeResolver::None || type == CascadeResolver::Normal) return;
+
+    // 特效直接画在棋盘上，位置跟着格子走
+    // 1. 行/列 激光炮 (绿色系)
+    if (type == CascadeResolver::RowBomb) {
+        m_view->playBeam(Qt::Horizontal, center.x(), QColor(200, 255, 235, 230));
+    } else if (type == CascadeResolver::ColBomb) {
+        m_view->playBeam(Qt::Vertical, center.y(), QColor(200, 255, 235, 230));
     }
 
-    // 2. 区域炸弹 (冲击波 - 改为绿色)
-    else if (type == AreaBomb) {
-        QLabel *shockwave = new QLabel(ui->boardWidget);
-        shockwave->setAttribute(Qt::WA_TransparentForMouseEvents);
-        shockwave->setStyleSheet(
-            "background: qradialgradient(cx:0.5, cy:0.5, radius:0.5, fx:0.5, fy:0.5, "
-            "stop:0 rgba(0,0,0,0), stop:0.6 rgba(124, 255, 203, 180), stop:1 rgba(0,0,0,0));"
-            "border-radius: 100px;");
-        shockwave->show();
-
-        QPropertyAnimation *anim = new QPropertyAnimation(shockwave, "geometry");
-        anim->setDuration(500);
-        anim->setEasingCurve(QEasingCurve::OutQuad);
-
-        QRect startRect(centerX, centerY, 0, 0);
-        QRect endRect(centerX - 150, centerY - 150, 300, 300);
-
-        anim->setStartValue(startRect);
-        anim->setEndValue(endRect);
-        anim->start(QAbstractAnimation::DeleteWhenStopped);
-        connect(anim, &QAbstractAnimation::finished, shockwave, &QLabel::deleteLater);
+    // 2. 区域炸弹 (冲击波 - 绿色)
+    else if (type == CascadeResolver::AreaBomb) {
+        m_view->playShockwave(center.x(), center.y(), 150, QColor(124, 255, 203, 180));
     }
 
-    // 3. 全屏闪光 (改为绿色闪光)
-    else if (type == ColorClear) {
-        QLabel *flash = new QLabel(ui->boardWidget);
-        flash->setAttribute(Qt::WA_TransparentForMouseEvents);
-        flash->setStyleSheet("background-color: rgba(124, 255, 203, 120);");
-        flash->setGeometry(ui->boardWidget->rect());
-        flash->show();
-
-        QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(flash);
-        flash->setGraphicsEffect(eff);
-
-        QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-        fade->setDuration(600);
-        fade->setStartValue(1.0);
-        fade->setEndValue(0.0);
-
-        connect(fade, &QAbstractAnimation::finished, flash, &QLabel::deleteLater);
-        fade->start();
+    // 3. 全屏闪光 (绿色闪光)
+    else if (type == CascadeResolver::ColorClear) {
+        m_view->playFlash(QColor(124, 255, 203, 120), 600);
     }
 }
 
@@ -1274,6 +859,27 @@ void Mode_3::onBackButtonClicked()
     }
 }
 
+void Mode_3::on_btnSpeed_clicked()
+{
+    // 1x -> 2x -> 4x -> 瞬间 -> 1x
+    switch (qRound(m_tweens->speed())) {
+    case 1:  setPlaybackSpeed(2); break;
+    case 2:  setPlaybackSpeed(4); break;
+    case 4:  setPlaybackSpeed(0); break;
+    default: setPlaybackSpeed(1); break;
+    }
+}
+
+void Mode_3::setPlaybackSpeed(int speed)
+{
+    m_tweens->setSpeed(speed);
+    ui->btnSpeed->setText(speed == 0 ? "跳过" : QString("%1x").arg(speed));
+
+    // 切到瞬间：正在播的这一步也不再等，直接跳到结算后的棋盘
+    if (speed == 0) skipToEnd();
+}
+
+
 void Mode_3::gameOver()
 {
     m_isLocked = true;
@@ -1416,65 +1022,19 @@ void Mode_3::onSkillEffectTimeout()
 // mode_1.cpp - 新增函数：显示技能结束提示（非干扰性）
 void Mode_3::showSkillEndHint(const QString& message)
 {
-    if (!ui->boardWidget) return;
-
-    // 创建提示标签
-    QLabel* hintLabel = new QLabel(ui->boardWidget);
-    hintLabel->setText(message);
-    hintLabel->setAlignment(Qt::AlignCenter);
-
-    // 样式：半透明，不遮挡游戏内容
-    hintLabel->setStyleSheet(
-        "background-color: rgba(0, 0, 0, 180);"
-        "color: #7cffcb;"
-        "font: bold 16pt 'Microsoft YaHei';"
-        "border-radius: 8px;"
-        "border: 1px solid #7cffcb;"
-        "padding: 10px;"
-        );
-
-    // 计算位置：显示在棋盘上方，不遮挡主要内容
-    QRect boardRect = ui->boardWidget->rect();
-    int labelWidth = boardRect.width() * 0.8;  // 宽度为棋盘80%
-    int labelHeight = 50;
-    int labelX = boardRect.left() + (boardRect.width() - labelWidth) / 2;
-    int labelY = boardRect.top() + 20;  // 顶部留出空间
-
-    hintLabel->setGeometry(labelX, labelY, labelWidth, labelHeight);
-    hintLabel->show();
-    hintLabel->raise();  // 确保在最上层
-    hintLabel->setAttribute(Qt::WA_TransparentForMouseEvents);  // 鼠标穿透
-
-    // 创建淡入淡出动画
-    QGraphicsOpacityEffect* effect = new QGraphicsOpacityEffect(hintLabel);
-    hintLabel->setGraphicsEffect(effect);
-
-    QSequentialAnimationGroup* animGroup = new QSequentialAnimationGroup(this);
-
-    // 淡入 (0.5秒)
-    QPropertyAnimation* fadeIn = new QPropertyAnimation(effect, "opacity");
-    fadeIn->setDuration(500);
-    fadeIn->setStartValue(0.0);
-    fadeIn->setEndValue(1.0);
-    fadeIn->setEasingCurve(QEasingCurve::InOutQuad);
-
-    // 停留 (2秒)
-    animGroup->addAnimation(fadeIn);
-    animGroup->addPause(2000);
-
-    // 淡出 (0.5秒)
-    QPropertyAnimation* fadeOut = new QPropertyAnimation(effect, "opacity");
-    fadeOut->setDuration(500);
-    fadeOut->setStartValue(1.0);
-    fadeOut->setEndValue(0.0);
-    fadeOut->setEasingCurve(QEasingCurve::InOutQuad);
-    animGroup->addAnimation(fadeOut);
-
-    // 动画结束后清理
-    connect(animGroup, &QAbstractAnimation::finished, this, [hintLabel, animGroup]() {
-        hintLabel->deleteLater();
-        animGroup->deleteLater();
-    });
-
-    animGroup->start(QAbstractAnimation::DeleteWhenStopped);
+    // 样式：半透明框，显示在棋盘上方，不遮挡主要内容
+    BoardView::Banner banner;
+    banner.text = message;
+    banner.color = QColor("#7cffcb");  // 绿色主题
+    banner.pointSize = 16;
+    banner.boxed = true;
+    banner.border = 1;
+    banner.radius = 8;
+    banner.padding = QSize(10, 10);
+    banner.width = m_view->width() * 0.8;  // 宽度为棋盘80%
+    banner.top = 20;                        // 顶部留出空间
+    banner.fadeIn = 500;
+    banner.hold = 2000;
+    banner.fadeOut = 500;
+    m_view->showBanner(banner);
 }
@@ -2,20 +2,20 @@
 #define MODE_3_H
 
 #include <QWidget>
-#include <QSequentialAnimationGroup>
-#include <QPropertyAnimation>
-#include <QGraphicsDropShadowEffect>
 #include <QTimer>
-#include <QPushButton>
 #include <QStack>
-#include <QLabel>
+#include <QQueue>
 #include <QSet>
 #include "gameboard.h"
+#include "cascaderesolver.h"
 #include "skilltree.h"
+#include "transformindex.h"
 
 #include "musicmanager.h"
 
-class QGridLayout;
+class BoardView;
+class TweenScheduler;
+class PerfMonitor;
 
 namespace Ui { class mode_3; }
 
@@ -46,19 +46,20 @@ signals:
 
 private slots:
     void rebuildGrid();
-    void createDropAnimation(int left0, int top0);
+    void createDropAnimation();
     void onTimerTick();
     void onBackButtonClicked();
     void on_btnUndo_clicked();
     void on_btnHint_clicked();
     void on_btnSkill_clicked();
+    void on_btnSpeed_clicked(); // 播放速度 1x -> 2x -> 4x -> 瞬间
 
 private:
     Ui::mode_3 *ui;
     GameBoard *m_board;
-    QGridLayout *m_gridLayout;
-    QVector<QPushButton*> m_cells;
-    QSequentialAnimationGroup *m_dropGroup = nullptr;
+    BoardView *m_view;                    // 自绘棋盘
+    TweenScheduler *m_tweens = nullptr;   // 本棋盘全部动画，由 m_view 持有
+    PerfMonitor *m_perf = nullptr;        // 性能面板
     bool m_ultimateBurstActive = false;
     QDialog* m_skillDialog = nullptr;
 
@@ -66,32 +67,40 @@ private:
     int m_currentAnimal = -1;        // 当前随机生成的小动物类型 (0-5)
     void generateRandomAnimal();      // 生成随机小动物
     void updateAnimalDisplay();       // 更新UI显示
+    TransformIndex m_targetIndex;     // 每格变成各颜色能否成三（提示、死局判定直接查表）
 
     // 选中效果
-    QLabel *m_selectionIndicator;    // 选中指示器（单个格子）
+    enum BoardMarker { SelectionMarker };    // 选中指示器（单个格子），画在棋盘上
     int m_selectedR = -1;            // 当前选中的行
     int m_selectedC = -1;            // 当前选中的列
 
     void updateSelectionPos(QPoint mousePos); // 更新选中位置
+    void showSelection(int r, int c, bool hint = false);
     void tryTransformInteraction();            // 执行变身交互
     void processTransform(int r, int c);       // 执行变身动画
+    void commitGrid(const Grid &g);            // 写回结算结果并标记目标索引
 
     // === 通用逻辑 (保留) ===
     void clearGridLayout();
-    void performFallAnimation();
-    void checkComboMatches();
-    void playEliminateAnim(const QSet<QPoint>& points);
-
-    // 消除判定相关
-    enum EffectType { None, Normal, RowBomb, ColBomb, AreaBomb, ColorClear };
-    struct ElimResult {
-        QSet<QPoint> points;
-        EffectType type = None;
-        QPoint center = QPoint(-1, -1);
-    };
-    ElimResult getEliminations(int r, int c);
+    void clearCells(const QSet<QPoint> &points, const QVector<CascadeResolver::Effect> &effects);
+
+    // 逻辑与表现分离（同 Mode_AI）：一次操作由 CascadeResolver 立即结算到稳定，
+    // 产生的事件进队列，界面逐个消费
+    using Event = CascadeResolver::Event;
+    CascadeResolver m_resolver;
+    QQueue<Event> m_events;
+
+    void playEvents(const QVector<Event> &events);
+    void playNextEvent();
+    void playEliminateAnim(const Event &ev);
+    void performFallAnimation(const Event &ev);
+    void onBoardSettled(const Event &ev);
+    void skipToEnd();                  // 新操作到来或切到瞬间：清空队列，直接摆出最终棋盘
+    void setPlaybackSpeed(int speed);
+
+    // 消除判定在 CascadeResolver
+    using EffectType = CascadeResolver::EffectType;
     void playSpecialEffect(EffectType type, QPoint center, int colorCode);
-    int countDirection(int r, int c, int dR, int dC);
 
     // 状态管理
     void handleDeadlock();
@@ -112,7 +121,7 @@ private:
 
     // === 提示功能 ===
     int m_hintCount = 3;
-    QSequentialAnimationGroup *m_hintAnimGroup = nullptr;
+    bool m_hintActive = false;                // 指示器正在闪烁提示
     bool findValidMove(int &outR, int &outC); // 查找可消除的点击位置
     void showHint(int r, int c);              // 高亮提示位置
     void stopHint();
@@ -2,17 +2,16 @@
 #define MODE_AI_H
 
 #include <QWidget>
-#include <QSequentialAnimationGroup>
-#include <QPropertyAnimation>
-#include <QGraphicsDropShadowEffect>
 #include <QTimer>
-#include <QPushButton>
-#include <QHash>
+#include <QQueue>
 #include "gameboard.h"
 #include "musicmanager.h"
+#include "cascaderesolver.h"
+#include "aiplayer.h"
 
-// 【新增】 这里必须加前向声明，否则编译器不认识 QGridLayout
-class QGridLayout;
+class BoardView;
+class TweenScheduler;
+class PerfMonitor;
 
 namespace Ui { class Mode_AI; }
 
@@ -29,9 +28,10 @@ signals:
 
 private slots:
     void rebuildGrid();
-    void createDropAnimation(int left0, int top0);
+    void createDropAnimation();
     void onTimerTick();
     void onBackButtonClicked(); // 直接退出
+    void onSpeedButtonClicked(); // 1x -> 2x -> 4x -> 瞬间
 
     // AI 思考槽函数
     void performAIMove();
@@ -40,38 +40,31 @@ private:
     void clearGridLayout();
     Ui::Mode_AI           *ui;
     GameBoard             *m_board;
-    QGridLayout           *m_gridLayout; // 现在编译器知道这是一个类了
-    QVector<QPushButton*>  m_cells;
-    QSequentialAnimationGroup *m_dropGroup;
-
-    // 核心动画与逻辑
-    void playShake(QPushButton *btn);
-    void processInteraction(int r1, int c1, int r2, int c2);
-    void performFallAnimation();
-    void checkComboMatches();
-    void playEliminateAnim(const QSet<QPoint>& points);
+    BoardView             *m_view;        // 自绘棋盘（AI 演示不接点击）
+    TweenScheduler        *m_tweens;      // 本棋盘全部动画，由 m_view 持有
+    PerfMonitor           *m_perf;        // 性能面板
+
+    // 逻辑与表现分离：一步棋由 CascadeResolver 立即结算到稳定，
+    // 产生的事件进队列，界面按播放速度逐个消费
+    using Event = CascadeResolver::Event;
+    CascadeResolver        m_resolver;
+    QQueue<Event>          m_events;
+
+    void playNextEvent();
+    void playSwap(const Event &ev);
+    void playEliminateAnim(const Event &ev);
+    void performFallAnimation(const Event &ev);
+    void onBoardSettled(const Event &ev);
+    void skipToEnd();                  // 瞬间：清空队列，直接摆出最终棋盘
+    void setPlaybackSpeed(int speed);
+    int thinkDelay() const;
     void handleDeadlock();
 
-    // 辅助计算
-    int countDirection(int r, int c, int dR, int dC);
-
-    // 复用 Mode_1 的消除判定逻辑
-    enum EffectType { None, Normal, RowBomb, ColBomb, AreaBomb, ColorClear };
-    struct ElimResult {
-        QSet<QPoint> points;
-        EffectType type = None;
-        QPoint center = QPoint(-1, -1);
-    };
-    ElimResult getEliminations(int r, int c, const Grid& gridSnapshot);
+    using EffectType = CascadeResolver::EffectType;
     void playSpecialEffect(EffectType type, QPoint center, int colorCode);
 
-    // AI 决策数据结构
-    struct MoveChoice {
-        int r1, c1;
-        int r2, c2;
-        int score; // 权重
-    };
-    MoveChoice calculateBestMove();
+    // AI 决策（与命令行批量对局共用）
+    AiPlayer m_ai;
 
     // 状态变量
     int m_score = 0;
@@ -83,13 +76,6 @@ private:
 
     void startGameSequence();
     void addScore(int count);
-
-    int evaluatePotential(const Grid& g, const QSet<QPoint>& ignoreCells);
-
-    // 【新增】递归搜索函数：返回该分支的最高期望得分
-    // depth: 剩余搜索深度
-    // currentGrid: 当前递归层级的棋盘快照
-    int recursiveSearch(Grid currentGrid, int depth, int alpha, int beta);
 };
 
 #endif // MODE_AI_H
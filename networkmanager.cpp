@@ -3,6 +3,7 @@
 #include <QHostAddress>
 #include <QDateTime>
 #include <QDebug>
+#include "logger.h"
 #include <QJsonArray>
 
 NetworkManager* NetworkManager::m_instance = nullptr;
@@ -33,6 +34,16 @@ NetworkManager::NetworkManager(QObject *parent)
     m_heartbeatTimer = new QTimer(this);
     m_heartbeatTimer->setInterval(30000); // 30秒发送一次心跳
     connect(m_heartbeatTimer, &QTimer::timeout, this, &NetworkManager::onHeartbeatTimeout);
+    m_monoClock.start();
+
+    m_resumeTimer = new QTimer(this);
+    m_resumeTimer->setInterval(1000); // 重连期间每秒尝试一次
+    connect(m_resumeTimer, &QTimer::timeout, this, &NetworkManager::onResumeTick);
+
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(0);
+    connect(m_flushTimer, &QTimer::timeout, this, &NetworkManager::flushOutgoing);
 }
 
 NetworkManager::~NetworkManager()
@@ -52,10 +63,16 @@ bool NetworkManager::connectToServer()
 
 void NetworkManager::disconnectFromServer()
 {
+    // 主动断开不做会话恢复
+    m_sessionToken.clear();
+    m_resuming = false;
+    m_resumeTimer->stop();
+
     if (m_socket->state() == QAbstractSocket::ConnectedState) {
         if (m_isLoggedIn) {
             logout();
         }
+        flushOutgoing();   // 登出消息不能留在队列里
         m_socket->disconnectFromHost();
     }
     m_heartbeatTimer->stop();
@@ -77,24 +94,25 @@ void NetworkManager::login(const QString &username, const QString &password)
         }
     }
 
-    QJsonObject loginMsg;
-    loginMsg["type"] = "login";
-    loginMsg["username"] = username;
-    loginMsg["password"] = password;
+    Protocol::Login loginMsg;
+    loginMsg.username = username;
+    loginMsg.password = password;
+    // 按偏好排序，服务器取第一个认识的
+    loginMsg.codecs = QJsonArray{WireCodec::name(WireCodec::Cbor), WireCodec::name(WireCodec::Json)};
 
-    sendJson(loginMsg);
+    send(Protocol::MsgId::Login, loginMsg.toJson());
 }
 
 void NetworkManager::logout()
 {
     if (m_isLoggedIn && isConnected()) {
         QJsonObject logoutMsg;
-        logoutMsg["type"] = "logout";
         logoutMsg["username"] = m_username;
 
-        sendJson(logoutMsg);
+        send(Protocol::MsgId::Logout, logoutMsg);
     }
 
+    m_sessionToken.clear();
     m_isLoggedIn = false;
     m_username.clear();
     m_heartbeatTimer->stop();
@@ -104,20 +122,18 @@ void NetworkManager::requestOnlineList()
 {
     if (m_isLoggedIn && isConnected()) {
         QJsonObject requestMsg;
-        requestMsg["type"] = "get_online_list";
 
-        sendJson(requestMsg);
+        send(Protocol::MsgId::GetOnlineList, requestMsg);
     }
 }
 
 void NetworkManager::sendMatchRequest(const QString &gameMode)
 {
     if (isConnected()) {
-        QJsonObject matchMsg;
-        matchMsg["type"] = "match_request";
-        matchMsg["mode"] = gameMode;
+        Protocol::MatchRequest matchMsg;
+        matchMsg.mode = gameMode;
 
-        sendJson(matchMsg);
+        send(Protocol::MsgId::MatchRequest, matchMsg.toJson());
     }
 }
 
@@ -125,33 +141,28 @@ void NetworkManager::cancelMatchRequest()
 {
     if (isConnected()) {
         QJsonObject cancelMsg;
-        cancelMsg["type"] = "cancel_match";
 
-        sendJson(cancelMsg);
+        send(Protocol::MsgId::CancelMatch, cancelMsg);
     }
 }
 
 void NetworkManager::sendChatMessage(const QString &to, const QString &message)
 {
     if (m_isLoggedIn && isConnected()) {
-        QJsonObject chatMsg;
-        chatMsg["type"] = "chat";
-        chatMsg["to"] = to;
-        chatMsg["message"] = message;
+        Protocol::Chat chatMsg;
+        chatMsg.to = to;
+        chatMsg.message = message;
 
-        sendJson(chatMsg);
+        send(Protocol::MsgId::Chat, chatMsg.toJson());
     }
 }
 
-void NetworkManager::sendGameMove(const QString &opponent, const QJsonObject &moveData)
+void NetworkManager::sendGameMove(const Protocol::GameMove &move)
 {
     if (m_isLoggedIn && isConnected()) {
-        QJsonObject gameMsg;
-        gameMsg["type"] = "game_move";
-        gameMsg["opponent"] = opponent;
-        gameMsg["data"] = moveData;
-
-        sendJson(gameMsg);
+        // 不带操作的整盘同步只有最新一份有用，还没发出的旧快照直接丢掉；操作帧要按序号全发
+        const bool boardSync = move.op.isEmpty() && !move.board.isEmpty();
+        enqueue(Protocol::MsgId::GameMove, move.toJson(), boardSync);
     }
 }
 
@@ -159,10 +170,14 @@ void NetworkManager::sendHeartbeat()
 {
     if (m_isLoggedIn && isConnected()) {
         QJsonObject heartbeatMsg;
-        heartbeatMsg["type"] = "heartbeat";
         heartbeatMsg["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
 
-        sendJson(heartbeatMsg);
+        // 上一个心跳到现在还没回应，算丢失一次
+        if (m_pendingProbe >= 0) m_link.loss = m_link.loss * 0.875 + 0.125;
+        m_pendingProbe = m_monoClock.elapsed();
+        heartbeatMsg["t"] = double(m_pendingProbe);
+
+        send(Protocol::MsgId::Heartbeat, heartbeatMsg);
     }
 }
 
@@ -171,13 +186,12 @@ void NetworkManager::requestUserStatusUpdate(const QString &status,
                                              const QString &opponent)
 {
     if (m_isLoggedIn && isConnected()) {
-        QJsonObject statusMsg;
-        statusMsg["type"] = "user_status";
-        statusMsg["status"] = status;
-        statusMsg["game_mode"] = gameMode;
-        statusMsg["opponent"] = opponent;
+        Protocol::UserStatus statusMsg;
+        statusMsg.status = status;
+        statusMsg.gameMode = gameMode;
+        statusMsg.opponent = opponent;
 
-        sendJson(statusMsg);
+        send(Protocol::MsgId::UserStatus, statusMsg.toJson());
     }
 }
 
@@ -194,88 +208,132 @@ void NetworkManager::setServerAddress(const QString &ip, int port)
 
 void NetworkManager::onConnected()
 {
+    m_reader.clear();
+    m_codec = WireCodec::Json;
     qDebug() << "已连接到服务器:" << m_serverIP << ":" << m_serverPort;
+
+    if (m_resuming) {
+        // 重连上了：不走登录和匹配，凭令牌接回原会话
+        Protocol::Resume resumeMsg;
+        resumeMsg.username = m_username;
+        resumeMsg.token = m_sessionToken;
+        send(Protocol::MsgId::Resume, resumeMsg.toJson());
+        return;
+    }
     emit connected();
 }
 
 void NetworkManager::onDisconnected()
 {
     qDebug() << "与服务器断开连接";
+    for (QVector<QByteArray> &queue : m_outQueue) queue.clear();
+    m_outBoardSync = -1;
+    m_outBytes = 0;
+    m_flushTimer->stop();
     m_isLoggedIn = false;
-    m_username.clear();
     m_heartbeatTimer->stop();
+    m_pendingProbe = -1;
+    m_link = LinkStats();
+
+    if (m_resuming) return;   // 重连中途又断了，等下一次尝试
+    if (!m_sessionToken.isEmpty() && m_resumeGraceSecs > 0) {
+        // 意外断线：保留用户名和令牌，宽限期内自动重连
+        m_resuming = true;
+        m_resumeClock.start();
+        m_resumeTimer->start();
+        LOG_INFO("net", "连接中断，%1 秒内尝试恢复会话", m_resumeGraceSecs);
+        emit connectionLost(m_resumeGraceSecs);
+        return;
+    }
+
+    m_username.clear();
     emit disconnected();
 }
 
-// networkmanager.cpp - 修改onReadyRead函数
-void NetworkManager::onReadyRead()
+void NetworkManager::onResumeTick()
 {
-    QByteArray rawData = m_socket->readAll();
-
-    // 尝试分割多个JSON消息（有些服务器可能一次发送多个消息）
-    QString dataStr = QString::fromUtf8(rawData);
-    QStringList jsonMessages;
-
-    // 简单的JSON消息分割逻辑（按大括号匹配）
-    int braceCount = 0;
-    QString currentMessage;
-
-    for (int i = 0; i < dataStr.length(); i++) {
-        QChar ch = dataStr[i];
-        currentMessage.append(ch);
-
-        if (ch == '{') {
-            braceCount++;
-        } else if (ch == '}') {
-            braceCount--;
-            if (braceCount == 0) {
-                jsonMessages.append(currentMessage);
-                currentMessage.clear();
-            }
-        }
+    if (m_resumeClock.elapsed() > m_resumeGraceSecs * 1000) {
+        giveUpResume();
+        return;
+    }
+    emit reconnecting(m_resumeGraceSecs - int(m_resumeClock.elapsed() / 1000));
+    if (m_socket->state() == QAbstractSocket::UnconnectedState) {
+        m_socket->connectToHost(m_serverIP, m_serverPort);   // 异步，连上后在 onConnected 里发 resume
     }
+}
 
-    // 如果有未闭合的消息，也尝试处理
-    if (!currentMessage.isEmpty() && jsonMessages.isEmpty()) {
-        jsonMessages.append(dataStr);
+void NetworkManager::onResumeResult(const Protocol::ResumeResult &result)
+{
+    if (!result.success) {
+        LOG_WARN("net", "会话恢复失败：%1", result.message);
+        giveUpResume();
+        return;
     }
 
-    for (const QString &jsonStr : jsonMessages) {
-        if (jsonStr.trimmed().isEmpty()) continue;
+    m_resuming = false;
+    m_resumeTimer->stop();
+    m_isLoggedIn = true;
+    m_username = result.username;
+    m_heartbeatTimer->start();
 
-        QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(jsonStr.toUtf8(), &error);
+    WireCodec::Format codec = WireCodec::Json;
+    WireCodec::fromName(result.codec, codec);
+    m_codec = codec;
 
-        if (error.error != QJsonParseError::NoError) {
-            qDebug() << "JSON解析错误:" << error.errorString()
-                << "位置:" << error.offset
-                << "内容:" << jsonStr;
+    // 先按原顺序分发掉线期间错过的消息，再通知界面补同步
+    for (const QJsonValue &m : result.missed) processMessage(m.toObject());
 
-            // 尝试清理可能的垃圾数据
-            QString cleanedStr = jsonStr;
-            // 移除可能的空白字符
-            cleanedStr = cleanedStr.trimmed();
+    LOG_INFO("net", "会话已恢复，补收 %1 条消息", result.missed.size());
+    emit sessionResumed(true, result);
+}
 
-            // 再次尝试解析
-            doc = QJsonDocument::fromJson(cleanedStr.toUtf8(), &error);
-            if (error.error != QJsonParseError::NoError) {
-                qDebug() << "第二次解析失败，跳过此消息";
-                continue;
-            }
-        }
+void NetworkManager::giveUpResume()
+{
+    // 先断开再清标志，onDisconnected 仍按重连中处理，不会重复发 disconnected
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) m_socket->abort();
+    m_resuming = false;
+    m_resumeTimer->stop();
+    m_sessionToken.clear();
+    m_username.clear();
+
+    emit sessionResumed(false, Protocol::ResumeResult());
+    emit disconnected();
+}
 
-        if (!doc.isObject()) {
-            qDebug() << "无效的JSON格式（不是对象）";
+void NetworkManager::onReadyRead()
+{
+    // 长度前缀分帧：半帧留在缓冲区等下次 readyRead，多帧粘在一起逐个取出
+    m_reader.readFrom(m_socket);
+
+    QByteArray payload;
+    while (m_reader.next(payload)) {
+        // JSON / CBOR 按首字节自动识别，协商切换前后的帧都能解
+        QJsonObject message;
+        if (!WireCodec::decode(payload, message)) {
+            LOG_WARN("net", "消息解析错误，长度 %1", payload.size());
             continue;
         }
 
-        QJsonObject message = doc.object();
         processMessage(message);
     }
+
+    if (m_reader.hasError()) {
+        // 长度头异常，后面的字节无法再对齐，只能断开重连
+        qDebug() << "帧长度超出上限，断开连接";
+        m_reader.clear();
+        m_socket->abort();
+    }
 }
 
 void NetworkManager::onError(QAbstractSocket::SocketError socketError)
 {
+    if (m_resuming || (!m_sessionToken.isEmpty() && m_resumeGraceSecs > 0)) {
+        // 可恢复的会话：断线由 onDisconnected 转入自动重连，重连失败由计时器重试；
+        // 界面通过 connectionLost / reconnecting / sessionResumed 显示重连状态，不再弹错误框
+        qDebug() << "网络错误（自动重连处理）:" << m_socket->errorString();
+        return;
+    }
+
     QString errorMsg;
     switch (socketError) {
     case QAbstractSocket::ConnectionRefusedError:
@@ -306,116 +364,290 @@ void NetworkManager::onHeartbeatTimeout()
 
 void NetworkManager::processMessage(const QJsonObject &message)
 {
-    QString type = message["type"].toString();
-    QJsonObject data = message["data"].toObject();
+    QJsonObject data;
+    const Protocol::MsgId id = Protocol::open(message, data);
 
-    if (type == "welcome") {
+    switch (id) {
+    case Protocol::MsgId::Welcome: {
         qDebug() << "服务器欢迎消息:" << data["message"].toString();
         emit welcomeMessage(data["message"].toString());
+        break;
     }
-    else if (type == "login_result") {
-        bool success = data["success"].toBool();
-        QString msg = data["message"].toString();
+    case Protocol::MsgId::LoginResult: {
+        Protocol::LoginResult result = Protocol::LoginResult::fromJson(data);
+
+        // 服务器选中的负载格式，之后发出的消息都用它；不带或不认识就是不兼容的服务器
+        WireCodec::Format codec = WireCodec::Json;
+        if (result.success && !WireCodec::fromName(result.codec, codec)) {
+            result.success = false;
+            result.message = "服务器版本不兼容";
+            m_socket->disconnectFromHost();
+        }
 
-        if (success) {
+        if (result.success) {
             m_isLoggedIn = true;
-            m_username = data["username"].toString();
+            m_username = result.username;
             m_heartbeatTimer->start();
+            m_sessionToken = result.sessionToken;   // 为空则不做会话恢复
+            m_resumeGraceSecs = result.resumeGrace;
+            m_codec = codec;
 
-            // 请求在线列表
+            // 请求在线列表，之后的增量以这份快照为基准
+            m_presenceVersion = -1;
+            m_presenceResync = true;
             requestOnlineList();
         } else {
             m_isLoggedIn = false;
             m_username.clear();
         }
 
-        QJsonObject userData = data["user_data"].toObject();
-        emit loginResult(success, msg, userData);
+        emit loginResult(result.success, result.message, result.userData);
+        break;
+    }
+    case Protocol::MsgId::OnlineList: {
+        const Protocol::OnlineList list = Protocol::OnlineList::fromJson(data);
+        m_presenceVersion = list.version;
+        m_presenceResync = false;
+        emit onlineListUpdated(list.users);
+        break;
     }
-    else if (type == "online_list") {
-        QJsonArray users = data["users"].toArray();
-        emit onlineListUpdated(users);
+    case Protocol::MsgId::PresenceDiff: {
+        const Protocol::PresenceDiff diff = Protocol::PresenceDiff::fromJson(data);
+        // 增量必须接在手里的版本后面，断档就要快照重新对齐
+        if (diff.base != m_presenceVersion) {
+            if (!m_presenceResync) {
+                LOG_DEBUG("net", "在线表增量断档（本地 %1，增量基于 %2），请求快照", m_presenceVersion, diff.base);
+                m_presenceResync = true;
+                requestOnlineList();
+            }
+            break;
+        }
+        m_presenceVersion = diff.version;
+
+        QStringList removed;
+        for (const QJsonValue &v : diff.removed) removed.append(v.toString());
+        emit presenceChanged(diff.added, diff.updated, removed);
+        break;
     }
-    else if (type == "match_response") {
-        bool success = data["success"].toBool();
-        QString msg = data["message"].toString();
-        int queuePosition = data["queue_position"].toInt(-1);
+    case Protocol::MsgId::MatchResponse: {
+        const Protocol::MatchResponse response = Protocol::MatchResponse::fromJson(data);
 
         // 新增：发射matchResponse信号
-        emit matchResponse(success, msg, queuePosition);
+        emit matchResponse(response.success, response.message, response.queuePosition);
 
-        if (success && queuePosition > 0) {
-            emit matchQueued(queuePosition);
+        if (response.success && response.queuePosition > 0) {
+            emit matchQueued(response.queuePosition);
         }
+        break;
     }
-    else if (type == "match_found") {
-        QString player1 = data["player1"].toString();
-        QString player2 = data["player2"].toString();
-        QString roomId = data["room_id"].toString();  // 确保解析房间ID
+    case Protocol::MsgId::MatchFound: {
+        const Protocol::MatchFound match = Protocol::MatchFound::fromJson(data);
+        m_matchRoomId = match.roomId;
+        m_matchSeed = quint32(match.seed);
 
-        qDebug() << "收到匹配成功消息 - 玩家1:" << player1
-                 << "玩家2:" << player2 << "房间:" << roomId;
+        qDebug() << "收到匹配成功消息 - 玩家1:" << match.player1
+                 << "玩家2:" << match.player2 << "房间:" << match.roomId;
 
-        emit matchFound(player1, player2, roomId);  // 传递房间ID
+        emit matchFound(match.player1, match.player2, match.roomId);  // 传递房间ID
+        break;
     }
-    else if (type == "match_cancelled") {
+    case Protocol::MsgId::MatchCancelled: {
         emit matchCancelled();
+        break;
     }
-    else if (type == "chat") {
-        QString from = data["from"].toString();
-        QString messageText = data["message"].toString();
-        QString timestamp = data["timestamp"].toString();
-        emit chatMessageReceived(from, messageText, timestamp);
+    case Protocol::MsgId::Chat: {
+        const Protocol::Chat chat = Protocol::Chat::fromJson(data);
+        emit chatMessageReceived(chat.from, chat.message, chat.timestamp);
+        break;
     }
-    else if (type == "game_move") {
-        emit gameMoveReceived(message);
-        qDebug() << "处理game_move消息";
+    case Protocol::MsgId::GameMove: {
+        emit gameMoveReceived(Protocol::GameMove::fromJson(data));
+        LOG_TRACE("net", "处理game_move消息");
+        break;
     }
-    else if (type == "heartbeat_ack") {
-        // 心跳确认，无需处理
+    case Protocol::MsgId::HeartbeatAck: {
+        onHeartbeatAck(data);
+        break;
     }
-    else if (type == "system") {
+    case Protocol::MsgId::ResumeResult: {
+        onResumeResult(Protocol::ResumeResult::fromJson(data));
+        break;
+    }
+    case Protocol::MsgId::OpponentLink: {
+        emit opponentLinkChanged(data["player"].toString(), data["state"].toString(),
+                                 data["grace"].toInt());
+        break;
+    }
+    case Protocol::MsgId::System: {
         QString sysMsg = data["message"].toString();
         emit systemMessage(sysMsg);
+        break;
     }
-    else if (type == "game_start") {
+    case Protocol::MsgId::GameStart: {
         QString roomId = data["room_id"].toString();
         qDebug() << "收到游戏开始消息，房间ID:" << roomId;
         emit gameStartReceived(data);
+        break;
     }
-    else if (type == "game_end") {
+    case Protocol::MsgId::GameEnd: {
         emit gameEndReceived(data);
+        break;
     }
-    else if (type == "opponent_ready") {
+    case Protocol::MsgId::OpponentReady: {
         emit opponentReady(data);
+        break;
     }
-    else if (type == "player_quit") {  // 新增：处理玩家退出
+    case Protocol::MsgId::PlayerQuit: {  // 新增：处理玩家退出
         emit playerQuitReceived(data);
+        break;
     }
-    else if (type == "server_shutdown") {
+    case Protocol::MsgId::ServerShutdown: {
         QString shutdownMsg = data["message"].toString();
         emit serverShutdown(shutdownMsg);
+        break;
+    }
+    default:
+        break;
     }
 
     // 转发原始消息
-    emit serverMessage(type, data);
+    emit serverMessage(QString::fromLatin1(Protocol::name(id)), data);
+}
+
+void NetworkManager::onHeartbeatAck(const QJsonObject &data)
+{
+    // 旧服务器不回带时间戳；只认最近一次心跳的回应，迟到的旧回应已经按丢失算过
+    if (!data.contains("t")) return;
+    const qint64 sent = qint64(data["t"].toDouble());
+    if (sent != m_pendingProbe) return;
+    m_pendingProbe = -1;
+
+    const int rtt = int(m_monoClock.elapsed() - sent);
+    if (m_link.samples == 0) {
+        m_link.srttMs = rtt;
+        m_link.jitterMs = rtt / 2;
+    } else {
+        m_link.jitterMs = (3 * m_link.jitterMs + qAbs(m_link.srttMs - rtt)) / 4;
+        m_link.srttMs = (7 * m_link.srttMs + rtt) / 8;
+    }
+    ++m_link.samples;
+    m_link.loss *= 0.875;
+
+    emit linkStatsUpdated();
+}
+
+int NetworkManager::recommendedSyncIntervalMs() const
+{
+    const int MinIntervalMs = 100;
+    const int MaxIntervalMs = 1000;
+
+    // 还没有样本时沿用原来的 300ms
+    if (m_link.srttMs < 0) return 300;
+
+    // 比单程延迟加抖动发得还快没有意义，对手收到前就会被下一份覆盖；
+    // 丢包或发送缓冲里还有积压时再放慢，避免把链路堵死
+    qreal interval = m_link.srttMs / 2.0 + 2 * m_link.jitterMs;
+    interval *= 1.0 + 4 * m_link.loss;
+    if (m_socket->bytesToWrite() > 0) interval *= 2;
+    return qBound(MinIntervalMs, qRound(interval), MaxIntervalMs);
+}
+
+void NetworkManager::setRttProbing(bool on)
+{
+    m_heartbeatTimer->setInterval(on ? 2000 : 30000);
+    if (!m_isLoggedIn) return;
+    m_heartbeatTimer->start();
+    if (on) sendHeartbeat();   // 立即取一个样本
+}
+
+void NetworkManager::send(Protocol::MsgId id, const QJsonObject &data)
+{
+    enqueue(id, data, false);
+}
+
+NetworkManager::SendClass NetworkManager::sendClassOf(Protocol::MsgId id)
+{
+    switch (id) {
+    case Protocol::MsgId::Login:
+    case Protocol::MsgId::Logout:
+    case Protocol::MsgId::Heartbeat:     // 排在后面会把排队时间算进 RTT
+    case Protocol::MsgId::Resume:
+        return SendControl;
+    case Protocol::MsgId::GameStart:
+    case Protocol::MsgId::GameMove:
+    case Protocol::MsgId::GameEnd:
+    case Protocol::MsgId::PlayerQuit:
+    case Protocol::MsgId::MatchRequest:
+    case Protocol::MsgId::CancelMatch:
+        return SendGame;
+    default:
+        return SendBulk;                 // 聊天、状态、在线列表
+    }
 }
 
-void NetworkManager::sendJson(const QJsonObject &json)
+void NetworkManager::enqueue(Protocol::MsgId id, const QJsonObject &data, bool supersedable)
 {
     if (!isConnected()) {
-        qDebug() << "发送失败：未连接到服务器";
+        LOG_WARN("net", "发送失败：未连接到服务器");
         return;
     }
 
-    QJsonDocument doc(json);
-    QByteArray data = doc.toJson(QJsonDocument::Compact);
+    // 入队时就编码：协商的格式在同一轮事件循环里不会变
+    const QJsonObject message = Protocol::envelope(id, data);
+    QByteArray frame = FrameCodec::encode(WireCodec::encode(message, m_codec));
+
+    LOG_DEBUG("net", "发送 %1 %2 %3 字节", Protocol::name(id), WireCodec::name(m_codec), frame.size());
+    LOG_TRACE("net", "发送内容 %1", message);
+
+    QVector<QByteArray> &queue = m_outQueue[sendClassOf(id)];
+    if (supersedable && m_outBoardSync >= 0) {
+        // 旧快照丢掉，新的一份排到队尾：它是排在后面的操作帧都生效之后的棋盘，放回旧位置会被它们反超
+        LOG_TRACE("net", "丢弃未发出的整盘同步");
+        m_outBytes -= queue[m_outBoardSync].size();
+        queue.remove(m_outBoardSync);
+    }
+    if (supersedable) m_outBoardSync = queue.size();
+    m_outBytes += frame.size();
+    queue.append(std::move(frame));
+
+    if (!m_flushTimer->isActive()) m_flushTimer->start();
+}
 
-    // 【添加调试信息】打印发送的JSON内容
-    QString jsonStr = QString::fromUtf8(data);
-    qDebug() << "发送JSON:" << jsonStr;
+void NetworkManager::flushOutgoing()
+{
+    m_flushTimer->stop();
+    if (m_outBytes == 0) return;
+
+    // 各类别依次拼进一块缓冲，一次 write：同一轮里的消息尽量落在同一个 TCP 段里
+    QByteArray batch;
+    batch.reserve(int(m_outBytes));
+    int count = 0;
+    for (QVector<QByteArray> &queue : m_outQueue) {
+        for (const QByteArray &frame : queue) batch.append(frame);
+        count += queue.size();
+        queue.clear();
+    }
+    m_outBoardSync = -1;
+    m_outBytes = 0;
+
+    if (!isConnected()) return;
+    LOG_TRACE("net", "合并发送 %1 条消息，%2 字节", count, batch.size());
+    m_socket->write(batch);
+}
+
+int NetworkManager::pendingOutgoingMessages() const
+{
+    int count = 0;
+    for (const QVector<QByteArray> &queue : m_outQueue) count += queue.size();
+    return count;
+}
 
-    m_socket->write(data);
+int NetworkManager::pendingIncomingMessages() const
+{
+    int partial = 0;
+    const int frames = m_reader.pendingFrames(&partial);
+    // 套接字里还没读进来的字节至多属于正在收的那一帧之后的若干帧，数不出来，按一条算
+    return frames + ((partial > 0 || m_socket->bytesAvailable() > 0) ? 1 : 0);
 }
 
 // networkmanager.cpp - 实现状态更新方法
@@ -424,14 +656,13 @@ void NetworkManager::updateUserStatus(const QString &status,
                                       const QString &opponent)
 {
     if (isConnected()) {
-        QJsonObject statusMsg;
-        statusMsg["type"] = "user_status";
-        statusMsg["status"] = status;
-        statusMsg["game_mode"] = gameMode;
-        statusMsg["opponent"] = opponent;
-        statusMsg["username"] = m_username;
+        Protocol::UserStatus statusMsg;
+        statusMsg.status = status;
+        statusMsg.gameMode = gameMode;
+        statusMsg.opponent = opponent;
+        statusMsg.username = m_username;
 
-        sendJson(statusMsg);
+        send(Protocol::MsgId::UserStatus, statusMsg.toJson());
 
         qDebug() << "发送状态更新:" << m_username << "->" << status << "模式:" << gameMode;
     } else {
@@ -443,52 +674,20 @@ void NetworkManager::updateUserStatus(const QString &status,
 void NetworkManager::sendGameStart(const QString &roomId, const QJsonArray &board, int score)
 {
     QJsonObject gameStartMsg;
-    gameStartMsg["type"] = "game_start";
     gameStartMsg["room_id"] = roomId;
     gameStartMsg["board"] = board;
     gameStartMsg["score"] = score;
     gameStartMsg["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
 
-    sendJson(gameStartMsg);
-}
-
-void NetworkManager::sendGameMove(const QString &roomId, const QJsonArray &board, int score)
-{
-    QJsonObject gameMoveMsg;
-    gameMoveMsg["type"] = "game_move";
-    gameMoveMsg["room_id"] = roomId;
-    gameMoveMsg["board"] = board;
-    gameMoveMsg["score"] = score;
-    gameMoveMsg["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-
-    sendJson(gameMoveMsg);
+    send(Protocol::MsgId::GameStart, gameStartMsg);
 }
 
 void NetworkManager::sendGameEnd(const QString &roomId, int finalScore)
 {
     QJsonObject gameEndMsg;
-    gameEndMsg["type"] = "game_end";
     gameEndMsg["room_id"] = roomId;
     gameEndMsg["final_score"] = finalScore;
     gameEndMsg["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
 
-    sendJson(gameEndMsg);
-}
-
-// 添加一个新的公共方法，用于发送任意JSON
-void NetworkManager::sendRawJson(const QJsonObject &json)
-{
-    if (!isConnected()) {
-        qDebug() << "未连接到服务器，无法发送消息";
-        return;
-    }
-
-    QJsonDocument doc(json);
-    QByteArray data = doc.toJson(QJsonDocument::Compact);
-
-    QString jsonStr = QString::fromUtf8(data);
-    qDebug() << "发送原始JSON:" << jsonStr;
-
-    m_socket->write(data);
-    m_socket->flush();
+    send(Protocol::MsgId::GameEnd, gameEndMsg);
 }
@@ -7,6 +7,11 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QVector>
+#include "framecodec.h"
+#include "wirecodec.h"
+#include "protocol.h"
 
 class NetworkManager : public QObject
 {
@@ -25,7 +30,7 @@ public:
     void sendMatchRequest(const QString &gameMode);
     void cancelMatchRequest();
     void sendChatMessage(const QString &to, const QString &message);
-    void sendGameMove(const QString &opponent, const QJsonObject &moveData);
+    void sendGameMove(const Protocol::GameMove &move);
     void sendHeartbeat();
     void requestUserStatusUpdate(const QString &status,
                                  const QString &gameMode = "",
@@ -38,10 +43,34 @@ public:
     int getServerPort() const { return m_serverPort; }
     void setServerAddress(const QString &ip, int port);
 
+    // 最近一次匹配成功时服务器下发的房间号和局种子（旧服务器不带种子时为 0）
+    QString matchRoomId() const { return m_matchRoomId; }
+    quint32 matchSeed() const { return m_matchSeed; }
+
     void sendGameStart(const QString &roomId, const QJsonArray &board, int score);
-    void sendGameMove(const QString &roomId, const QJsonArray &board, int score);
     void sendGameEnd(const QString &roomId, int finalScore);
-    void sendRawJson(const QJsonObject &json);
+    // 发任意消息：data 是负载，信封（编号、名字）由 Protocol 统一加
+    void send(Protocol::MsgId id, const QJsonObject &data = QJsonObject());
+
+    // 链路质量：心跳带单调时钟时间戳，服务器原样回带；RTT 和抖动按 RFC 6298 平滑
+    struct LinkStats {
+        int srttMs = -1;          // 平滑 RTT，-1 表示还没有样本
+        int jitterMs = 0;         // RTT 平均偏差
+        qreal loss = 0;           // 心跳丢失率（指数平滑，0~1）
+        int samples = 0;
+    };
+    LinkStats linkStats() const { return m_link; }
+    // 整盘同步的最小间隔：随 RTT、抖动、丢包和发送积压调整
+    int recommendedSyncIntervalMs() const;
+    // 对局中加密心跳，让 RTT 跟得上链路变化；对局外回到 30 秒
+    void setRttProbing(bool on);
+
+    // 性能面板用：尚未发出（含发送队列里还没写进套接字的）/ 尚未处理（含收了一半的帧）的字节数
+    qint64 pendingOutgoingBytes() const { return m_socket->bytesToWrite() + m_outBytes; }
+    qint64 pendingIncomingBytes() const { return m_socket->bytesAvailable() + m_reader.buffered(); }
+    // 同上，按消息数：发送队列里还没写进套接字的消息 / 接收缓冲里的完整帧加上正在收的半帧
+    int pendingOutgoingMessages() const;
+    int pendingIncomingMessages() const;
 
 signals:
     void connected();
@@ -49,13 +78,15 @@ signals:
     void connectionError(const QString &error);
 
     void loginResult(bool success, const QString &message, const QJsonObject &userData);
-    void onlineListUpdated(const QJsonArray &users);
+    void onlineListUpdated(const QJsonArray &users);   // 全量快照：登录后、增量断档后
+    // 在线表增量，版本已校验连续；断档时这里不发，先要一份快照
+    void presenceChanged(const QJsonArray &added, const QJsonArray &updated, const QStringList &removed);
     void matchResponse(bool success, const QString &message, int queuePosition = -1); // 新增
     void matchQueued(int queuePosition);
     void matchFound(const QString &player1, const QString &player2, const QString &roomId);  // 添加roomId
     void matchCancelled();
     void chatMessageReceived(const QString &from, const QString &message, const QString &timestamp);
-    void gameMoveReceived(const QJsonObject &moveData);
+    void gameMoveReceived(const Protocol::GameMove &move);
     void serverMessage(const QString &type, const QJsonObject &data);
     void systemMessage(const QString &message);
     void serverShutdown(const QString &message);
@@ -66,6 +97,13 @@ signals:
     void gameEndReceived(const QJsonObject &data);           // 游戏结束信号
     void opponentReady(const QJsonObject &data);            // 对手准备就
     void playerQuitReceived(const QJsonObject &data);  // 新增：玩家退出信号
+    void linkStatsUpdated();                           // 收到一次心跳回应后发出
+
+    // 会话恢复：意外断线后在宽限期内自动重连，凭令牌接回原对局
+    void connectionLost(int graceSecs);                // 开始自动重连
+    void reconnecting(int secsLeft);                   // 重连期间每次尝试前发出，界面据此显示倒计时
+    void sessionResumed(bool success, const Protocol::ResumeResult &result);  // 带房间快照；错过的消息已先行分发
+    void opponentLinkChanged(const QString &player, const QString &state, int graceSecs);
 
 private slots:
     void onConnected();
@@ -73,20 +111,47 @@ private slots:
     void onReadyRead();
     void onError(QAbstractSocket::SocketError socketError);
     void onHeartbeatTimeout();
+    void onResumeTick();
+    void flushOutgoing();
 
 private:
+    // 发送优先级：同一轮事件循环里攒下的消息按类别先后合并成一次写入
+    enum SendClass { SendControl, SendGame, SendBulk, SendClassCount };
+    static SendClass sendClassOf(Protocol::MsgId id);
+    void enqueue(Protocol::MsgId id, const QJsonObject &data, bool supersedable);
+
     explicit NetworkManager(QObject *parent = nullptr);
     ~NetworkManager();
 
     void processMessage(const QJsonObject &message);
-    void sendJson(const QJsonObject &json);
+    void onHeartbeatAck(const QJsonObject &data);
+    void onResumeResult(const Protocol::ResumeResult &result);
+    void giveUpResume();
 
     QTcpSocket *m_socket;
+    FrameReader m_reader;                 // 接收缓冲区，跨 readyRead 保留半帧
+    WireCodec::Format m_codec = WireCodec::Json;  // 登录时与服务器协商，断线重连回到 JSON
+    QVector<QByteArray> m_outQueue[SendClassCount];  // 已编码加帧头的待发消息
+    int m_outBoardSync = -1;              // 队列里尚未发出的整盘同步位置，新的一份来了就丢掉它、排到队尾
+    qint64 m_outBytes = 0;
+    QTimer *m_flushTimer;                 // 0 间隔单次定时器：本轮事件循环结束时统一写出
     QTimer *m_heartbeatTimer;
+    QElapsedTimer m_monoClock;            // 心跳时间戳用单调时钟，不受系统改时间影响
+    qint64 m_pendingProbe = -1;           // 尚未收到回应的心跳时间戳
+    LinkStats m_link;
+    QString m_sessionToken;               // 登录时服务器下发，主动登出/断开时清掉
+    int m_resumeGraceSecs = 0;
+    bool m_resuming = false;
+    QTimer *m_resumeTimer;
+    QElapsedTimer m_resumeClock;
     QString m_username;
     QString m_serverIP;
     int m_serverPort;
     bool m_isLoggedIn;
+    QString m_matchRoomId;
+    quint32 m_matchSeed = 0;
+    qint64 m_presenceVersion = -1;        // 手里在线表的版本，-1 表示还没有快照
+    bool m_presenceResync = false;        // 已经要了快照，等它回来之前的增量都丢掉
 
     static NetworkManager* m_instance;
 };
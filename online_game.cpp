@@ -4,15 +4,16 @@
 #include "skilltree.h"
 #include "networkmanager.h"
 #include "musicmanager.h"  // 【新增】音乐管理头文件
+#include "boardview.h"
+#include "tweenscheduler.h"
+#include "perfmonitor.h"
+#include "matchsync.h"
+#include "boardcodec.h"
+#include "logger.h"
 
 #include <QGridLayout>
 #include <QPushButton>
 #include <QDir>
-#include <QSequentialAnimationGroup>
-#include <QParallelAnimationGroup>
-#include <QPropertyAnimation>
-#include <QGraphicsOpacityEffect>
-#include <QGraphicsDropShadowEffect>
 #include <QRandomGenerator>
 #include <QLabel>
 #include <QDebug>
@@ -49,6 +50,14 @@ OnlineGame::OnlineGame(const QString &myUsername, const QString &opponentUsernam
     , m_myColorUnifyActive(false)
     , m_myUltimateBurstActive(false)
     , m_mySkillTree(nullptr)
+    , m_lockstep(false)
+    , m_myResolver(nullptr)
+    , m_opponentResolver(nullptr)
+    , m_mySeq(0)
+    , m_opponentSeq(0)
+    , m_snapshotRequested(false)
+    , m_awaitingSnapshot(false)
+    , m_opponentBacklogMs(0)
     // 【新增】同步状态初始化
     , m_lastSyncedScore(-1)  // 初始化为-1，确保第一次同步会发送
     , m_hasInitialSync(false)
@@ -69,18 +78,46 @@ OnlineGame::OnlineGame(const QString &myUsername, const QString &opponentUsernam
     m_myBoard = new GameBoard(this);
     m_opponentBoard = new GameBoard(this);
 
-    // 初始化布局
-    m_myGridLayout = new QGridLayout(ui->myBoardContainer);
-    m_myGridLayout->setSpacing(2);
-    m_myGridLayout->setContentsMargins(4, 4, 4, 4);
+    // 有局种子就走确定性同步：开局棋盘由种子决定，对手棋盘在本地推演
+    NetworkManager *nm = NetworkManager::instance();
+    const quint32 matchSeed = nm ? nm->matchSeed() : 0;
+    m_lockstep = matchSeed != 0;
+    if (m_lockstep) {
+        m_myRng.seed(MatchSync::playerSeed(matchSeed, m_myUsername));
+        m_opponentRng.seed(MatchSync::playerSeed(matchSeed, m_opponentUsername));
+        m_roomId = nm->matchRoomId();
+    } else {
+        m_myRng.seed(QRandomGenerator::global()->generate());
+    }
+    m_myBoard->setRandomGenerator(&m_myRng);
+    m_opponentBoard->setRandomGenerator(&m_opponentRng);
+    m_myResolver = new CascadeResolver(m_myBoard, &m_myRng);
+    m_opponentResolver = new CascadeResolver(m_opponentBoard, &m_opponentRng);
+
+    // 我方棋盘：一个自绘控件，点击由棋盘命中后转发
+    m_myView = new BoardView(ui->myBoardContainer);
+    QVBoxLayout *myLayout = new QVBoxLayout(ui->myBoardContainer);
+    myLayout->setContentsMargins(0, 0, 0, 0);
+    myLayout->addWidget(m_myView);
+    m_myTweens = m_myView->tweens();
+    connect(m_myView, &BoardView::cellClicked, this, [this](int r, int c) {
+        if (!m_isGameActive || m_myLocked || m_myPaused) return;
+        handleMyCellClick(r, c);
+    });
 
-    m_opponentGridLayout = new QGridLayout(ui->opponentBoardContainer);
-    m_opponentGridLayout->setSpacing(2);
-    m_opponentGridLayout->setContentsMargins(4, 4, 4, 4);
+    // 对手棋盘只做展示：同样整盘自绘，不接收鼠标
+    m_opponentView = new BoardView(ui->opponentBoardContainer);
+    m_opponentView->setAttribute(Qt::WA_TransparentForMouseEvents, true);
+    QVBoxLayout *opponentLayout = new QVBoxLayout(ui->opponentBoardContainer);
+    opponentLayout->setContentsMargins(0, 0, 0, 0);
+    opponentLayout->addWidget(m_opponentView);
 
-    // 初始化动画组
-    m_myDropGroup = new QSequentialAnimationGroup(this);
-    m_opponentDropGroup = new QSequentialAnimationGroup(this);
+    // 性能面板（F3 显示，F4 记录 CSV），两块棋盘的动画都计入
+    m_perf = new PerfMonitor(this, "online");
+    m_perf->watch(m_myTweens);
+    m_perf->watch(m_opponentView->tweens());
+    m_perf->watch(m_myResolver);
+    m_perf->watch(m_opponentResolver);
 
     // 初始化技能计时器
     m_mySkillEffectTimer = new QTimer(this);
@@ -92,15 +129,16 @@ OnlineGame::OnlineGame(const QString &myUsername, const QString &opponentUsernam
     m_gameTimer->setInterval(1000);
     connect(m_gameTimer, &QTimer::timeout, this, &OnlineGame::onGameTimerTick);
 
-    // 初始化同步计时器
+    // 同步尾部补发：间隔内的变化不丢，间隔结束时补发最新状态
     m_syncTimer = new QTimer(this);
-    m_syncTimer->setInterval(1000);
+    m_syncTimer->setSingleShot(true);
     connect(m_syncTimer, &QTimer::timeout, this, &OnlineGame::syncMyBoard);
 
     // 连接按钮信号
     connect(ui->btnBack, &QPushButton::clicked, this, &OnlineGame::on_btnBack_clicked);
     connect(ui->btnMyUndo, &QPushButton::clicked, this, &OnlineGame::on_btnMyUndo_clicked);
     connect(ui->btnMySkill, &QPushButton::clicked, this, &OnlineGame::on_btnMySkill_clicked);
+    connect(ui->btnMySpeed, &QPushButton::clicked, this, &OnlineGame::onMySpeedButtonClicked);
 
     // 连接网络消息
     NetworkManager *networkManager = NetworkManager::instance();
@@ -111,8 +149,16 @@ OnlineGame::OnlineGame(const QString &myUsername, const QString &opponentUsernam
                 this, &OnlineGame::onGameStartReceived);
         connect(networkManager, &NetworkManager::gameEndReceived,
                 this, &OnlineGame::onGameEndReceived);
+        connect(networkManager, &NetworkManager::linkStatsUpdated,
+                this, &OnlineGame::updateLinkStats);
         connect(networkManager, &NetworkManager::playerQuitReceived,  // 新增
                 this, &OnlineGame::onPlayerQuitReceived);
+        connect(networkManager, &NetworkManager::connectionLost,
+                this, &OnlineGame::onConnectionLost);
+        connect(networkManager, &NetworkManager::sessionResumed,
+                this, &OnlineGame::onSessionResumed);
+        connect(networkManager, &NetworkManager::opponentLinkChanged,
+                this, &OnlineGame::onOpponentLinkChanged);
     }
 
     // 初始化UI
@@ -133,6 +179,7 @@ OnlineGame::OnlineGame(const QString &myUsername, const QString &opponentUsernam
     // 更新网络状态
     if (networkManager && networkManager->isConnected()) {
         networkManager->updateUserStatus("联机游戏中", "闪电", opponentUsername);
+        networkManager->setRttProbing(true);
     }
 
     // 设置窗口标志
@@ -141,6 +188,9 @@ OnlineGame::OnlineGame(const QString &myUsername, const QString &opponentUsernam
 
 OnlineGame::~OnlineGame()
 {
+    if (NetworkManager *networkManager = NetworkManager::instance()) networkManager->setRttProbing(false);
+    delete m_myResolver;
+    delete m_opponentResolver;
     delete ui;
 }
 
@@ -160,58 +210,10 @@ void OnlineGame::initMyBoard()
 void OnlineGame::rebuildMyGrid()
 {
     clearMyGridLayout();
-    m_myCells.resize(ROW * COL);
-    const Grid &gr = m_myBoard->grid();
-
-    // 【关键修复】使用与 mode_1 完全相同的棋盘布局参数
-    QRect cr = ui->myBoardContainer->contentsRect();
-    int availW = cr.width();
-    int availH = cr.height();
-
-    // 与 mode_1 完全相同的参数
-    int cellSize = 48;
-    int gap = 2;
-    int totalW = COL * (cellSize + gap) - gap;  // 8*50 - 2 = 400 - 2 = 398
-    int totalH = ROW * (cellSize + gap) - gap;  // 8*50 - 2 = 400 - 2 = 398
-
-    int ox = cr.left() + (availW - totalW) / 2;
-    int oy = cr.top() + (availH - totalH) / 2;
-
-    for (int r = 0; r < ROW; ++r) {
-        for (int c = 0; c < COL; ++c) {
-            QPushButton *btn = new QPushButton(ui->myBoardContainer);
-            btn->setFixedSize(cellSize, cellSize);
-            btn->setStyleSheet("border:none;");
-
-            // 修复图片路径
-            QString path = getCellImagePath(gr[r][c].pic);
-            btn->setIcon(QIcon(path));
-            btn->setIconSize(QSize(cellSize, cellSize));
-
-            int targetX = ox + c * (cellSize + gap);
-            int targetY = oy + r * (cellSize + gap);
-
-            // 初始位置：从顶部上方
-            btn->move(targetX, targetY - (ROW - r) * (cellSize + gap));
-
-            // 设置透明度效果
-            auto *eff = new QGraphicsOpacityEffect(btn);
-            eff->setOpacity(0.0);
-            btn->setGraphicsEffect(eff);
-            btn->show();
-
-            m_myCells[r * COL + c] = btn;
-
-            // 连接点击信号
-            connect(btn, &QPushButton::clicked, this, [this, r, c]() {
-                if (!m_isGameActive || m_myLocked || m_myPaused) return;
-                handleMyCellClick(r, c);
-            });
-        }
-    }
+    m_myView->setGrid(m_myBoard->grid());
 
     // 创建下落动画
-    createMyDropAnimation(ox, oy);
+    createMyDropAnimation();
 }
 
 void OnlineGame::clearMyGridLayout()
@@ -221,96 +223,27 @@ void OnlineGame::clearMyGridLayout()
         m_mySkillEffectTimer->stop();
     }
 
-    if (m_myDropGroup) {
-        m_myDropGroup->stop();
-        m_myDropGroup->clear();
-    }
-
-    // 清理按钮
-    for (QPushButton *b : m_myCells) {
-        if (b) {
-            delete b;
-        }
-    }
-    m_myCells.clear();
-
-    // 清理布局
-    if (m_myGridLayout && ui->myBoardContainer) {
-        QLayoutItem *item;
-        while ((item = m_myGridLayout->takeAt(0)) != nullptr) {
-            if (item->widget()) {
-                delete item->widget();
-            }
-            delete item;
-        }
-    }
+    m_myTweens->stop();
+    m_myView->removeMarker(MySelectMarker);
+    m_myClickCount = 0;
+    m_myEvents.clear();   // 没播完的事件作废，棋盘数据已是结算后的状态
 }
 
-void OnlineGame::createMyDropAnimation(int left0, int top0)
+void OnlineGame::createMyDropAnimation()
 {
-    if (m_myDropGroup->state() == QAbstractAnimation::Running) {
-        m_myDropGroup->stop();
-    }
-    m_myDropGroup->clear();
-
-    int cellSize = 48;
-    int gap = 2;
-
-    for (int r = ROW - 1; r >= 0; --r) {
-        auto *rowPar = new QParallelAnimationGroup(this);
-        for (int c = 0; c < COL; ++c) {
-            QPushButton *btn = m_myCells[r * COL + c];
-            if (!btn) continue;
-
-            auto *eff = qobject_cast<QGraphicsOpacityEffect*>(btn->graphicsEffect());
-            if (!eff) {
-                eff = new QGraphicsOpacityEffect(btn);
-                btn->setGraphicsEffect(eff);
-            }
-
-            int targetX = left0 + c * (cellSize + gap);
-            int targetY = top0 + r * (cellSize + gap);
-
-            // 下落动画
-            auto *drop = new QPropertyAnimation(btn, "pos");
-            drop->setDuration(180 + (ROW - 1 - r) * 15);
-            drop->setStartValue(QPoint(targetX, targetY - 200));
-            drop->setEndValue(QPoint(targetX, targetY));
-            drop->setEasingCurve(QEasingCurve::OutBounce);
-
-            // 淡入动画
-            auto *fade = new QPropertyAnimation(eff, "opacity");
-            fade->setDuration(300);
-            fade->setStartValue(0.0);
-            fade->setEndValue(1.0);
-
-            auto *cellAnim = new QParallelAnimationGroup(this);
-            cellAnim->addAnimation(drop);
-            cellAnim->addAnimation(fade);
-            rowPar->addAnimation(cellAnim);
-        }
-        m_myDropGroup->addAnimation(rowPar);
-        m_myDropGroup->addPause(1);
-    }
-
-    connect(m_myDropGroup, &QSequentialAnimationGroup::finished, this, [this]() {
-        // 动画完成后将按钮添加到网格布局
-        for (int r = 0; r < ROW; ++r) {
-            for (int c = 0; c < COL; ++c) {
-                QPushButton *btn = m_myCells[r * COL + c];
-                if (btn) m_myGridLayout->addWidget(btn, r, c);
-            }
-        }
+    // 从 200px 高处逐行落下，每行 300ms 再停 1ms，下一行才开始
+    m_myView->playDropIn(200, 300 + 1, [this]() {
         m_myLocked = false;
 
         // 如果是第一次启动，播放开始动画
         if (!m_isGameStarted) {
             m_isGameStarted = true;
             startGameSequence();
+        } else {
+            // 洗牌、撤步后的整盘重建：此时才解锁，补发同步
+            syncMyBoard();
         }
     });
-
-    m_myDropGroup->start();
 }
 
 // =============== 棋盘交互逻辑 ===============
@@ -318,319 +251,114 @@ void OnlineGame::handleMyCellClick(int r, int c)
 {
     if (m_myLocked || m_myPaused) return;
 
-    QPushButton *btn = m_myCells[r * COL + c];
-
     if (m_myClickCount == 0) {
         // 第一次点击：选择
         m_mySelR = r;
         m_mySelC = c;
-        setMySelected(btn, true);
+        setMySelected(r, c, true);
         m_myClickCount = 1;
         return;
     }
 
-    // 第二次点击：尝试交换
-    QPushButton *firstBtn = m_myCells[m_mySelR * COL + m_mySelC];
-
     // 检查是否相邻
     if (qAbs(m_mySelR - r) + qAbs(m_mySelC - c) != 1) {
         // 不相邻，重新选择
-        setMySelected(firstBtn, false);
         m_mySelR = r;
         m_mySelC = c;
-        setMySelected(btn, true);
+        setMySelected(r, c, true);
         return;
     }
 
-    // 检查是否可以交换
+    // 第二次点击：上一步还没播完就先快进到结算后的棋盘，再检查是否可以交换
+    skipMyEventsToEnd();
     bool ok = m_myBoard->trySwap(m_mySelR, m_mySelC, r, c);
-    setMySelected(firstBtn, false);
+    setMySelected(m_mySelR, m_mySelC, false);
     m_myClickCount = 0;
 
     if (!ok) {
         // 不可交换，抖动效果
-        playMyShake(firstBtn);
-        playMyShake(btn);
+        m_myView->playShake(m_mySelR, m_mySelC);
+        m_myView->playShake(r, c);
     } else {
         // 保存状态
         saveMyState();
 
-        // 在逻辑上交换
-        std::swap(m_myBoard->m_grid[m_mySelR][m_mySelC].pic,
-                  m_myBoard->m_grid[r][c].pic);
+        Protocol::GameMove op;
+        op.op = "swap";
+        op.mv = QJsonArray{m_mySelR, m_mySelC, r, c};
+        queueMyOp(op);
 
-        // 处理交互
+        // 交换 + 连消一次结算完，再按事件播放
         processMyInteraction(m_mySelR, m_mySelC, r, c);
     }
 }
 
-void OnlineGame::setMySelected(QPushButton *btn, bool on)
+void OnlineGame::setMySelected(int r, int c, bool on)
 {
     if (on) {
-        auto *shadow = new QGraphicsDropShadowEffect(btn);
-        shadow->setColor(QColor("#00e5ff"));  // 蓝色光晕
-        shadow->setBlurRadius(12);
-        shadow->setOffset(0, 0);
-        btn->setGraphicsEffect(shadow);
+        BoardView::Marker m;
+        m.cells = QRect(c, r, 1, 1);
+        m.color = QColor("#00e5ff");  // 蓝色光晕
+        m.width = 0;
+        m.margin = 0;
+        m.glow = true;
+        m_myView->setMarker(MySelectMarker, m);
     } else {
-        btn->setGraphicsEffect(nullptr);
+        m_myView->removeMarker(MySelectMarker);
     }
 }
 
-void OnlineGame::playMyShake(QPushButton *btn)
-{
-    auto *anim = new QPropertyAnimation(btn, "pos");
-    QPoint p = btn->pos();
-    anim->setDuration(120);
-    anim->setKeyValueAt(0, p);
-    anim->setKeyValueAt(0.25, p - QPoint(4, 0));
-    anim->setKeyValueAt(0.75, p + QPoint(4, 0));
-    anim->setKeyValueAt(1, p);
-    anim->start(QAbstractAnimation::DeleteWhenStopped);
-}
-
 void OnlineGame::processMyInteraction(int r1, int c1, int r2, int c2)
 {
-    m_myLocked = true;
-
-    // 获取消除结果
-    ElimResult res1 = getMyEliminations(r1, c1);
-    ElimResult res2 = getMyEliminations(r2, c2);
-
-    QSet<QPoint> allToRemove = res1.points;
-    allToRemove.unite(res2.points);
-
-    // 如果没有消除，回滚
-    if (allToRemove.isEmpty()) {
-        std::swap(m_myBoard->m_grid[r1][c1].pic, m_myBoard->m_grid[r2][c2].pic);
-        playMyShake(m_myCells[r1 * COL + c1]);
-        playMyShake(m_myCells[r2 * COL + c2]);
-        m_myLocked = false;
+    // 和对手端推演走同一个结算器、同一条随机数流，双方结果逐格一致
+    Grid g = m_myBoard->grid();
+    const QVector<CascadeResolver::Event> events = m_myResolver->resolveSwap(g, r1, c1, r2, c2);
+
+    // 只有 交换 + 稳定 两个事件 = 没有消除：数据不动，抖动提示
+    if (events.size() == 2) {
+        m_myView->playShake(r1, c1);
+        m_myView->playShake(r2, c2);
+        m_myPendingOp = Protocol::GameMove();
+        if (!m_myUndoStack.isEmpty()) m_myUndoStack.pop();   // 没换成，撤步记录也不留
         return;
     }
 
-    // 视觉交换动画
-    int idx1 = r1 * COL + c1;
-    int idx2 = r2 * COL + c2;
-    QPushButton *btn1 = m_myCells[idx1];
-    QPushButton *btn2 = m_myCells[idx2];
-
-    // 交换单元格指针
-    std::swap(m_myCells[idx1], m_myCells[idx2]);
-
-    QParallelAnimationGroup *swapGroup = new QParallelAnimationGroup(this);
-
-    QPropertyAnimation *anim1 = new QPropertyAnimation(btn1, "pos");
-    anim1->setDuration(300);
-    anim1->setStartValue(btn1->pos());
-    anim1->setEndValue(btn2->pos());
-
-    QPropertyAnimation *anim2 = new QPropertyAnimation(btn2, "pos");
-    anim2->setDuration(300);
-    anim2->setStartValue(btn2->pos());
-    anim2->setEndValue(btn1->pos());
-
-    swapGroup->addAnimation(anim1);
-    swapGroup->addAnimation(anim2);
-
-    connect(swapGroup, &QAbstractAnimation::finished, this, [this, swapGroup, allToRemove, res1, res2]() {
-        swapGroup->deleteLater();
-
-        // 播放特效
-        if (res1.type != Normal && res1.type != None) {
-            playMySpecialEffect(res1.type, res1.center, 0);
-        }
-        if (res2.type != Normal && res2.type != None) {
-            playMySpecialEffect(res2.type, res2.center, 0);
-        }
-
-        // 执行消除动画
-        playMyEliminateAnim(allToRemove);
-    });
-
-    swapGroup->start();
-}
-
-// =============== 消除检测逻辑 ===============
-int OnlineGame::countMyDirection(int r, int c, int dR, int dC)
-{
-    int color = m_myBoard->m_grid[r][c].pic;
-    int count = 0;
-    int nr = r + dR;
-    int nc = c + dC;
-
-    while (nr >= 0 && nr < ROW && nc >= 0 && nc < COL &&
-           m_myBoard->m_grid[nr][nc].pic == color) {
-        count++;
-        nr += dR;
-        nc += dC;
-    }
-
-    return count;
-}
-
-OnlineGame::ElimResult OnlineGame::getMyEliminations(int r, int c)
-{
-    ElimResult res;
-    res.center = QPoint(r, c);
-
-    int color = m_myBoard->m_grid[r][c].pic;
-    if (color == -1) return res;
-
-    int up = countMyDirection(r, c, -1, 0);
-    int down = countMyDirection(r, c, 1, 0);
-    int left = countMyDirection(r, c, 0, -1);
-    int right = countMyDirection(r, c, 0, 1);
-
-    // 1. 全屏消除
-    if ((up + down >= 4) || (left + right >= 4)) {
-        res.type = ColorClear;
-        for (int i = 0; i < ROW; ++i) {
-            for (int j = 0; j < COL; ++j) {
-                if (m_myBoard->m_grid[i][j].pic == color) {
-                    res.points.insert(QPoint(i, j));
-                }
-            }
-        }
-        return res;
-    }
-
-    // 2. 列消除
-    if (up + down == 3) {
-        res.type = ColBomb;
-        for (int i = 0; i < ROW; ++i) {
-            res.points.insert(QPoint(i, c));
-        }
-        return res;
-    }
-
-    // 3. 行消除
-    if (left + right == 3) {
-        res.type = RowBomb;
-        for (int j = 0; j < COL; ++j) {
-            res.points.insert(QPoint(r, j));
-        }
-        return res;
-    }
-
-    // 4. 区域炸弹
-    if (up + down >= 2 && left + right >= 2) {
-        res.type = AreaBomb;
-        for (int i = r - 2; i <= r + 2; ++i) {
-            for (int j = c - 2; j <= c + 2; ++j) {
-                if (i >= 0 && i < ROW && j >= 0 && j < COL) {
-                    res.points.insert(QPoint(i, j));
-                }
-            }
-        }
-        return res;
-    }
-
-    // 5. 普通消除
-    if (up + down >= 2) {
-        for (int i = r - up; i <= r + down; ++i) {
-            res.points.insert(QPoint(i, c));
-        }
-        res.type = Normal;
-    }
-
-    if (left + right >= 2) {
-        for (int j = c - left; j <= c + right; ++j) {
-            res.points.insert(QPoint(r, j));
-        }
-        res.type = Normal;
-    }
-
-    return res;
+    // 棋盘数据已是稳定后的状态，不用等动画播完就能接着操作；只有死局要锁到洗牌
+    m_myBoard->m_grid = g;
+    m_myLocked = events.last().dead;
+    playMyEvents(events);
 }
 
 void OnlineGame::playMySpecialEffect(EffectType type, QPoint center, int colorCode)
 {
-    if (type == None || type == Normal) return;
-
-    QWidget *boardWidget = ui->myBoardContainer;
-    int cellSize = 48;
-    int gap = 2;
-
-    // 计算棋盘位置
-    QRect cr = boardWidget->contentsRect();
-    int totalW = COL * (cellSize + gap) - gap;
-    int totalH = ROW * (cellSize + gap) - gap;
-    int ox = cr.left() + (cr.width() - totalW) / 2;
-    int oy = cr.top() + (cr.height() - totalH) / 2;
-
-    int centerX = ox + center.y() * (cellSize + gap) + cellSize / 2;
-    int centerY = oy + center.x() * (cellSize + gap) + cellSize / 2;
+    if (type == CascadeResolver::None || type == CascadeResolver::Normal) return;
 
+    // 特效直接画在我方棋盘上，位置跟着格子走
     // 行/列激光
-    if (type == RowBomb || type == ColBomb) {
-        QLabel *beam = new QLabel(boardWidget);
-        beam->setAttribute(Qt::WA_TransparentForMouseEvents);
-        beam->show();
-
-        QString qss = "background: qlineargradient(x1:0, y1:0, x2:%1, y2:%2, "
-                      "stop:0 rgba(255,255,255,0), stop:0.5 rgba(0, 229, 255, 230), stop:1 rgba(255,255,255,0));";
-
-        QPropertyAnimation *anim = new QPropertyAnimation(beam, "geometry");
-        anim->setDuration(400);
-        anim->setEasingCurve(QEasingCurve::OutExpo);
-
-        if (type == RowBomb) {
-            beam->setStyleSheet(qss.arg("0").arg("1"));
-            anim->setStartValue(QRect(ox, centerY - 2, totalW, 4));
-            anim->setEndValue(QRect(ox, centerY - 25, totalW, 50));
-        } else {
-            beam->setStyleSheet(qss.arg("1").arg("0"));
-            anim->setStartValue(QRect(centerX - 2, oy, 4, totalH));
-            anim->setEndValue(QRect(centerX - 25, oy, 50, totalH));
-        }
-
-        anim->start(QAbstractAnimation::DeleteWhenStopped);
-        connect(anim, &QAbstractAnimation::finished, beam, &QLabel::deleteLater);
+    if (type == CascadeResolver::RowBomb) {
+        m_myView->playBeam(Qt::Horizontal, center.x(), QColor(0, 229, 255, 230));
+    } else if (type == CascadeResolver::ColBomb) {
+        m_myView->playBeam(Qt::Vertical, center.y(), QColor(0, 229, 255, 230));
     }
     // 区域炸弹
-    else if (type == AreaBomb) {
-        QLabel *shockwave = new QLabel(boardWidget);
-        shockwave->setAttribute(Qt::WA_TransparentForMouseEvents);
-        shockwave->setStyleSheet(
-            "background: qradialgradient(cx:0.5, cy:0.5, radius:0.5, fx:0.5, fy:0.5, "
-            "stop:0 rgba(255,255,255,0), stop:0.7 rgba(0, 229, 255, 200), stop:1 rgba(255,255,255,0));"
-            "border-radius: 100px;");
-        shockwave->show();
-
-        QPropertyAnimation *anim = new QPropertyAnimation(shockwave, "geometry");
-        anim->setDuration(500);
-        anim->setEasingCurve(QEasingCurve::OutQuad);
-
-        anim->setStartValue(QRect(centerX, centerY, 0, 0));
-        anim->setEndValue(QRect(centerX - 75, centerY - 75, 150, 150));
-
-        anim->start(QAbstractAnimation::DeleteWhenStopped);
-        connect(anim, &QAbstractAnimation::finished, shockwave, &QLabel::deleteLater);
+    else if (type == CascadeResolver::AreaBomb) {
+        m_myView->playShockwave(center.x(), center.y(), 75, QColor(0, 229, 255, 200));
     }
     // 全屏闪光
-    else if (type == ColorClear) {
-        QLabel *flash = new QLabel(boardWidget);
-        flash->setAttribute(Qt::WA_TransparentForMouseEvents);
-        flash->setStyleSheet("background-color: rgba(0, 229, 255, 180);");
-        flash->setGeometry(boardWidget->rect());
-        flash->show();
-
-        QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(flash);
-        flash->setGraphicsEffect(eff);
-
-        QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-        fade->setDuration(600);
-        fade->setStartValue(1.0);
-        fade->setEndValue(0.0);
-
-        connect(fade, &QAbstractAnimation::finished, flash, &QLabel::deleteLater);
-        fade->start();
+    else if (type == CascadeResolver::ColorClear) {
+        m_myView->playFlash(QColor(0, 229, 255, 180), 600);
     }
 }
 
-void OnlineGame::playMyEliminateAnim(const QSet<QPoint>& points)
+void OnlineGame::playMyEliminateAnim(const CascadeResolver::Event &ev)
 {
+    const QSet<QPoint> &points = ev.points;
+
+    // 本轮触发的特效（同一中心只放一次，结算时已去重）
+    for (const CascadeResolver::Effect &fx : ev.effects) {
+        playMySpecialEffect(fx.type, fx.center, 0);
+    }
+
     // 【新增】播放消除音效
     int elimCount = points.size();
     if (elimCount >= 3) {
@@ -642,210 +370,97 @@ void OnlineGame::playMyEliminateAnim(const QSet<QPoint>& points)
         addMyScore(points.size());
     }
 
-    QParallelAnimationGroup *elimGroup = new QParallelAnimationGroup(this);
-
-    for (const QPoint &p : points) {
-        int idx = p.x() * COL + p.y();
-        QPushButton *btn = m_myCells[idx];
-        if (!btn) continue;
-
-        // 缩小动画
-        QPropertyAnimation *scale = new QPropertyAnimation(btn, "geometry");
-        scale->setDuration(250);
-        QRect rect = btn->geometry();
-        scale->setStartValue(rect);
-        scale->setEndValue(rect.adjusted(24, 24, -24, -24));
-
-        // 淡出动画
-        QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(btn);
-        btn->setGraphicsEffect(eff);
-        QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-        fade->setDuration(250);
-        fade->setStartValue(1.0);
-        fade->setEndValue(0.0);
-
-        elimGroup->addAnimation(scale);
-        elimGroup->addAnimation(fade);
-
-        // 标记为已消除
-        m_myBoard->m_grid[p.x()][p.y()].pic = -1;
-    }
-
-    connect(elimGroup, &QAbstractAnimation::finished, this, [this, elimGroup, points]() {
-        // 删除按钮
-        for (const QPoint &p : points) {
-            int idx = p.x() * COL + p.y();
-            if (m_myCells[idx]) {
-                delete m_myCells[idx];
-                m_myCells[idx] = nullptr;
-            }
-        }
-
-        elimGroup->deleteLater();
+    // 缩小 + 淡出
+    m_myView->playEliminate(points, [this]() {
         m_myUltimateBurstActive = false;
+        playNextMyEvent();
+    });
+}
 
-        // 执行下落
-        performMyFallAnimation();
+void OnlineGame::performMyFallAnimation(const CascadeResolver::Event &ev)
+{
+    // 补位颜色结算时已从 m_myRng 取好，这里只负责显示
+    m_myView->playFall(ev.grid, [this]() {
+        playNextMyEvent(); // 下一轮消除或稳定
     });
+}
 
-    elimGroup->start();
+void OnlineGame::playMyEvents(const QVector<CascadeResolver::Event> &events)
+{
+    for (const CascadeResolver::Event &ev : events) m_myEvents.enqueue(ev);
+    playNextMyEvent();
 }
 
-void OnlineGame::performMyFallAnimation()
+void OnlineGame::playNextMyEvent()
 {
-    QRect cr = ui->myBoardContainer->contentsRect();
-    int cellSize = 48;
-    int gap = 2;
-    int totalW = COL * (cellSize + gap) - gap;
-    int totalH = ROW * (cellSize + gap) - gap;
-    int ox = cr.left() + (cr.width() - totalW) / 2;
-    int oy = cr.top() + (cr.height() - totalH) / 2;
+    using Event = CascadeResolver::Event;
+    if (m_myEvents.isEmpty()) return;
 
-    QParallelAnimationGroup *fallGroup = new QParallelAnimationGroup(this);
-    auto *rng = QRandomGenerator::global();
+    // 瞬间速度：不播动画，直接摆出最终棋盘
+    if (m_myTweens->speed() == 0) {
+        skipMyEventsToEnd();
+        return;
+    }
 
-    // 先将所有按钮从布局中移除
-    for (QPushButton *b : m_myCells) {
-        if (b) {
-            m_myGridLayout->removeWidget(b);
-        }
+    const Event ev = m_myEvents.dequeue();
+    switch (ev.type) {
+    case Event::Swap:
+        m_myView->playSwap(ev.a.x(), ev.a.y(), ev.b.x(), ev.b.y(), [this]() { playNextMyEvent(); });
+        break;
+    case Event::Eliminate: playMyEliminateAnim(ev); break;
+    case Event::Fall:      performMyFallAnimation(ev); break;
+    case Event::Settled:   onMyBoardSettled(ev); break;
     }
+}
 
-    // 对每一列进行处理
-    for (int c = 0; c < COL; ++c) {
-        // 收集幸存按钮
-        struct BlockData {
-            QPushButton* btn;
-            int color;
-        };
-        QList<BlockData> survivors;
-
-        for (int r = ROW - 1; r >= 0; --r) {
-            int idx = r * COL + c;
-            if (m_myCells[idx] != nullptr) {
-                survivors.append({m_myCells[idx], m_myBoard->m_grid[r][c].pic});
-                m_myCells[idx] = nullptr;
-            }
-        }
+void OnlineGame::skipMyEventsToEnd()
+{
+    using Event = CascadeResolver::Event;
+    if (m_myEvents.isEmpty()) return;
 
-        // 重建这一列
-        int survivorIdx = 0;
-        for (int r = ROW - 1; r >= 0; --r) {
-            QPushButton *btn = nullptr;
-            int finalColor = 0;
-            bool isExistingBtn = false;
-
-            int destX = ox + c * (cellSize + gap);
-            int destY = oy + r * (cellSize + gap);
-
-            if (survivorIdx < survivors.size()) {
-                // 使用幸存按钮
-                BlockData bd = survivors[survivorIdx];
-                btn = bd.btn;
-                finalColor = bd.color;
-                isExistingBtn = true;
-                survivorIdx++;
-            } else {
-                // 创建新按钮
-                finalColor = rng->bounded(6);
-                isExistingBtn = false;
-
-                btn = new QPushButton(ui->myBoardContainer);
-                btn->setFixedSize(cellSize, cellSize);
-                btn->setStyleSheet("border:none;");
-                QString path = getCellImagePath(finalColor);
-                btn->setIcon(QIcon(path));
-                btn->setIconSize(QSize(cellSize, cellSize));
-                btn->show();
-
-                // 新按钮从顶部掉落
-                int startY = destY - (ROW * cellSize + 100);
-                btn->move(destX, startY);
-            }
+    // 进行中的补间连同待触发的阶段回调一起作废；终极爆发那一轮已经播出，标志随之复位
+    m_myTweens->stop();
+    m_myUltimateBurstActive = false;
 
-            // 更新状态
-            m_myCells[r * COL + c] = btn;
-            m_myBoard->m_grid[r][c].pic = finalColor;
-
-            // 重新连接信号
-            if (isExistingBtn) btn->disconnect();
-            connect(btn, &QPushButton::clicked, this, [this, r, c]() {
-                handleMyCellClick(r, c);
-            });
-
-            // 创建下落动画
-            QPoint startPos = btn->pos();
-            QPoint endPos = QPoint(destX, destY);
-
-            if (startPos != endPos) {
-                QPropertyAnimation *anim = new QPropertyAnimation(btn, "pos");
-                anim->setDuration(500);
-                anim->setStartValue(startPos);
-                anim->setEndValue(endPos);
-                anim->setEasingCurve(QEasingCurve::OutBounce);
-                fallGroup->addAnimation(anim);
-            } else {
-                btn->move(endPos);
-            }
-        }
+    const Event last = m_myEvents.last();
+    while (!m_myEvents.isEmpty()) {
+        const Event ev = m_myEvents.dequeue();
+        if (ev.type == Event::Eliminate) addMyScore(ev.points.size());
     }
+    // 直接摆出最终棋盘，稳定后照常同步
+    m_myView->setGrid(last.grid);
+    onMyBoardSettled(last);
+}
 
-    connect(fallGroup, &QAbstractAnimation::finished, this, [this, fallGroup]() {
-        // 重新添加到布局
-        for (int r = 0; r < ROW; ++r) {
-            for (int c = 0; c < COL; ++c) {
-                QPushButton *btn = m_myCells[r * COL + c];
-                if (btn) {
-                    m_myGridLayout->addWidget(btn, r, c);
-                }
-            }
-        }
-
-        fallGroup->deleteLater();
+void OnlineGame::onMySpeedButtonClicked()
+{
+    // 1x -> 2x -> 4x -> 瞬间 -> 1x；只管我方棋盘，对手棋盘按积压自动追帧
+    switch (qRound(m_myTweens->speed())) {
+    case 1:  setMyPlaybackSpeed(2); break;
+    case 2:  setMyPlaybackSpeed(4); break;
+    case 4:  setMyPlaybackSpeed(0); break;
+    default: setMyPlaybackSpeed(1); break;
+    }
+}
 
-        // 检查连击
-        checkMyComboMatches();
-    });
+void OnlineGame::setMyPlaybackSpeed(int speed)
+{
+    m_myTweens->setSpeed(speed);
+    ui->btnMySpeed->setText(speed == 0 ? "跳过" : QString("%1x").arg(speed));
 
-    fallGroup->start();
+    // 切到瞬间：正在播的这一步也不再等，直接跳到结算后的棋盘
+    if (speed == 0) skipMyEventsToEnd();
 }
 
-void OnlineGame::checkMyComboMatches()
+void OnlineGame::onMyBoardSettled(const CascadeResolver::Event &ev)
 {
-    QSet<QPoint> allMatches;
-    QSet<QPoint> processedCenters;
+    m_myLocked = false;   // handleMyDeadlock 自己加锁，已锁时会直接返回
 
-    // 扫描全盘
-    for (int r = 0; r < ROW; ++r) {
-        for (int c = 0; c < COL; ++c) {
-            ElimResult res = getMyEliminations(r, c);
-            if (!res.points.isEmpty()) {
-                allMatches.unite(res.points);
-
-                // 播放特效
-                if (res.type != Normal && res.type != None) {
-                    if (!processedCenters.contains(res.center)) {
-                        playMySpecialEffect(res.type, res.center, 0);
-                        processedCenters.insert(res.center);
-                    }
-                }
-            }
-        }
-    }
-
-    if (!allMatches.isEmpty()) {
-        // 有连击，继续消除
-        m_myLocked = true;
-        playMyEliminateAnim(allMatches);
+    if (ev.dead) {
+        handleMyDeadlock();
     } else {
-        // 无连击，检查死局
-        if (m_myBoard->isDead(m_myBoard->grid())) {
-            handleMyDeadlock();
-        } else {
-            m_myLocked = false;
-            // 同步棋盘状态
-            syncMyBoard();
-        }
+        // 同步棋盘状态
+        syncMyBoard();
     }
 }
 
@@ -854,42 +469,20 @@ void OnlineGame::handleMyDeadlock()
     if (m_myLocked) return;
     m_myLocked = true;
 
-    QLabel *lbl = new QLabel(ui->myBoardContainer);
-    lbl->setText("死局！重新洗牌");
-    lbl->setAlignment(Qt::AlignCenter);
-    lbl->setStyleSheet(
-        "background-color: rgba(0, 0, 0, 180);"
-        "color: #00e5ff;"
-        "font: bold 26pt 'Microsoft YaHei';"
-        "border-radius: 15px;"
-        "border: 2px solid #00e5ff;"
-        );
-    lbl->adjustSize();
-    lbl->resize(lbl->width() + 60, lbl->height() + 40);
-
-    QRect cr = ui->myBoardContainer->rect();
-    lbl->move((cr.width() - lbl->width()) / 2, (cr.height() - lbl->height()) / 2);
-    lbl->show();
-    lbl->setAttribute(Qt::WA_TransparentForMouseEvents);
-
-    QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(lbl);
-    lbl->setGraphicsEffect(eff);
-
-    QPropertyAnimation *anim = new QPropertyAnimation(eff, "opacity");
-    anim->setDuration(2000);
-    anim->setKeyValueAt(0.0, 0.0);
-    anim->setKeyValueAt(0.1, 1.0);
-    anim->setKeyValueAt(0.8, 1.0);
-    anim->setKeyValueAt(1.0, 0.0);
-
-    connect(anim, &QAbstractAnimation::finished, this, [this, lbl]() {
-        lbl->deleteLater();
+    // 淡入 → 停留 → 淡出，共 2 秒
+    BoardView::Banner banner;
+    banner.text = "死局！重新洗牌";
+    banner.color = QColor("#00e5ff");
+    banner.pointSize = 26;
+    banner.boxed = true;
+    banner.fadeIn = 200;
+    banner.hold = 1400;
+    banner.fadeOut = 400;
+    m_myView->showBanner(banner, [this]() {
         m_myBoard->initNoThree();
         rebuildMyGrid();
         syncMyBoard();
     });
-
-    anim->start(QAbstractAnimation::DeleteWhenStopped);
 }
 
 void OnlineGame::addMyScore(int count)
@@ -923,136 +516,12 @@ void OnlineGame::initOpponentBoard()
 
 void OnlineGame::rebuildOpponentGrid()
 {
-    clearOpponentGridLayout();
-    m_opponentCells.resize(ROW * COL);
-    const Grid &gr = m_opponentBoard->grid();
-    QRect cr = ui->opponentBoardContainer->contentsRect();
-    int availW = cr.width();
-    int availH = cr.height();
-
-    int cellSize = 48;
-    int gap = 2;
-    int totalW = COL * (cellSize + gap) - gap;
-    int totalH = ROW * (cellSize + gap) - gap;
-
-    int ox = cr.left() + (availW - totalW) / 2;
-    int oy = cr.top() + (availH - totalH) / 2;
-
-    for (int r = 0; r < ROW; ++r) {
-        for (int c = 0; c < COL; ++c) {
-            QPushButton *btn = new QPushButton(ui->opponentBoardContainer);
-            btn->setFixedSize(cellSize, cellSize);
-            btn->setStyleSheet("border:none;");
-            btn->setAttribute(Qt::WA_TransparentForMouseEvents, true);
-            btn->setFocusPolicy(Qt::NoFocus);
-            btn->setStyleSheet(
-                "QPushButton {"
-                "   border: none;"
-                "   background: transparent;"
-                "}"
-                "QPushButton:disabled {"
-                "   background: transparent;"
-                "}"
-                );
-
-            QString path = getCellImagePath(gr[r][c].pic);
-            btn->setIcon(QIcon(path));
-            btn->setIconSize(QSize(cellSize, cellSize));
-
-            int targetX = ox + c * (cellSize + gap);
-            int targetY = oy + r * (cellSize + gap);
-
-            // 初始位置
-            btn->move(targetX, targetY - (ROW - r) * (cellSize + gap));
-            auto *eff = new QGraphicsOpacityEffect(btn);
-            eff->setOpacity(0.0);
-            btn->setGraphicsEffect(eff);
-            btn->show();
-
-            m_opponentCells[r * COL + c] = btn;
-        }
-    }
-
-    createOpponentDropAnimation(ox, oy);
-}
-
-void OnlineGame::clearOpponentGridLayout()
-{
-    if (m_opponentDropGroup) {
-        m_opponentDropGroup->stop();
-        m_opponentDropGroup->clear();
-    }
-
-    for (QPushButton *b : m_opponentCells) {
-        if (b) delete b;
-    }
-    m_opponentCells.clear();
-
-    if (m_opponentGridLayout && ui->opponentBoardContainer) {
-        QLayoutItem *item;
-        while ((item = m_opponentGridLayout->takeAt(0)) != nullptr) {
-            if (item->widget()) delete item->widget();
-            delete item;
-        }
-    }
-}
-
-void OnlineGame::createOpponentDropAnimation(int left0, int top0)
-{
-    if (m_opponentDropGroup->state() == QAbstractAnimation::Running) {
-        m_opponentDropGroup->stop();
-    }
-    m_opponentDropGroup->clear();
-
-    int cellSize = 48;
-    int gap = 2;
-
-    for (int r = ROW - 1; r >= 0; --r) {
-        auto *rowPar = new QParallelAnimationGroup(this);
-        for (int c = 0; c < COL; ++c) {
-            QPushButton *btn = m_opponentCells[r * COL + c];
-            if (!btn) continue;
-
-            auto *eff = qobject_cast<QGraphicsOpacityEffect*>(btn->graphicsEffect());
-            if (!eff) {
-                eff = new QGraphicsOpacityEffect(btn);
-                btn->setGraphicsEffect(eff);
-            }
-
-            int targetX = left0 + c * (cellSize + gap);
-            int targetY = top0 + r * (cellSize + gap);
-
-            auto *drop = new QPropertyAnimation(btn, "pos");
-            drop->setDuration(180 + (ROW - 1 - r) * 15);
-            drop->setStartValue(QPoint(targetX, targetY - 200));
-            drop->setEndValue(QPoint(targetX, targetY));
-            drop->setEasingCurve(QEasingCurve::OutBounce);
-
-            auto *fade = new QPropertyAnimation(eff, "opacity");
-            fade->setDuration(300);
-            fade->setStartValue(0.0);
-            fade->setEndValue(1.0);
-
-            auto *cellAnim = new QParallelAnimationGroup(this);
-            cellAnim->addAnimation(drop);
-            cellAnim->addAnimation(fade);
-            rowPar->addAnimation(cellAnim);
-        }
-        m_opponentDropGroup->addAnimation(rowPar);
-        m_opponentDropGroup->addPause(1);
-    }
-
-    connect(m_opponentDropGroup, &QSequentialAnimationGroup::finished, this, [this]() {
-        for (int r = 0; r < ROW; ++r) {
-            for (int c = 0; c < COL; ++c) {
-                QPushButton *btn = m_opponentCells[r * COL + c];
-                if (btn) m_opponentGridLayout->addWidget(btn, r, c);
-            }
-        }
-        m_opponentLocked = false;  // 解锁对手棋盘
+    m_opponentLocked = true;
+    m_opponentView->tweens()->setSpeed(1.0);
+    m_opponentView->setGrid(m_opponentBoard->grid());
+    m_opponentView->playDropIn(200, -1, [this]() {
+        playNextOpponentEvent();  // 开局动画期间收到的对手操作接着播；没有则解锁
     });
-
-    m_opponentDropGroup->start();
 }
 
 // 【新增】查找棋盘差异
@@ -1082,332 +551,84 @@ void OnlineGame::findDifferences(const Grid& oldGrid, const Grid& newGrid,
     }
 }
 
-// 【新增】对手消除动画
-void OnlineGame::playOpponentEliminateAnim(const QSet<QPoint>& points)
-{
-    if (points.isEmpty()) return;
-
-    QParallelAnimationGroup *elimGroup = new QParallelAnimationGroup(this);
-
-    for (const QPoint &p : points) {
-        int idx = p.x() * COL + p.y();
-        QPushButton *btn = m_opponentCells[idx];
-        if (!btn) continue;
-
-        // 缩小动画
-        QPropertyAnimation *scale = new QPropertyAnimation(btn, "geometry");
-        scale->setDuration(250);
-        QRect rect = btn->geometry();
-        scale->setStartValue(rect);
-        scale->setEndValue(rect.adjusted(24, 24, -24, -24));
-
-        // 淡出动画
-        QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(btn);
-        btn->setGraphicsEffect(eff);
-        QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-        fade->setDuration(250);
-        fade->setStartValue(1.0);
-        fade->setEndValue(0.0);
-
-        elimGroup->addAnimation(scale);
-        elimGroup->addAnimation(fade);
-    }
-
-    connect(elimGroup, &QAbstractAnimation::finished, this, [this, elimGroup, points]() {
-        // 物理删除按钮
-        for (const QPoint &p : points) {
-            int idx = p.x() * COL + p.y();
-            if (m_opponentCells[idx]) {
-                delete m_opponentCells[idx];
-                m_opponentCells[idx] = nullptr;
-            }
-        }
-
-        elimGroup->deleteLater();
-
-        // 执行下落动画
-        performOpponentFallAnimation();
-    });
-
-    elimGroup->start();
-}
-
-// 【新增】对手下落动画
-void OnlineGame::performOpponentFallAnimation()
-{
-    QRect cr = ui->opponentBoardContainer->contentsRect();
-    int cellSize = 48;
-    int gap = 2;
-    int totalW = COL * (cellSize + gap) - gap;
-    int totalH = ROW * (cellSize + gap) - gap;
-    int ox = cr.left() + (cr.width() - totalW) / 2;
-    int oy = cr.top() + (cr.height() - totalH) / 2;
-
-    QParallelAnimationGroup *fallGroup = new QParallelAnimationGroup(this);
-
-    // 先将所有按钮从布局中移除
-    for (QPushButton *b : m_opponentCells) {
-        if (b) {
-            m_opponentGridLayout->removeWidget(b);
-        }
-    }
-
-    // 对每一列进行处理
-    for (int c = 0; c < COL; ++c) {
-        // 收集幸存按钮
-        struct BlockData {
-            QPushButton* btn;
-            int color;
-        };
-        QList<BlockData> survivors;
-
-        for (int r = ROW - 1; r >= 0; --r) {
-            int idx = r * COL + c;
-            if (m_opponentCells[idx] != nullptr) {
-                survivors.append({m_opponentCells[idx], m_opponentBoard->m_grid[r][c].pic});
-                m_opponentCells[idx] = nullptr;
-            }
-        }
-
-        // 重建这一列
-        int survivorIdx = 0;
-        for (int r = ROW - 1; r >= 0; --r) {
-            QPushButton *btn = nullptr;
-            int finalColor = m_opponentBoard->m_grid[r][c].pic;
-            bool isExistingBtn = false;
-
-            int destX = ox + c * (cellSize + gap);
-            int destY = oy + r * (cellSize + gap);
-
-            if (survivorIdx < survivors.size()) {
-                // 使用幸存按钮
-                BlockData bd = survivors[survivorIdx];
-                btn = bd.btn;
-                isExistingBtn = true;
-                survivorIdx++;
-
-                // 更新幸存按钮的图标
-                QString path = getCellImagePath(finalColor);
-                btn->setIcon(QIcon(path));
-                btn->setIconSize(QSize(cellSize, cellSize));
-            } else if (finalColor != -1) {
-                // 创建新按钮（填充空缺）
-                btn = new QPushButton(ui->opponentBoardContainer);
-                btn->setFixedSize(cellSize, cellSize);
-                btn->setStyleSheet("border:none;");
-                btn->setAttribute(Qt::WA_TransparentForMouseEvents, true);
-                btn->setFocusPolicy(Qt::NoFocus);
-
-                QString path = getCellImagePath(finalColor);
-                btn->setIcon(QIcon(path));
-                btn->setIconSize(QSize(cellSize, cellSize));
-
-                // 新按钮从顶部掉落
-                int startY = destY - (ROW * cellSize + 100);
-                btn->move(destX, startY);
-                btn->show();
-
-                // 添加淡入效果
-                QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(btn);
-                eff->setOpacity(0.0);
-                btn->setGraphicsEffect(eff);
-            }
-
-            // 更新状态
-            m_opponentCells[r * COL + c] = btn;
-
-            // 创建下落动画
-            if (btn && btn->pos() != QPoint(destX, destY)) {
-                QPropertyAnimation *anim = new QPropertyAnimation(btn, "pos");
-                anim->setDuration(500);
-                anim->setStartValue(btn->pos());
-                anim->setEndValue(QPoint(destX, destY));
-                anim->setEasingCurve(QEasingCurve::OutBounce);
-                fallGroup->addAnimation(anim);
-
-                // 如果是新按钮，添加淡入动画
-                if (!isExistingBtn) {
-                    QGraphicsOpacityEffect *eff = qobject_cast<QGraphicsOpacityEffect*>(btn->graphicsEffect());
-                    if (eff) {
-                        QPropertyAnimation *fadeIn = new QPropertyAnimation(eff, "opacity");
-                        fadeIn->setDuration(500);
-                        fadeIn->setStartValue(0.0);
-                        fadeIn->setEndValue(1.0);
-                        fallGroup->addAnimation(fadeIn);
-                    }
-                }
-            }
-        }
-    }
-
-    connect(fallGroup, &QAbstractAnimation::finished, this, [this, fallGroup]() {
-        // 重新添加到布局
-        for (int r = 0; r < ROW; ++r) {
-            for (int c = 0; c < COL; ++c) {
-                QPushButton *btn = m_opponentCells[r * COL + c];
-                if (btn) {
-                    m_opponentGridLayout->addWidget(btn, r, c);
-                }
-            }
-        }
-
-        fallGroup->deleteLater();
-        m_opponentLocked = false;
-
-        // 播放完成音效
-        MusicManager::instance().playMatchSound(1); // 轻微音效提示
-    });
-
-    fallGroup->start();
-}
-
 // 【新增】对手特效动画
 void OnlineGame::playOpponentSpecialEffect(EffectType type, QPoint center, int colorCode)
 {
-    if (type == None || type == Normal) return;
-
-    QWidget *boardWidget = ui->opponentBoardContainer;
-    int cellSize = 48;
-    int gap = 2;
-
-    // 计算棋盘位置
-    QRect cr = boardWidget->contentsRect();
-    int totalW = COL * (cellSize + gap) - gap;
-    int totalH = ROW * (cellSize + gap) - gap;
-    int ox = cr.left() + (cr.width() - totalW) / 2;
-    int oy = cr.top() + (cr.height() - totalH) / 2;
-
-    int centerX = ox + center.y() * (cellSize + gap) + cellSize / 2;
-    int centerY = oy + center.x() * (cellSize + gap) + cellSize / 2;
+    if (type == CascadeResolver::None || type == CascadeResolver::Normal) return;
 
+    // 画在对手棋盘上：格位取自棋盘本身，跟着对手的播放倍速走
     // 行/列激光
-    if (type == RowBomb || type == ColBomb) {
-        QLabel *beam = new QLabel(boardWidget);
-        beam->setAttribute(Qt::WA_TransparentForMouseEvents);
-        beam->show();
-
-        QString qss = "background: qlineargradient(x1:0, y1:0, x2:%1, y2:%2, "
-                      "stop:0 rgba(255,255,255,0), stop:0.5 rgba(255, 100, 100, 230), stop:1 rgba(255,255,255,0));";
-
-        QPropertyAnimation *anim = new QPropertyAnimation(beam, "geometry");
-        anim->setDuration(400);
-        anim->setEasingCurve(QEasingCurve::OutExpo);
-
-        if (type == RowBomb) {
-            beam->setStyleSheet(qss.arg("0").arg("1"));
-            anim->setStartValue(QRect(ox, centerY - 2, totalW, 4));
-            anim->setEndValue(QRect(ox, centerY - 25, totalW, 50));
-        } else {
-            beam->setStyleSheet(qss.arg("1").arg("0"));
-            anim->setStartValue(QRect(centerX - 2, oy, 4, totalH));
-            anim->setEndValue(QRect(centerX - 25, oy, 50, totalH));
-        }
-
-        anim->start(QAbstractAnimation::DeleteWhenStopped);
-        connect(anim, &QAbstractAnimation::finished, beam, &QLabel::deleteLater);
+    if (type == CascadeResolver::RowBomb) {
+        m_opponentView->playBeam(Qt::Horizontal, center.x(), QColor(255, 100, 100, 230));
+    } else if (type == CascadeResolver::ColBomb) {
+        m_opponentView->playBeam(Qt::Vertical, center.y(), QColor(255, 100, 100, 230));
     }
     // 区域炸弹
-    else if (type == AreaBomb) {
-        QLabel *shockwave = new QLabel(boardWidget);
-        shockwave->setAttribute(Qt::WA_TransparentForMouseEvents);
-        shockwave->setStyleSheet(
-            "background: qradialgradient(cx:0.5, cy:0.5, radius:0.5, fx:0.5, fy:0.5, "
-            "stop:0 rgba(255,255,255,0), stop:0.7 rgba(255, 100, 100, 200), stop:1 rgba(255,255,255,0));"
-            "border-radius: 100px;");
-        shockwave->show();
-
-        QPropertyAnimation *anim = new QPropertyAnimation(shockwave, "geometry");
-        anim->setDuration(500);
-        anim->setEasingCurve(QEasingCurve::OutQuad);
-
-        anim->setStartValue(QRect(centerX, centerY, 0, 0));
-        anim->setEndValue(QRect(centerX - 75, centerY - 75, 150, 150));
-
-        anim->start(QAbstractAnimation::DeleteWhenStopped);
-        connect(anim, &QAbstractAnimation::finished, shockwave, &QLabel::deleteLater);
+    else if (type == CascadeResolver::AreaBomb) {
+        m_opponentView->playShockwave(center.x(), center.y(), 75, QColor(255, 100, 100, 200));
     }
     // 全屏闪光
-    else if (type == ColorClear) {
-        QLabel *flash = new QLabel(boardWidget);
-        flash->setAttribute(Qt::WA_TransparentForMouseEvents);
-        flash->setStyleSheet("background-color: rgba(255, 100, 100, 180);");
-        flash->setGeometry(boardWidget->rect());
-        flash->show();
-
-        QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(flash);
-        flash->setGraphicsEffect(eff);
-
-        QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-        fade->setDuration(600);
-        fade->setStartValue(1.0);
-        fade->setEndValue(0.0);
-
-        connect(fade, &QAbstractAnimation::finished, flash, &QLabel::deleteLater);
-        fade->start();
+    else if (type == CascadeResolver::ColorClear) {
+        m_opponentView->playFlash(QColor(255, 100, 100, 180), 600);
     }
 }
 
 // 【新增】对手抖动效果
-void OnlineGame::playOpponentCellShake(QPushButton *btn)
+void OnlineGame::playOpponentCellShake(int r, int c)
 {
-    auto *anim = new QPropertyAnimation(btn, "pos");
-    QPoint p = btn->pos();
-    anim->setDuration(120);
-    anim->setKeyValueAt(0, p);
-    anim->setKeyValueAt(0.25, p - QPoint(4, 0));
-    anim->setKeyValueAt(0.75, p + QPoint(4, 0));
-    anim->setKeyValueAt(1, p);
-    anim->start(QAbstractAnimation::DeleteWhenStopped);
+    m_opponentView->playShake(r, c);
 }
 
 // 【新增】处理对手棋盘更新（完整动画版）
 void OnlineGame::updateOpponentFromNetwork(const QJsonArray &boardArray, int score)
 {
     if (boardArray.size() != ROW * COL) {
-        qDebug() << "错误: 棋盘数组大小不正确" << boardArray.size();
+        LOG_WARN("sync", "棋盘数组大小不正确 %1", boardArray.size());
         return;
     }
 
-    // 保存旧棋盘状态
+    // 模型立即更新到最新状态，界面按队列追赶
     Grid oldGrid = m_opponentBoard->grid();
-
-    // 更新棋盘数据
-    for (int r = 0; r < ROW; ++r) {
-        for (int c = 0; c < COL; ++c) {
-            int idx = r * COL + c;
-            int color = boardArray[idx].toInt();
-            m_opponentBoard->m_grid[r][c].pic = color;
-        }
+    if (!BoardCodec::fromJson(boardArray, m_opponentBoard->m_grid)) {
+        LOG_WARN("sync", "棋盘数据非法");
+        return;
     }
 
     // 更新分数
     m_opponentScore = score;
     updateOpponentInfo();
 
-    // 锁定对手棋盘，防止动画冲突
-    m_opponentLocked = true;
-
     // 分析棋盘变化
     QSet<QPoint> eliminated;
     QSet<QPoint> newCells;
     findDifferences(oldGrid, m_opponentBoard->grid(), eliminated, newCells);
 
-    // 如果没有变化，直接解锁
-    if (eliminated.isEmpty() && newCells.isEmpty()) {
-        m_opponentLocked = false;
-        return;
-    }
+    // 如果没有变化，不用排队
+    if (eliminated.isEmpty() && newCells.isEmpty()) return;
 
-    // 播放消除动画
+    // 差异折算成与确定性同步相同的事件：先消除（没有消除就直接下落），再下落到新棋盘
+    using Event = CascadeResolver::Event;
     if (!eliminated.isEmpty()) {
-        playOpponentEliminateAnim(eliminated);
-    } else {
-        // 如果没有消除，直接执行下落动画
-        performOpponentFallAnimation();
-    }
-
-    qDebug() << "对手棋盘更新: 消除" << eliminated.size()
-             << "个, 新生成" << newCells.size() << "个, 分数:" << m_opponentScore;
+        Event elim;
+        elim.type = Event::Eliminate;
+        elim.points = eliminated;
+        elim.grid = oldGrid;
+        for (const QPoint &p : eliminated) elim.grid[p.x()][p.y()].pic = -1;
+        enqueueOpponentEvent(elim);
+    }
+    Event fall;
+    fall.type = Event::Fall;
+    fall.grid = m_opponentBoard->grid();
+    enqueueOpponentEvent(fall);
+    Event settled;
+    settled.type = Event::Settled;
+    settled.grid = fall.grid;
+    enqueueOpponentEvent(settled);
+
+    LOG_DEBUG("sync", "对手棋盘更新: 消除 %1 个, 新生成 %2 个, 分数 %3, 积压 %4 ms",
+              eliminated.size(), newCells.size(), m_opponentScore, m_opponentBacklogMs);
+
+    scheduleOpponentPlayback();
 }
 // =============== 游戏控制 ===============
 void OnlineGame::startGameSequence()
@@ -1418,41 +639,19 @@ void OnlineGame::startGameSequence()
     // 【新增】播放联机游戏背景音乐
     MusicManager::instance().playSceneMusic(MusicManager::MusicScene::Playing);
 
-    QLabel *lbl = new QLabel(ui->myBoardContainer);
-    lbl->setText("Ready Go!");
-    lbl->setAlignment(Qt::AlignCenter);
-    lbl->setStyleSheet(
-        "color: #00e5ff;"
-        "font: bold 40pt 'Microsoft YaHei';"
-        "background: transparent;"
-        );
-    lbl->adjustSize();
-    QRect cr = ui->myBoardContainer->rect();
-    lbl->move((cr.width() - lbl->width()) / 2, (cr.height() - lbl->height()) / 2);
-    lbl->show();
-    lbl->setAttribute(Qt::WA_TransparentForMouseEvents);
-
-    QGraphicsOpacityEffect *eff = new QGraphicsOpacityEffect(lbl);
-    lbl->setGraphicsEffect(eff);
-
-    QSequentialAnimationGroup *seq = new QSequentialAnimationGroup(this);
-    seq->addPause(500);
-
-    QPropertyAnimation *fade = new QPropertyAnimation(eff, "opacity");
-    fade->setDuration(1000);
-    fade->setStartValue(1.0);
-    fade->setEndValue(0.0);
-    seq->addAnimation(fade);
-
-    connect(seq, &QAbstractAnimation::finished, this, [this, lbl]() {
-        lbl->deleteLater();
+    // 停留 0.5 秒然后淡出
+    BoardView::Banner banner;
+    banner.text = "Ready Go!";
+    banner.color = QColor("#00e5ff");
+    banner.pointSize = 40;
+    banner.hold = 500;
+    banner.fadeOut = 1000;
+    m_myView->showBanner(banner, [this]() {
         m_myLocked = false;
         m_isGameActive = true;
         m_gameTimer->start();
-        m_syncTimer->start();
+        syncMyBoard();   // 之后由棋盘变化驱动；确定性同步按操作发送
     });
-
-    seq->start(QAbstractAnimation::DeleteWhenStopped);
 }
 
 void OnlineGame::onGameTimerTick()
@@ -1505,24 +704,13 @@ void OnlineGame::gameOver()
     // 发送游戏结束消息
     NetworkManager *networkManager = NetworkManager::instance();
     if (networkManager && networkManager->isConnected()) {
-        QJsonObject endData;
-        endData["type"] = "game_end";
-        endData["room_id"] = m_roomId;
-        endData["player1_score"] = m_myScore;
-        endData["player2_score"] = m_opponentScore;
-        endData["player1"] = m_myUsername;
-        endData["player2"] = m_opponentUsername;
-
-        // 判断胜负
-        if (m_myScore > m_opponentScore) {
-            endData["winner"] = m_myUsername;
-        } else if (m_opponentScore > m_myScore) {
-            endData["winner"] = m_opponentUsername;
-        } else {
-            endData["winner"] = "draw";
-        }
-
-        networkManager->sendGameMove(m_opponentUsername, endData);
+        // 局末分数：服务器记入房间，对手收到后刷新显示
+        Protocol::GameMove finalMove;
+        finalMove.roomId = m_roomId;
+        finalMove.player = m_myUsername;
+        finalMove.op = "final";
+        finalMove.score = m_myScore;
+        networkManager->sendGameMove(finalMove);
         networkManager->updateUserStatus("在线", "空闲", "");
     }
 
@@ -1592,6 +780,20 @@ void OnlineGame::updateOpponentInfo()
     ui->labelOpponentInfo->setText(info);
 }
 
+void OnlineGame::updateLinkStats()
+{
+    NetworkManager *networkManager = NetworkManager::instance();
+    const NetworkManager::LinkStats s = networkManager->linkStats();
+    if (s.srttMs < 0) return;
+
+    QString text = QString("延迟 %1 ms  抖动 %2 ms\n丢包 %3%  同步间隔 %4 ms")
+                       .arg(s.srttMs)
+                       .arg(s.jitterMs)
+                       .arg(qRound(s.loss * 100))
+                       .arg(networkManager->recommendedSyncIntervalMs());
+    ui->labelOpponentStatus->setText(text);
+}
+
 void OnlineGame::updateCountdown()
 {
     int minutes = m_totalTime / 60;
@@ -1640,7 +842,6 @@ void OnlineGame::on_btnBack_clicked()
             NetworkManager *networkManager = NetworkManager::instance();
             if (networkManager && networkManager->isConnected()) {
                 QJsonObject quitData;
-                quitData["type"] = "player_quit";
                 // 不发送房间ID，让服务器根据用户名查找
                 quitData["quitter"] = m_myUsername;
                 quitData["opponent"] = m_opponentUsername;
@@ -1653,7 +854,7 @@ void OnlineGame::on_btnBack_clicked()
                          << "，对手:" << m_opponentUsername
                          << "，房间ID为空:" << m_roomId.isEmpty();
 
-                networkManager->sendRawJson(quitData);
+                networkManager->send(Protocol::MsgId::PlayerQuit, quitData);
 
                 // 更新状态
                 networkManager->updateUserStatus("在线", "空闲", "");
@@ -1675,6 +876,10 @@ void OnlineGame::on_btnMyUndo_clicked()
     m_myBoard->m_grid = snapshot.grid;
     m_myScore = snapshot.score;
 
+    Protocol::GameMove op;
+    op.op = "undo";
+    queueMyOp(op);
+
     updateMyInfo();
     rebuildMyGrid();
     syncMyBoard();
@@ -1771,91 +976,63 @@ void OnlineGame::on_btnMySkill_clicked()
 
         connect(skillBtn, &QPushButton::clicked, skillDialog, [this, skill, skillDialog]() {
             skillDialog->accept();
+            skipMyEventsToEnd();   // 技能作用在结算后的棋盘上，没播完的先快进
 
             // 使用技能
-            // 【联机对战特殊处理】技能释放后需要同步状态
-            if (skill->id == "row_clear") {
-                int row = QRandomGenerator::global()->bounded(ROW);
-                playMySpecialEffect(RowBomb, QPoint(row, 0), 0);
-                QSet<QPoint> pts;
-                for (int c = 0; c < COL; ++c) {
-                    if (m_myBoard->m_grid[row][c].pic != -1) {
-                        pts.insert(QPoint(row, c));
-                    }
-                }
-                if (!pts.isEmpty()) playMyEliminateAnim(pts);
+            // 【联机对战特殊处理】改棋盘的技能作为操作同步，对手端用同一随机数流重放
+            static const QStringList boardSkills = {
+                "row_clear", "rainbow_bomb", "cross_clear", "color_unify", "ultimate_burst"
+            };
+            if (boardSkills.contains(skill->id)) {
+                Protocol::GameMove op;
+                op.op = "skill";
+                op.skill = skill->id;
+                queueMyOp(op);
+            }
 
-            } else if (skill->id == "time_extend") {
+            if (skill->id == "time_extend") {
                 m_totalTime += 5;
                 updateCountdown();
                 showTempMessage("TIME+5s", QColor(0, 229, 255));
-            } else if (skill->id == "rainbow_bomb") {
-                int color = QRandomGenerator::global()->bounded(6);
-                playMySpecialEffect(ColorClear, QPoint(ROW/2, COL/2), color);
-                QSet<QPoint> pts;
-                for (int r = 0; r < ROW; ++r) {
-                    for (int c = 0; c < COL; ++c) {
-                        if (m_myBoard->m_grid[r][c].pic == color) {
-                            pts.insert(QPoint(r, c));
-                        }
-                    }
-                }
-                if (!pts.isEmpty()) playMyEliminateAnim(pts);
-
-            } else if (skill->id == "cross_clear") {
-                int cR = QRandomGenerator::global()->bounded(ROW);
-                int cC = QRandomGenerator::global()->bounded(COL);
-                playMySpecialEffect(RowBomb, QPoint(cR, cC), 0);
-                playMySpecialEffect(ColBomb, QPoint(cR, cC), 0);
-                QSet<QPoint> pts;
-                for (int c=0; c<COL; ++c) if (m_myBoard->m_grid[cR][c].pic != -1) pts.insert(QPoint(cR, c));
-                for (int r=0; r<ROW; ++r) if (m_myBoard->m_grid[r][cC].pic != -1) pts.insert(QPoint(r, cC));
-                if (!pts.isEmpty()) playMyEliminateAnim(pts);
-
             } else if (skill->id == "score_double") {
                 m_myScoreDoubleActive = true;
                 m_mySkillEffectTimer->start(8000);
                 showTempMessage("DOUBLE SCORE (8s)", QColor(0, 229, 255));
-
-            } else if (skill->id == "color_unify") {
-                m_myColorUnifyActive = true;
-                m_mySkillEffectTimer->start(6000);
-                playMySpecialEffect(ColorClear, QPoint(0,0), 0);
-                int c1 = QRandomGenerator::global()->bounded(6);
-                int c2 = QRandomGenerator::global()->bounded(6);
-                int c3 = QRandomGenerator::global()->bounded(6);
-                for (int r = 0; r < ROW; ++r) {
-                    for (int c = 0; c < COL; ++c) {
-                        if (m_myBoard->m_grid[r][c].pic != -1) {
-                            int ch = QRandomGenerator::global()->bounded(3);
-                            m_myBoard->m_grid[r][c].pic = (ch == 0 ? c1 : (ch == 1 ? c2 : c3));
-                        }
-                    }
-                }
-                showTempMessage("UNIFY COLOR (6s)", QColor(0, 229, 255));
-                rebuildMyGrid();
-
             } else if (skill->id == "time_freeze") {
                 m_totalTime += 15;
                 updateCountdown();
                 showTempMessage("TIME+15s", QColor(0, 229, 255));
-
-            } else if (skill->id == "ultimate_burst") {
-                QSet<QPoint> pts;
-                m_myUltimateBurstActive = true;
-                playMySpecialEffect(ColorClear, QPoint(0,0), 0);
-                for (int r = 0; r < ROW; ++r) {
-                    for (int c = 0; c < COL; ++c) {
-                        if (m_myBoard->m_grid[r][c].pic != -1) {
-                            pts.insert(QPoint(r, c));
-                        }
+            } else if (boardSkills.contains(skill->id)) {
+                SkillCast cast = castSkill(skill->id, m_myBoard->m_grid, m_myRng);
+                if (cast.recolored || cast.points.isEmpty()) {
+                    // 整盘换色要先重建（重建会清掉棋盘上的特效），特效和提示放在后面
+                    if (cast.recolored) rebuildMyGrid();
+                    for (const CascadeResolver::Effect &fx : cast.effects) {
+                        playMySpecialEffect(fx.type, fx.center, cast.color);
                     }
                 }
-                int sc = 3200;
-                if (m_myScoreDoubleActive) sc *= 2;
-                m_myScore += sc;
-                updateMyInfo();
-                if (!pts.isEmpty()) playMyEliminateAnim(pts);
+
+                if (skill->id == "color_unify") {
+                    m_myColorUnifyActive = true;
+                    m_mySkillEffectTimer->start(6000);
+                    showTempMessage("UNIFY COLOR (6s)", QColor(0, 229, 255));
+                } else if (skill->id == "ultimate_burst") {
+                    m_myUltimateBurstActive = true;
+                    int sc = 3200;
+                    if (m_myScoreDoubleActive) sc *= 2;
+                    m_myScore += sc;
+                    updateMyInfo();
+                }
+
+                if (!cast.recolored && !cast.points.isEmpty()) {
+                    // 和对手端重放一样：消除、下落、连消一次结算完，特效随消除事件播放
+                    Grid g = m_myBoard->grid();
+                    const QVector<CascadeResolver::Event> events =
+                        m_myResolver->resolveClear(g, cast.points, cast.effects);
+                    m_myBoard->m_grid = g;
+                    m_myLocked = events.last().dead;   // 稳定时再同步；死局锁到洗牌
+                    playMyEvents(events);
+                }
             }
 
             skill->used = true;
@@ -1916,131 +1093,366 @@ void OnlineGame::onMySkillEffectTimeout()
 
 void OnlineGame::showSkillEndHint(const QString& message)
 {
-    QLabel* hintLabel = new QLabel(ui->myBoardContainer);
-    hintLabel->setText(message);
-    hintLabel->setAlignment(Qt::AlignCenter);
-    hintLabel->setStyleSheet(
-        "background-color: rgba(0, 0, 0, 180);"
-        "color: #00e5ff;"
-        "font: bold 16pt 'Microsoft YaHei';"
-        "border-radius: 8px;"
-        "border: 1px solid #00e5ff;"
-        "padding: 10px;"
-        );
+    // 半透明框，显示在我方棋盘上方
+    BoardView::Banner banner;
+    banner.text = message;
+    banner.color = QColor("#00e5ff");
+    banner.pointSize = 16;
+    banner.boxed = true;
+    banner.border = 1;
+    banner.radius = 8;
+    banner.padding = QSize(10, 10);
+    banner.width = m_myView->width() * 0.8;
+    banner.top = 20;
+    banner.fadeIn = 500;
+    banner.hold = 2000;
+    banner.fadeOut = 500;
+    m_myView->showBanner(banner);
+}
 
-    QRect boardRect = ui->myBoardContainer->rect();
-    int labelWidth = boardRect.width() * 0.8;
-    int labelHeight = 50;
-    int labelX = boardRect.left() + (boardRect.width() - labelWidth) / 2;
-    int labelY = boardRect.top() + 20;
-
-    hintLabel->setGeometry(labelX, labelY, labelWidth, labelHeight);
-    hintLabel->show();
-    hintLabel->raise();
-    hintLabel->setAttribute(Qt::WA_TransparentForMouseEvents);
-
-    QGraphicsOpacityEffect* effect = new QGraphicsOpacityEffect(hintLabel);
-    hintLabel->setGraphicsEffect(effect);
-
-    QSequentialAnimationGroup* animGroup = new QSequentialAnimationGroup(this);
-
-    QPropertyAnimation* fadeIn = new QPropertyAnimation(effect, "opacity");
-    fadeIn->setDuration(500);
-    fadeIn->setStartValue(0.0);
-    fadeIn->setEndValue(1.0);
-    fadeIn->setEasingCurve(QEasingCurve::InOutQuad);
-    animGroup->addAnimation(fadeIn);
-
-    animGroup->addPause(2000);
-
-    QPropertyAnimation* fadeOut = new QPropertyAnimation(effect, "opacity");
-    fadeOut->setDuration(500);
-    fadeOut->setStartValue(1.0);
-    fadeOut->setEndValue(0.0);
-    fadeOut->setEasingCurve(QEasingCurve::InOutQuad);
-    animGroup->addAnimation(fadeOut);
-
-    connect(animGroup, &QAbstractAnimation::finished, this, [hintLabel, animGroup]() {
-        hintLabel->deleteLater();
-        animGroup->deleteLater();
-    });
+void OnlineGame::showTempMessage(const QString& message, const QColor& color)
+{
+    // 快速淡入淡出，停留 1.5 秒
+    BoardView::Banner banner;
+    banner.text = message;
+    banner.color = color;
+    banner.pointSize = 24;
+    banner.fadeIn = 300;
+    banner.hold = 1500;
+    banner.fadeOut = 300;
+    m_myView->showBanner(banner);
+}
+
+// =============== 网络同步 ===============
+// 技能的随机部分：我方释放和对手端重放走同一段代码、同一条随机数流
+OnlineGame::SkillCast OnlineGame::castSkill(const QString &skillId, Grid &g, QRandomGenerator &rng)
+{
+    SkillCast cast;
+
+    if (skillId == "row_clear") {
+        int row = rng.bounded(ROW);
+        cast.effects.append({CascadeResolver::RowBomb, QPoint(row, 0)});
+        for (int c = 0; c < COL; ++c)
+            if (g[row][c].pic != -1) cast.points.insert(QPoint(row, c));
+
+    } else if (skillId == "rainbow_bomb") {
+        cast.color = rng.bounded(COLOR_COUNT);
+        cast.effects.append({CascadeResolver::ColorClear, QPoint(ROW / 2, COL / 2)});
+        for (int r = 0; r < ROW; ++r)
+            for (int c = 0; c < COL; ++c)
+                if (g[r][c].pic == cast.color) cast.points.insert(QPoint(r, c));
+
+    } else if (skillId == "cross_clear") {
+        int cR = rng.bounded(ROW);
+        int cC = rng.bounded(COL);
+        cast.effects.append({CascadeResolver::RowBomb, QPoint(cR, cC)});
+        cast.effects.append({CascadeResolver::ColBomb, QPoint(cR, cC)});
+        for (int c = 0; c < COL; ++c) if (g[cR][c].pic != -1) cast.points.insert(QPoint(cR, c));
+        for (int r = 0; r < ROW; ++r) if (g[r][cC].pic != -1) cast.points.insert(QPoint(r, cC));
+
+    } else if (skillId == "color_unify") {
+        cast.effects.append({CascadeResolver::ColorClear, QPoint(0, 0)});
+        int c1 = rng.bounded(COLOR_COUNT);
+        int c2 = rng.bounded(COLOR_COUNT);
+        int c3 = rng.bounded(COLOR_COUNT);
+        for (int r = 0; r < ROW; ++r) {
+            for (int c = 0; c < COL; ++c) {
+                if (g[r][c].pic != -1) {
+                    int ch = rng.bounded(3);
+                    g[r][c].pic = (ch == 0 ? c1 : (ch == 1 ? c2 : c3));
+                }
+            }
+        }
+        cast.recolored = true;
+
+    } else if (skillId == "ultimate_burst") {
+        cast.effects.append({CascadeResolver::ColorClear, QPoint(0, 0)});
+        for (int r = 0; r < ROW; ++r)
+            for (int c = 0; c < COL; ++c)
+                if (g[r][c].pic != -1) cast.points.insert(QPoint(r, c));
+    }
 
-    animGroup->start(QAbstractAnimation::DeleteWhenStopped);
+    return cast;
 }
 
-void OnlineGame::showTempMessage(const QString& message, const QColor& color)
+void OnlineGame::queueMyOp(const Protocol::GameMove &op)
 {
-    if (!ui->myBoardContainer) return;
-
-    QLabel* lbl = new QLabel(ui->myBoardContainer);
-    lbl->setText(message);
-    lbl->setAlignment(Qt::AlignCenter);
-    QString colorStr = QString("rgb(%1, %2, %3)").arg(color.red()).arg(color.green()).arg(color.blue());
-    lbl->setStyleSheet(
-        QString(
-            "color: %1;"
-            "font: bold 24pt 'Microsoft YaHei';"
-            "background: transparent;"
-            ).arg(colorStr)
-        );
+    if (m_lockstep) m_myPendingOp = op;
+}
 
-    lbl->adjustSize();
-    QRect cr = ui->myBoardContainer->rect();
-    lbl->move((cr.width() - lbl->width()) / 2, (cr.height() - lbl->height()) / 2);
-    lbl->show();
-    lbl->setAttribute(Qt::WA_TransparentForMouseEvents);
+// 棋盘稳定后调用：发出本轮积攒的操作，或者对手要的快照
+void OnlineGame::flushMyOp()
+{
+    if (m_snapshotRequested) {
+        m_myPendingOp = Protocol::GameMove();      // 快照已经包含这一步的结果
+        sendMySnapshot();
+    } else if (!m_myPendingOp.op.isEmpty()) {
+        Protocol::GameMove op = m_myPendingOp;
+        m_myPendingOp = Protocol::GameMove();
+        sendMyOp(op);
+    }
+}
 
-    QGraphicsOpacityEffect* eff = new QGraphicsOpacityEffect(lbl);
-    lbl->setGraphicsEffect(eff);
+void OnlineGame::sendMyOp(Protocol::GameMove op)
+{
+    NetworkManager *networkManager = NetworkManager::instance();
+    if (!networkManager || !networkManager->isConnected()) return;
 
-    QSequentialAnimationGroup* seq = new QSequentialAnimationGroup(this);
+    op.roomId = m_roomId;
+    op.player = m_myUsername;
+    op.seq = ++m_mySeq;
+    op.score = m_myScore;
+    if (m_mySeq % MatchSync::HashInterval == 0) {
+        op.hash = MatchSync::gridHash(m_myBoard->grid());
+    }
+    networkManager->sendGameMove(op);
+}
 
-    QPropertyAnimation* fadeIn = new QPropertyAnimation(eff, "opacity");
-    fadeIn->setDuration(300);
-    fadeIn->setStartValue(0.0);
-    fadeIn->setEndValue(1.0);
-    fadeIn->setEasingCurve(QEasingCurve::OutQuad);
-    seq->addAnimation(fadeIn);
+void OnlineGame::sendMySnapshot()
+{
+    m_snapshotRequested = false;
+
+    // 快照后双方改用新种子，失配之前的随机数流状态不再重要；撤步记录也一起作废
+    const quint32 seed = QRandomGenerator::global()->generate();
+    m_myRng.seed(seed);
+    m_myUndoStack.clear();
+
+    Protocol::GameMove op;
+    op.op = "snapshot";
+    op.board = BoardCodec::toJson(m_myBoard->grid());
+    op.seed = seed;
+    sendMyOp(op);
+}
 
-    seq->addPause(1500);
+void OnlineGame::requestOpponentSnapshot(const QString &reason)
+{
+    if (m_awaitingSnapshot) return;
+    LOG_INFO("sync", "对手棋盘失配，请求快照: %1", reason);
+    m_awaitingSnapshot = true;
 
-    QPropertyAnimation* fadeOut = new QPropertyAnimation(eff, "opacity");
-    fadeOut->setDuration(300);
-    fadeOut->setStartValue(1.0);
-    fadeOut->setEndValue(0.0);
-    fadeOut->setEasingCurve(QEasingCurve::InQuad);
-    seq->addAnimation(fadeOut);
+    NetworkManager *networkManager = NetworkManager::instance();
+    if (!networkManager || !networkManager->isConnected()) return;
+
+    // 控制消息，不占对手的操作序号
+    Protocol::GameMove req;
+    req.roomId = m_roomId;
+    req.player = m_myUsername;
+    req.op = "snapshot_req";
+    networkManager->sendGameMove(req);
+}
 
-    connect(seq, &QAbstractAnimation::finished, this, [lbl, seq]() {
-        lbl->deleteLater();
-        seq->deleteLater();
-    });
+void OnlineGame::applyOpponentOp(const Protocol::GameMove &msg)
+{
+    using Event = CascadeResolver::Event;
+    const QString &op = msg.op;
+    const int seq = msg.seq;
+
+    if (op == "snapshot_req") {
+        // 对手要我方快照：棋盘稳定时立即发，否则等这轮连消结束
+        m_snapshotRequested = true;
+        syncMyBoard();
+        return;
+    }
+
+    Grid &g = m_opponentBoard->m_grid;
+
+    if (op == "snapshot") {
+        if (!BoardCodec::fromJson(msg.board, g)) return;
+        m_opponentRng.seed(quint32(msg.seed));
+        m_opponentUndoStack.clear();
+        m_opponentSeq = seq;
+        m_awaitingSnapshot = false;
+        enqueueOpponentBoard(g);
+    } else {
+        if (m_awaitingSnapshot) return;
+        if (seq != m_opponentSeq + 1) {
+            requestOpponentSnapshot(QString("序号不连续 %1 -> %2").arg(m_opponentSeq).arg(seq));
+            return;
+        }
+        m_opponentSeq = seq;
+
+        QVector<Event> events;
+        if (op == "swap") {
+            const QJsonArray &mv = msg.mv;
+            int r1 = mv.at(0).toInt(-1), c1 = mv.at(1).toInt(-1);
+            int r2 = mv.at(2).toInt(-1), c2 = mv.at(3).toInt(-1);
+            bool inside = r1 >= 0 && r1 < ROW && c1 >= 0 && c1 < COL
+                          && r2 >= 0 && r2 < ROW && c2 >= 0 && c2 < COL;
+            if (mv.size() != 4 || !inside || qAbs(r1 - r2) + qAbs(c1 - c2) != 1) {
+                requestOpponentSnapshot("非法交换");
+                return;
+            }
+            m_opponentUndoStack.push(g);
+            events = m_opponentResolver->resolveSwap(g, r1, c1, r2, c2);
+        } else if (op == "skill") {
+            SkillCast cast = castSkill(msg.skill, g, m_opponentRng);
+            if (cast.recolored) {
+                Event ev;
+                ev.type = Event::Swap;
+                ev.a = ev.b = QPoint(-1, -1);
+                ev.grid = g;
+                events.append(ev);
+            } else {
+                events = m_opponentResolver->resolveClear(g, cast.points, cast.effects);
+            }
+        } else if (op == "undo") {
+            if (!m_opponentUndoStack.isEmpty()) g = m_opponentUndoStack.pop();
+            enqueueOpponentBoard(g);
+        }
 
-    seq->start();
+        // 与我方流程一致：连消结束是死局就用同一条随机数流洗牌
+        bool dead = !events.isEmpty() && events.last().type == Event::Settled && events.last().dead;
+        for (const Event &ev : events) enqueueOpponentEvent(ev);
+        if (dead) {
+            m_opponentBoard->initNoThree();
+            enqueueOpponentBoard(g);
+        }
+
+        if (msg.hash >= 0 && quint32(msg.hash) != MatchSync::gridHash(g)) {
+            requestOpponentSnapshot(QString("哈希不一致 seq=%1").arg(seq));
+        }
+    }
+
+    if (msg.score >= 0) m_opponentScore = msg.score;
+    updateOpponentInfo();
+
+    scheduleOpponentPlayback();
+}
+
+/* 对手回放节奏：积压不超过 OpponentLagTargetMs 时按原速播；超过后按积压比例加速，
+ * 最快 OpponentMaxRate 倍；积压超过 OpponentLagMaxMs 时丢掉中间状态，直接下落到最新棋盘。
+ * 所以镜像最多落后一个正在播的动画加上 OpponentLagMaxMs / OpponentMaxRate */
+static const int OpponentLagTargetMs = 600;
+static const int OpponentLagMaxMs = 2000;
+static const qreal OpponentMaxRate = 4.0;
+
+// 事件按 1x 播放的大致时长，与 BoardView 各动画一致
+static int opponentEventCostMs(const CascadeResolver::Event &ev)
+{
+    switch (ev.type) {
+    case CascadeResolver::Event::Swap:      return ev.a.x() < 0 ? 1500 : 0;   // 整盘掉落
+    case CascadeResolver::Event::Eliminate: return 250;
+    case CascadeResolver::Event::Fall:      return 500;
+    case CascadeResolver::Event::Settled:   break;
+    }
+    return 0;
+}
+
+void OnlineGame::enqueueOpponentBoard(const Grid &g)
+{
+    // a 为 (-1,-1) 的 Swap 事件表示整盘替换
+    CascadeResolver::Event ev;
+    ev.type = CascadeResolver::Event::Swap;
+    ev.a = ev.b = QPoint(-1, -1);
+    ev.grid = g;
+    enqueueOpponentEvent(ev);
+}
+
+void OnlineGame::enqueueOpponentEvent(const CascadeResolver::Event &ev)
+{
+    m_opponentEvents.enqueue(ev);
+    m_opponentBacklogMs += opponentEventCostMs(ev);
+}
+
+void OnlineGame::scheduleOpponentPlayback()
+{
+    if (m_opponentBacklogMs > OpponentLagMaxMs) coalesceOpponentEvents();
+    if (!m_opponentLocked) playNextOpponentEvent();
+}
+
+void OnlineGame::coalesceOpponentEvents()
+{
+    using Event = CascadeResolver::Event;
+    if (m_opponentEvents.size() <= 1) return;
+
+    // 每个事件都带着结束后的棋盘，最后一个就是最新状态；
+    // 用一次下落过去：颜色没变的格子原地不动，变了的直接换色，新空位从顶部补入
+    Event jump;
+    jump.type = Event::Fall;
+    jump.grid = m_opponentEvents.last().grid;
+
+    LOG_DEBUG("sync", "对手回放积压 %1 ms，合并 %2 个事件", m_opponentBacklogMs, m_opponentEvents.size());
+
+    m_opponentEvents.clear();
+    m_opponentBacklogMs = 0;
+    enqueueOpponentEvent(jump);
+}
+
+void OnlineGame::playNextOpponentEvent()
+{
+    using Event = CascadeResolver::Event;
+    if (m_opponentEvents.isEmpty()) {
+        m_opponentLocked = false;
+        m_opponentBacklogMs = 0;
+        m_opponentView->tweens()->setSpeed(1.0);
+        return;
+    }
+    m_opponentLocked = true;
+
+    // 倍速按包含这一段在内的积压算，播这一段的同时把后面的追回来
+    const qreal rate = qBound<qreal>(1.0, qreal(m_opponentBacklogMs) / OpponentLagTargetMs, OpponentMaxRate);
+    m_opponentView->tweens()->setSpeed(rate);
+
+    const Event ev = m_opponentEvents.dequeue();
+    m_opponentBacklogMs = qMax(0, m_opponentBacklogMs - opponentEventCostMs(ev));
+
+    switch (ev.type) {
+    case Event::Swap:
+        m_opponentView->setGrid(ev.grid);
+        if (ev.a.x() < 0) {
+            m_opponentView->playDropIn(200, -1, [this]() { playNextOpponentEvent(); });
+        } else {
+            QTimer::singleShot(0, this, [this]() { playNextOpponentEvent(); });
+        }
+        break;
+    case Event::Eliminate:
+        // 追帧时特效跟不上方块节奏，只在原速时播
+        if (rate <= 1.0) {
+            for (const CascadeResolver::Effect &fx : ev.effects) {
+                playOpponentSpecialEffect(fx.type, fx.center, 0);
+            }
+        }
+        m_opponentView->playEliminate(ev.points, [this]() { playNextOpponentEvent(); });
+        break;
+    case Event::Fall:
+        m_opponentView->playFall(ev.grid, [this]() { playNextOpponentEvent(); });
+        break;
+    case Event::Settled:
+        if (m_opponentEvents.isEmpty()) MusicManager::instance().playMatchSound(1); // 轻微音效提示
+        QTimer::singleShot(0, this, [this]() { playNextOpponentEvent(); });
+        break;
+    }
 }
 
-// =============== 网络同步 ===============
 void OnlineGame::syncMyBoard()
 {
-    // 基础检查：游戏未激活或锁定时不发送
-    if (!m_isGameActive || m_myLocked || m_myPaused) {
-        qDebug() << "跳过同步: 游戏未激活或棋盘锁定";
+    if (m_lockstep) {
+        // 确定性同步：只在棋盘稳定时发出积攒的操作，整盘快照只在对手请求时发
+        if (m_isGameActive && !m_myLocked && !m_myPaused) flushMyOp();
         return;
     }
 
-    // 发送频率限制（最小300ms间隔）
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    if (currentTime - m_lastSyncTime < 300) {
-        qDebug() << "跳过同步: 发送频率过高";
+    // 基础检查：游戏未激活或锁定时不发送
+    if (!m_isGameActive || m_myLocked || m_myPaused) {
+        LOG_TRACE("sync", "跳过同步: 游戏未激活或棋盘锁定");
         return;
     }
 
     NetworkManager *networkManager = NetworkManager::instance();
     if (!networkManager || !networkManager->isConnected()) {
-        qDebug() << "跳过同步: 网络未连接";
+        LOG_TRACE("sync", "跳过同步: 网络未连接");
         return;
     }
 
+    // 发送频率限制：间隔随链路 RTT 调整；间隔内的变化推迟到间隔结束再发，不丢最终状态
+    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+    const qint64 wait = m_lastSyncTime + networkManager->recommendedSyncIntervalMs() - currentTime;
+    if (wait > 0) {
+        if (!m_syncTimer->isActive()) m_syncTimer->start(int(wait));
+        return;
+    }
+    m_syncTimer->stop();
+
     // 检查棋盘是否有有效方块
     bool hasValidTiles = false;
     for (int r = 0; r < ROW; ++r) {
@@ -2054,7 +1466,7 @@ void OnlineGame::syncMyBoard()
     }
 
     if (!hasValidTiles) {
-        qDebug() << "跳过同步: 棋盘无有效方块";
+        LOG_TRACE("sync", "跳过同步: 棋盘无有效方块");
         return;
     }
 
@@ -2062,11 +1474,11 @@ void OnlineGame::syncMyBoard()
     if (!m_hasInitialSync) {
         // 首次同步总是发送
         m_hasInitialSync = true;
-        qDebug() << "首次同步: 发送初始状态";
+        LOG_DEBUG("sync", "首次同步: 发送初始状态");
     } else if (m_myScore <= m_lastSyncedScore) {
         // 分数没有增加，检查棋盘是否有变化
         bool boardChanged = false;
-        QJsonArray currentBoardArray = boardToJsonArray(m_myBoard->grid());
+        QJsonArray currentBoardArray = BoardCodec::toJson(m_myBoard->grid());
 
         // 比较当前棋盘和上次同步的棋盘
         if (currentBoardArray.size() == m_lastBoardArray.size()) {
@@ -2081,77 +1493,83 @@ void OnlineGame::syncMyBoard()
         }
 
         if (!boardChanged) {
-            qDebug() << "跳过同步: 分数未增加且棋盘无变化";
+            LOG_TRACE("sync", "跳过同步: 分数未增加且棋盘无变化");
             return;
         }
-        qDebug() << "棋盘发生变化，同步: 分数" << m_myScore << "->" << m_lastSyncedScore;
+        LOG_TRACE("sync", "棋盘发生变化，同步: 分数 %1 -> %2", m_lastSyncedScore, m_myScore);
     }
 
     // 记录当前状态
     m_lastSyncedScore = m_myScore;
     m_lastSyncedGrid = m_myBoard->grid();  // 假设Grid有拷贝构造函数
-    m_lastBoardArray = boardToJsonArray(m_myBoard->grid());
+    m_lastBoardArray = BoardCodec::toJson(m_myBoard->grid());
     m_lastSyncTime = currentTime;
 
     // 构建同步消息
-    QJsonObject syncData;
-    syncData["type"] = "game_move";
-    if (!m_roomId.isEmpty()) {
-        syncData["room_id"] = m_roomId;
-    }
-    syncData["board"] = m_lastBoardArray;
-    syncData["score"] = m_myScore;
-    syncData["player"] = m_myUsername;
-    syncData["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-
-    // 添加调试信息
-    static int syncCounter = 0;
-    syncCounter++;
-    qDebug() << "=== 发送同步 #" << syncCounter << " ===";
-    qDebug() << "分数:" << m_myScore;
-    qDebug() << "分数增加:" << (m_myScore > m_lastSyncedScore);
+    Protocol::GameMove syncData;
+    syncData.roomId = m_roomId;
+    syncData.board = m_lastBoardArray;
+    syncData.score = m_myScore;
+    syncData.player = m_myUsername;
+    syncData.timestamp = QDateTime::currentDateTime().toString(Qt::ISODate);
+
+    LOG_DEBUG("sync", "发送整盘同步，分数 %1", m_myScore);
 
     // 发送消息
-    networkManager->sendRawJson(syncData);
+    networkManager->sendGameMove(syncData);
 }
 
-QJsonArray OnlineGame::boardToJsonArray(const Grid &grid)
+// =============== 断线重连 ===============
+void OnlineGame::onConnectionLost(int graceSecs)
 {
-    QJsonArray boardArray;
-
-    for (int r = 0; r < ROW; ++r) {
-        for (int c = 0; c < COL; ++c) {
-            boardArray.append(grid[r][c].pic);
-        }
-    }
-
-    return boardArray;
+    if (m_gameEnded) return;
+    // 本地照常玩，重连后用快照把对手那边对齐
+    showTempMessage(QString("连接中断，%1 秒内自动重连...").arg(graceSecs), QColor("#FF9800"));
 }
 
-void OnlineGame::jsonArrayToBoard(const QJsonArray &array, Grid &grid)
+void OnlineGame::onSessionResumed(bool success, const Protocol::ResumeResult &result)
 {
-    int index = 0;
-    for (int r = 0; r < ROW; ++r) {
-        for (int c = 0; c < COL; ++c) {
-            if (index < array.size()) {
-                grid[r][c].pic = array[index].toInt();
-                index++;
-            }
+    if (m_gameEnded) return;
+    if (!success) {
+        showTempMessage("重连失败，对局已中断", QColor("#FF5555"));
+        return;
+    }
+    showTempMessage("已重新连接", QColor("#4CAF50"));
+    if (!result.roomId.isEmpty()) m_roomId = result.roomId;
+
+    if (m_lockstep) {
+        // 断线期间发出的操作都丢了：等棋盘稳定后发一份快照让对手对齐；
+        // 对手的操作由服务器补发，补发不全（或断线时的快照请求没发出去）就重新要快照
+        m_snapshotRequested = true;
+        syncMyBoard();
+        if (result.missedTruncated || m_awaitingSnapshot) {
+            m_awaitingSnapshot = false;
+            requestOpponentSnapshot("断线重连");
         }
+        return;
+    }
+
+    // 整盘同步：立即补发我方棋盘，对手棋盘以服务器记录的最后一份为准
+    m_hasInitialSync = false;
+    m_lastSyncTime = 0;
+    syncMyBoard();
+    if (!result.opponentBoard.isEmpty()) {
+        updateOpponentFromNetwork(result.opponentBoard,
+                                  result.opponentScore >= 0 ? result.opponentScore : m_opponentScore);
     }
 }
 
-// =============== 网络消息处理 ===============
-void OnlineGame::onServerMessage(const QString &type, const QJsonObject &data)
+void OnlineGame::onOpponentLinkChanged(const QString &player, const QString &state, int graceSecs)
 {
-    qDebug() << "OnlineGame received message:" << type;
+    if (player != m_opponentUsername || m_gameEnded) return;
 
-    if (type == "game_start") {
-        onGameStartReceived(data);
-    } else if (type == "game_move") {
-        onGameMoveReceived(data);
-    } else if (type == "game_end") {
-        onGameEndReceived(data);
+    if (state == "lost") {
+        ui->labelOpponentStatus->setText(QString("对手连接中断\n等待重连（%1 秒）").arg(graceSecs));
+    } else if (state == "restored") {
+        ui->labelOpponentStatus->setText("对手已重新连接");
+        updateLinkStats();
+    } else if (state == "expired") {
+        ui->labelOpponentStatus->setText("对手已断开");
     }
 }
 
@@ -2167,68 +1585,44 @@ void OnlineGame::onGameStartReceived(const QJsonObject &data)
     });
 }
 
-void OnlineGame::onGameMoveReceived(const QJsonObject &messageData)
+void OnlineGame::onGameMoveReceived(const Protocol::GameMove &move)
 {
-    qDebug() << "=== OnlineGame收到game_move消息 ===";
+    LOG_TRACE("sync", "收到game_move op=%1 seq=%2", move.op, move.seq);
 
-    QJsonObject dataToCheck = messageData;
+    // 判断消息来源
+    const QString sourcePlayer = !move.player.isEmpty() ? move.player : move.opponent;
 
-    // 【关键修复】检查是否存在嵌套的data对象
-    if (messageData.contains("data") && messageData["data"].isObject()) {
-        // 如果有data对象，则使用data对象的内容
-        dataToCheck = messageData["data"].toObject();
-        qDebug() << "找到嵌套的data对象，使用内部数据";
+    // 如果是自己的消息，忽略
+    if (sourcePlayer == m_myUsername) {
+        LOG_TRACE("sync", "这是自己的消息，忽略");
+        return;
+    }
+    if (sourcePlayer != m_opponentUsername) {
+        LOG_WARN("sync", "不是目标对手的消息，当前对手 %1，消息来源 %2", m_opponentUsername, sourcePlayer);
+        return;
     }
 
-    // 现在检查board字段
-    if (dataToCheck.contains("board") && dataToCheck["board"].isArray()) {
-        QJsonArray boardArray = dataToCheck["board"].toArray();
-        qDebug() << "成功获取board字段，数组大小:" << boardArray.size();
-
-        // 检查是否是对手的消息
-        QString player;
-        if (dataToCheck.contains("player")) {
-            player = dataToCheck["player"].toString();
-            qDebug() << "消息中的玩家:" << player;
-        }
-
-        QString opponent;
-        if (dataToCheck.contains("opponent")) {
-            opponent = dataToCheck["opponent"].toString();
-            qDebug() << "消息中的对手:" << opponent;
-        }
-
-        // 判断消息来源
-        QString sourcePlayer = !player.isEmpty() ? player : opponent;
-
-        // 如果是自己的消息，忽略
-        if (sourcePlayer == m_myUsername) {
-            qDebug() << "这是自己的消息，忽略";
-            return;
-        }
-
-        // 如果是对手的消息，更新棋盘
-        if (sourcePlayer == m_opponentUsername) {
-            int score = 0;
-            if (dataToCheck.contains("score")) {
-                score = dataToCheck["score"].toInt();
-            }
+    // 局末分数：只更新分数，不占操作序号
+    if (move.op == "final") {
+        if (move.score >= 0) m_opponentScore = move.score;
+        updateOpponentInfo();
+        return;
+    }
 
-            qDebug() << "更新对手棋盘，分数:" << score;
-            updateOpponentFromNetwork(boardArray, score);
-        } else {
-            qDebug() << "不是目标对手的消息，当前对手:" << m_opponentUsername
-                     << "，消息来源:" << sourcePlayer;
-        }
-    } else {
-        qDebug() << "消息中没有board字段或格式不正确";
-        qDebug() << "messageData.keys():" << messageData.keys();
-        qDebug() << "dataToCheck.keys():" << dataToCheck.keys();
+    // 确定性同步的操作帧（快照也带 board，一并在这里处理）
+    if (!move.op.isEmpty()) {
+        applyOpponentOp(move);
+        return;
+    }
 
-        // 尝试打印整个消息以便调试
-        QJsonDocument doc(messageData);
-        qDebug() << "完整消息:" << doc.toJson(QJsonDocument::Compact);
+    if (move.board.isEmpty()) {
+        LOG_WARN("sync", "game_move 没有board字段或格式不正确，来源 %1", sourcePlayer);
+        return;
     }
+
+    const int score = move.score >= 0 ? move.score : 0;
+    LOG_DEBUG("sync", "更新对手棋盘，分数 %1", score);
+    updateOpponentFromNetwork(move.board, score);
 }
 
 // 添加玩家退出处理函数
@@ -2398,10 +1792,3 @@ void OnlineGame::endGameWithResult(bool isWinner)
     emit gameFinished();
 }
 
-QString OnlineGame::getCellImagePath(int colorIndex) const
-{
-    if (colorIndex < 0 || colorIndex >= 6) {
-        colorIndex = 0;
-    }
-    return QString("%1%2.png").arg(QDir::currentPath() + "/").arg(colorIndex);
-}
@@ -6,21 +6,22 @@
 #include <QPushButton>
 #include <QJsonArray>
 #include <QStack>
-#include <QSequentialAnimationGroup>
-#include <QPropertyAnimation>
-#include <QGraphicsDropShadowEffect>
-#include <QGraphicsOpacityEffect>
 #include <QVector>
-#include <QGridLayout>
 #include <QSet>
 #include <QPoint>
 #include <QQueue>
+#include <QRandomGenerator>
 
 #include "gameboard.h"
+#include "cascaderesolver.h"
 #include "skilltree.h"
 #include "networkmanager.h"
 #include "musicmanager.h"
 
+class BoardView;
+class TweenScheduler;
+class PerfMonitor;
+
 namespace Ui {
 class OnlineGame;
 }
@@ -45,13 +46,16 @@ private slots:
     void on_btnBack_clicked();
     void on_btnMyUndo_clicked();
     void on_btnMySkill_clicked();
+    void onMySpeedButtonClicked();   // 我方播放速度 1x -> 2x -> 4x -> 瞬间
 
     // 网络消息处理
-    void onServerMessage(const QString &type, const QJsonObject &data);
     void onGameStartReceived(const QJsonObject &data);
-    void onGameMoveReceived(const QJsonObject &massageData);
+    void onGameMoveReceived(const Protocol::GameMove &move);
     void onGameEndReceived(const QJsonObject &data);
     void onPlayerQuitReceived(const QJsonObject &data);
+    void onConnectionLost(int graceSecs);
+    void onSessionResumed(bool success, const Protocol::ResumeResult &result);
+    void onOpponentLinkChanged(const QString &player, const QString &state, int graceSecs);
 
 private:
     Ui::OnlineGame *ui;
@@ -82,19 +86,34 @@ private:
     GameBoard *m_opponentBoard;
     SkillTree *m_mySkillTree;
 
-    // 棋盘显示（我的棋盘）
-    QVector<QPushButton*> m_myCells;
-    QGridLayout *m_myGridLayout;
-    QSequentialAnimationGroup *m_myDropGroup;
+    // 确定性同步：双方用同一局种子，只传操作，对手棋盘在本地用结算引擎推演
+    bool m_lockstep;                          // 服务器下发了局种子才启用，否则退回整盘快照
+    QRandomGenerator m_myRng;                 // 我方开局、补位、技能随机都只用这条流
+    QRandomGenerator m_opponentRng;           // 对手那条流的本地副本
+    CascadeResolver *m_myResolver;            // 我方操作立即结算到稳定，和对手端推演同一套规则、同一条流
+    CascadeResolver *m_opponentResolver;
+    int m_mySeq;                              // 已发出的操作序号
+    int m_opponentSeq;                        // 已应用的对手操作序号
+    Protocol::GameMove m_myPendingOp;                // 本轮连消结束后再发（带结算后的分数和哈希）
+    bool m_snapshotRequested;                 // 对手请求快照，等我方棋盘稳定后发
+    bool m_awaitingSnapshot;                  // 对手棋盘已失配，等快照期间丢弃操作
+    QStack<Grid> m_opponentUndoStack;
+    QQueue<CascadeResolver::Event> m_myEvents;         // 我方结算出的事件，按顺序播放
+    QQueue<CascadeResolver::Event> m_opponentEvents;   // 待播放的对手状态（推演结果或网络快照），按顺序播放
+    int m_opponentBacklogMs;                  // 队列按 1x 播完还要多久，决定倍速和是否合并
+
+    // 棋盘显示（我的棋盘，整盘自绘）
+    enum MyBoardMarker { MySelectMarker };   // 我方棋盘上的选中光晕
+    BoardView *m_myView;
+    TweenScheduler *m_myTweens;      // 我方棋盘全部动画，由 m_myView 持有
+    PerfMonitor *m_perf;             // 性能面板
     bool m_myLocked;
     bool m_myPaused;
     int m_myClickCount;
     int m_mySelR, m_mySelC;
 
-    // 棋盘显示（对手棋盘）
-    QVector<QPushButton*> m_opponentCells;
-    QGridLayout *m_opponentGridLayout;
-    QSequentialAnimationGroup *m_opponentDropGroup;
+    // 棋盘显示（对手棋盘，只读镜像，整盘自绘）
+    BoardView *m_opponentView;
     bool m_opponentLocked;  // 新增：对手棋盘锁定状态
 
     // 技能状态
@@ -110,53 +129,45 @@ private:
     };
     QStack<GameStateSnapshot> m_myUndoStack;
 
-    // 消除结果枚举
-    enum EffectType { None, Normal, RowBomb, ColBomb, AreaBomb, ColorClear };
-    struct ElimResult {
-        QSet<QPoint> points;
-        EffectType type = None;
-        QPoint center = QPoint(-1, -1);
-    };
+    // 特效类型（消除判定在 CascadeResolver）
+    using EffectType = CascadeResolver::EffectType;
 
     // =============== 我的棋盘方法 ===============
     void initMyBoard();
     void rebuildMyGrid();
     void clearMyGridLayout();
-    void createMyDropAnimation(int left0, int top0);
+    void createMyDropAnimation();
     void handleMyCellClick(int r, int c);
-    void setMySelected(QPushButton *btn, bool on);
-    void playMyShake(QPushButton *btn);
+    void setMySelected(int r, int c, bool on);
     void processMyInteraction(int r1, int c1, int r2, int c2);
-    void performMyFallAnimation();
-    void checkMyComboMatches();
-    void playMyEliminateAnim(const QSet<QPoint>& points);
+    void playMyEvents(const QVector<CascadeResolver::Event> &events);
+    void playNextMyEvent();
+    void playMyEliminateAnim(const CascadeResolver::Event &ev);
+    void performMyFallAnimation(const CascadeResolver::Event &ev);
+    void onMyBoardSettled(const CascadeResolver::Event &ev);
+    void skipMyEventsToEnd();        // 新操作到来或切到瞬间：清空我方队列，直接摆出最终棋盘
+    void setMyPlaybackSpeed(int speed);
     void addMyScore(int count);
     void saveMyState();
 
-    // 消除检测
-    ElimResult getMyEliminations(int r, int c);
-    int countMyDirection(int r, int c, int dR, int dC);
     void playMySpecialEffect(EffectType type, QPoint center, int colorCode);
     void handleMyDeadlock();
 
     // =============== 对手棋盘方法 ===============
     void initOpponentBoard();
     void rebuildOpponentGrid();
-    void clearOpponentGridLayout();
-    void createOpponentDropAnimation(int left0, int top0);
     void updateOpponentFromNetwork(const QJsonArray &boardArray, int score);
 
     // 【新增】对手棋盘动画方法
-    void playOpponentEliminateAnim(const QSet<QPoint>& points);
-    void performOpponentFallAnimation();
     void playOpponentSpecialEffect(EffectType type, QPoint center, int colorCode);
-    void playOpponentCellShake(QPushButton *btn);
+    void playOpponentCellShake(int r, int c);
     void processOpponentUpdate(const Grid& oldGrid, const Grid& newGrid);
 
     // =============== 通用方法 ===============
     void updateUI();
     void updateMyInfo();
     void updateOpponentInfo();
+    void updateLinkStats();          // 链路延迟 / 抖动 / 丢包显示在对手状态栏
     void updateCountdown();
     void startGameSequence();
     void gameOver();
@@ -173,15 +184,32 @@ private:
     // 网络同步
     void syncMyBoard();
     void syncBoardToServer();
-    QJsonArray boardToJsonArray(const Grid &grid);
-    void jsonArrayToBoard(const QJsonArray &array, Grid &grid);
+
+    // 确定性同步
+    struct SkillCast {
+        QSet<QPoint> points;                      // 要消除的格子
+        QVector<CascadeResolver::Effect> effects; // 特效（只用于表现）
+        int color = 0;                            // 彩虹炸弹选中的颜色
+        bool recolored = false;                   // 变色类技能直接改了棋盘，不走消除
+    };
+    static SkillCast castSkill(const QString &skillId, Grid &g, QRandomGenerator &rng);
+    void queueMyOp(const Protocol::GameMove &op);
+    void flushMyOp();
+    void sendMySnapshot();
+    void sendMyOp(Protocol::GameMove op);
+    void applyOpponentOp(const Protocol::GameMove &msg);
+    void requestOpponentSnapshot(const QString &reason);
+    void enqueueOpponentBoard(const Grid &g);       // 整盘替换（洗牌、撤步、快照）
+    void enqueueOpponentEvent(const CascadeResolver::Event &ev);
+    void scheduleOpponentPlayback();                // 入队后调用：超出延迟上限先合并，空闲则开播
+    void coalesceOpponentEvents();
+    void playNextOpponentEvent();
 
     // 【新增】棋盘比较辅助函数
     void findDifferences(const Grid& oldGrid, const Grid& newGrid,
                          QSet<QPoint>& eliminated, QSet<QPoint>& newCells);
 
     // 辅助函数
-    QString getCellImagePath(int colorIndex) const;
 };
 
 #endif // ONLINE_GAME_H
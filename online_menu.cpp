@@ -27,6 +27,14 @@ OnlineMenu::OnlineMenu(QWidget *parent)
                 this, &OnlineMenu::onMatchCancelled);
         connect(m_networkManager, &NetworkManager::onlineListUpdated,
                 this, &OnlineMenu::onOnlineListUpdated);
+        connect(m_networkManager, &NetworkManager::presenceChanged,
+                this, &OnlineMenu::onPresenceChanged);
+        connect(m_networkManager, &NetworkManager::connectionLost,
+                this, &OnlineMenu::onConnectionLost);
+        connect(m_networkManager, &NetworkManager::reconnecting,
+                this, &OnlineMenu::onReconnecting);
+        connect(m_networkManager, &NetworkManager::sessionResumed,
+                this, [this](bool success) { onSessionResumed(success); });
 
         // 初始请求在线列表
         if (m_networkManager->isConnected()) {
@@ -230,13 +238,60 @@ void OnlineMenu::onMatchFound(const QString &player1, const QString &player2)
 void OnlineMenu::onMatchCancelled()
 {
     updateMatchStatus("匹配已取消");
+    resetMatchButtons();
+}
+
+void OnlineMenu::resetMatchButtons()
+{
     m_isMatching = false;
     ui->btnStartMatch->setVisible(true);
     ui->btnCancelMatch->setVisible(false);
     m_matchTimer->stop();
 }
 
+/* 断线重连：服务器在连接断开时已把匹配请求移出队列，这边同步回到未匹配状态 */
+void OnlineMenu::onConnectionLost(int graceSecs)
+{
+    resetMatchButtons();
+    updateMatchStatus(QString("连接中断，%1 秒内自动重连...").arg(graceSecs));
+}
+
+void OnlineMenu::onReconnecting(int secsLeft)
+{
+    updateMatchStatus(QString("正在重连服务器...（剩余 %1 秒）").arg(qMax(0, secsLeft)));
+}
+
+void OnlineMenu::onSessionResumed(bool success)
+{
+    if (!success) {
+        updateMatchStatus("重连失败，请重新登录");
+        return;
+    }
+    updateMatchStatus("已重新连接，等待开始匹配...");
+    m_networkManager->requestOnlineList();
+}
+
 void OnlineMenu::onOnlineListUpdated(const QJsonArray &users)
 {
-    updateOnlineUserCount(users.size());
+    m_onlineUsers.clear();
+    for (const QJsonValue &v : users) {
+        const QJsonObject user = v.toObject();
+        m_onlineUsers.insert(user["username"].toString(), user);
+    }
+    updateOnlineUserCount(m_onlineUsers.size());
+}
+
+void OnlineMenu::onPresenceChanged(const QJsonArray &added, const QJsonArray &updated, const QStringList &removed)
+{
+    // 只动变化的那几个人，不重建整张表
+    for (const QJsonValue &v : added) {
+        const QJsonObject user = v.toObject();
+        m_onlineUsers.insert(user["username"].toString(), user);
+    }
+    for (const QJsonValue &v : updated) {
+        const QJsonObject user = v.toObject();
+        m_onlineUsers.insert(user["username"].toString(), user);
+    }
+    for (const QString &name : removed) m_onlineUsers.remove(name);
+    updateOnlineUserCount(m_onlineUsers.size());
 }
@@ -5,6 +5,7 @@
 #include <QWidget>
 #include <QTimer>
 #include <QJsonArray>
+#include <QHash>
 #include "networkmanager.h"  // 新增
 
 namespace Ui {
@@ -35,6 +36,10 @@ private slots:
     void onMatchFound(const QString &player1, const QString &player2);
     void onMatchCancelled();
     void onOnlineListUpdated(const QJsonArray &users);
+    void onPresenceChanged(const QJsonArray &added, const QJsonArray &updated, const QStringList &removed);
+    void onConnectionLost(int graceSecs);
+    void onReconnecting(int secsLeft);
+    void onSessionResumed(bool success);
 
 private:
     Ui::OnlineMenu *ui;
@@ -43,8 +48,10 @@ private:
     bool m_isMatching;               // 是否正在匹配中
 
     NetworkManager *m_networkManager; // 网络管理器
+    QHash<QString, QJsonObject> m_onlineUsers;  // username -> 在线信息，快照整体替换，增量逐条改
 
     void updateMatchStatus(const QString &status);
+    void resetMatchButtons();
     void updateQueuePosition(int position);
     void updateOnlineUserCount(int count);
 };
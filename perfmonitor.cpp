@@ -0,0 +1,177 @@
+// perfmonitor.cpp
+#include "perfmonitor.h"
+#include "tweenscheduler.h"
+#include "cascaderesolver.h"
+#include "networkmanager.h"
+#include <QWidget>
+#include <QLabel>
+#include <QShortcut>
+#include <QDir>
+#include <QDateTime>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+const int kFrameWindow = 240;      // 约 4 秒 @60FPS
+const int kIdleGapMs = 250;        // 超过这个间隔视为动画已停过，不计入帧时间
+}
+
+PerfMonitor::PerfMonitor(QWidget *host, const QString &name)
+    : QObject(host), m_host(host), m_name(name)
+{
+    m_label = new QLabel(host);
+    m_label->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_label->setStyleSheet("background: rgba(0, 0, 0, 170); color: #7CFC00; "
+                           "font: 9pt 'Consolas'; padding: 6px; border-radius: 4px;");
+    m_label->move(8, 8);
+    m_label->hide();
+
+    m_frames.reserve(kFrameWindow);
+    m_clock.start();
+
+    m_refresh.setInterval(500);
+    connect(&m_refresh, &QTimer::timeout, this, &PerfMonitor::refresh);
+
+    auto *toggle = new QShortcut(QKeySequence(Qt::Key_F3), host);
+    connect(toggle, &QShortcut::activated, this, [this]() {
+        setOverlayVisible(m_label->isHidden());
+    });
+    auto *record = new QShortcut(QKeySequence(Qt::Key_F4), host);
+    connect(record, &QShortcut::activated, this, [this]() {
+        if (isRecording()) stopRecording();
+        else startRecording();
+    });
+}
+
+PerfMonitor::~PerfMonitor()
+{
+    stopRecording();
+}
+
+void PerfMonitor::watch(TweenScheduler *scheduler)
+{
+    connect(scheduler, &TweenScheduler::frameAdvanced, this, [this, scheduler](int active) {
+        onFrame(scheduler, active);
+    });
+}
+
+void PerfMonitor::watch(const CascadeResolver *resolver)
+{
+    m_resolvers.append(resolver);
+}
+
+void PerfMonitor::onFrame(QObject *source, int activeTweens)
+{
+    const qint64 now = m_clock.elapsed();
+    auto it = m_lastTick.find(source);
+    if (it != m_lastTick.end()) {
+        qint64 dt = now - it.value();
+        if (dt <= kIdleGapMs) {
+            if (m_frames.size() < kFrameWindow) m_frames.append(float(dt));
+            else m_frames[m_frameHead] = float(dt);
+            m_frameHead = (m_frameHead + 1) % kFrameWindow;
+        }
+    }
+    // 动画跑完就不再有下一帧，下次从头计
+    if (activeTweens == 0) m_lastTick.remove(source);
+    else m_lastTick[source] = now;
+    m_activeTweens[source] = activeTweens;
+}
+
+PerfMonitor::Snapshot PerfMonitor::snapshot() const
+{
+    Snapshot s;
+    if (!m_frames.isEmpty()) {
+        QVector<float> sorted = m_frames;
+        std::sort(sorted.begin(), sorted.end());
+        s.p50 = sorted[(sorted.size() - 1) * 50 / 100];
+        s.p99 = sorted[(sorted.size() - 1) * 99 / 100];
+    }
+    for (int n : m_activeTweens) s.activeTweens += n;
+    s.widgets = m_host->findChildren<QWidget*>().size();
+    for (const CascadeResolver *resolver : m_resolvers) {
+        s.lastResolveUs = qMax(s.lastResolveUs, resolver->lastResolveUs());
+        s.maxResolveUs = qMax(s.maxResolveUs, resolver->maxResolveUs());
+    }
+
+    NetworkManager *net = NetworkManager::instance();
+    if (net && net->isConnected()) {
+        s.netOutMsgs = net->pendingOutgoingMessages();
+        s.netInMsgs = net->pendingIncomingMessages();
+        s.netOut = net->pendingOutgoingBytes();
+        s.netIn = net->pendingIncomingBytes();
+    }
+    return s;
+}
+
+void PerfMonitor::setOverlayVisible(bool on)
+{
+    m_label->setVisible(on);
+    if (on) {
+        refresh();
+        m_label->raise();
+    }
+    if (on || isRecording()) m_refresh.start();
+    else m_refresh.stop();
+}
+
+bool PerfMonitor::startRecording()
+{
+    if (isRecording()) return true;
+
+    QString path = QString("%1/perf_%2_%3.csv")
+                       .arg(QDir::currentPath(), m_name,
+                            QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+    m_csv.setFileName(path);
+    if (!m_csv.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << "性能记录文件打开失败:" << path;
+        return false;
+    }
+    m_csvOut.setDevice(&m_csv);
+    m_csvOut << "time_ms,mode,frame_p50_ms,frame_p99_ms,active_tweens,widgets,"
+                "last_resolve_us,max_resolve_us,net_out_msgs,net_in_msgs,net_out_bytes,net_in_bytes\n";
+    qDebug() << "开始记录性能数据:" << path;
+
+    m_refresh.start();
+    return true;
+}
+
+void PerfMonitor::stopRecording()
+{
+    if (!isRecording()) return;
+    m_csvOut.flush();
+    m_csvOut.setDevice(nullptr);
+    m_csv.close();
+    if (m_label->isHidden()) m_refresh.stop();
+    if (m_label->isVisible()) refresh();
+}
+
+void PerfMonitor::refresh()
+{
+    const Snapshot s = snapshot();
+
+    if (isRecording()) {
+        m_csvOut << m_clock.elapsed() << ',' << m_name << ','
+                 << QString::number(s.p50, 'f', 1) << ',' << QString::number(s.p99, 'f', 1) << ','
+                 << s.activeTweens << ',' << s.widgets << ','
+                 << s.lastResolveUs << ',' << s.maxResolveUs << ','
+                 << s.netOutMsgs << ',' << s.netInMsgs << ',' << s.netOut << ',' << s.netIn << '\n';
+    }
+
+    if (m_label->isHidden()) return;
+
+    auto us = [](qint64 v) { return v < 0 ? QString("-") : QString("%1µs").arg(v); };
+    QString text = QString("帧间隔  p50 %1ms  p99 %2ms\n"
+                           "补间 %3  控件 %4\n"
+                           "连锁结算 %5  最长 %6\n"
+                           "网络待发 %7 条  待收 %8 条")
+                       .arg(s.p50, 0, 'f', 1).arg(s.p99, 0, 'f', 1)
+                       .arg(s.activeTweens).arg(s.widgets)
+                       .arg(us(s.lastResolveUs), us(s.maxResolveUs))
+                       .arg(s.netOutMsgs).arg(s.netInMsgs);
+    if (isRecording()) text += "\n● 记录中 (F4 停止)";
+
+    m_label->setText(text);
+    m_label->adjustSize();
+    m_label->raise();
+}
@@ -0,0 +1,68 @@
+// perfmonitor.h
+#ifndef PERFMONITOR_H
+#define PERFMONITOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QHash>
+#include <QVector>
+#include <QFile>
+#include <QTextStream>
+
+class QWidget;
+class QLabel;
+class TweenScheduler;
+class CascadeResolver;
+
+/* 性能面板：挂在各游戏模式窗口上，F3 显示/隐藏，F4 开始/停止写 CSV。
+ * 统计动画帧间隔 (p50/p99)、进行中的补间数、窗口内的控件数、连锁结算耗时（只算逻辑，
+ * 不含动画播放）、网络待收发消息数 */
+class PerfMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    PerfMonitor(QWidget *host, const QString &name);
+    ~PerfMonitor();
+
+    void watch(TweenScheduler *scheduler);   // 每个棋盘一个调度器，挂几个算几个
+    void watch(const CascadeResolver *resolver); // 结算耗时；挂多个时取最大
+
+    void setOverlayVisible(bool on);
+    bool startRecording();                 // 写到 perf_<name>_<时间>.csv
+    void stopRecording();
+    bool isRecording() const { return m_csv.isOpen(); }
+
+private:
+    struct Snapshot {
+        double p50 = 0, p99 = 0;           // 帧间隔 (ms)
+        int activeTweens = 0;
+        int widgets = 0;                   // 宿主窗口下的 QWidget 数
+        qint64 lastResolveUs = -1, maxResolveUs = -1;
+        int netOutMsgs = 0, netInMsgs = 0;
+        qint64 netOut = 0, netIn = 0;      // 字节
+    };
+
+    void onFrame(QObject *source, int activeTweens);
+    Snapshot snapshot() const;
+    void refresh();                        // 更新面板文字 + 写一行 CSV
+
+    QWidget *m_host;
+    QString m_name;
+    QLabel *m_label;
+    QTimer m_refresh;
+
+    QElapsedTimer m_clock;
+    QHash<QObject*, qint64> m_lastTick;    // 每个动画源上一帧的时间
+    QHash<QObject*, int> m_activeTweens;
+    QVector<float> m_frames;               // 最近的帧间隔环形缓冲
+    int m_frameHead = 0;
+
+    QVector<const CascadeResolver*> m_resolvers;
+
+    QFile m_csv;
+    QTextStream m_csvOut;
+};
+
+#endif // PERFMONITOR_H
@@ -0,0 +1,122 @@
+// protocol.cpp
+#include "protocol.h"
+#include <QVector>
+#include <algorithm>
+
+static const char *const kNames[] = {
+    "unknown",
+#define MATCH3_MSG_NAME(id, name) name,
+    MATCH3_MESSAGES(MATCH3_MSG_NAME)
+#undef MATCH3_MSG_NAME
+};
+static_assert(sizeof(kNames) / sizeof(kNames[0]) == size_t(Protocol::MsgId::Count),
+              "message name table out of sync");
+
+const char *Protocol::name(MsgId id)
+{
+    return kNames[int(id) < int(MsgId::Count) ? int(id) : 0];
+}
+
+QJsonObject Protocol::envelope(MsgId id, const QJsonObject &data)
+{
+    QJsonObject message;
+    message["v"] = EnvelopeVersion;
+    message["id"] = int(id);
+    message["type"] = QLatin1String(name(id));   // 给抓包和日志看，收方不读
+    message["data"] = data;
+    return message;
+}
+
+Protocol::MsgId Protocol::open(const QJsonObject &message, QJsonObject &data)
+{
+    if (message.value(QLatin1String("v")).toInt() != EnvelopeVersion) return MsgId::Unknown;
+
+    data = message.value(QLatin1String("data")).toObject();
+    const int n = message.value(QLatin1String("id")).toInt();
+    return (n > 0 && n < int(MsgId::Count)) ? MsgId(n) : MsgId::Unknown;
+}
+
+/* 字段编解码：每种字段类型一组重载，字段表展开时按类型选中 */
+static void readField(const QJsonValue &v, QString &out)     { if (v.isString()) out = v.toString(); }
+static void readField(const QJsonValue &v, bool &out)        { if (v.isBool()) out = v.toBool(); }
+static void readField(const QJsonValue &v, int &out)         { if (v.isDouble()) out = v.toInt(); }
+static void readField(const QJsonValue &v, qint64 &out)      { if (v.isDouble()) out = qint64(v.toDouble()); }
+static void readField(const QJsonValue &v, QJsonArray &out)  { if (v.isArray()) out = v.toArray(); }
+static void readField(const QJsonValue &v, QJsonObject &out) { if (v.isObject()) out = v.toObject(); }
+
+static QJsonValue writeField(const QString &v)     { return v; }
+static QJsonValue writeField(bool v)               { return v; }
+static QJsonValue writeField(int v)                { return v; }
+static QJsonValue writeField(qint64 v)             { return double(v); }
+static QJsonValue writeField(const QJsonArray &v)  { return v; }
+static QJsonValue writeField(const QJsonObject &v) { return v; }
+
+/* 解码不按键逐个查：每种消息的字段表在第一次用时按键排好序，和 QJsonObject
+ * （键本身按字母序存放）并排走一遍，负载里的每个键只和表里的键顺序比较，不哈希、不二分；
+ * 表里没有的键直接跳过，负载里缺的字段保留缺省值 */
+template <typename Msg>
+struct FieldReader {
+    QLatin1String key;
+    void (*read)(Msg &m, const QJsonValue &v);
+};
+
+template <typename Msg>
+static QVector<FieldReader<Msg>> sortedFields(std::initializer_list<FieldReader<Msg>> fields)
+{
+    QVector<FieldReader<Msg>> table(fields);
+    std::sort(table.begin(), table.end(),
+              [](const FieldReader<Msg> &a, const FieldReader<Msg> &b) { return a.key < b.key; });
+    return table;
+}
+
+template <typename Msg>
+static Msg readFields(const QJsonObject &data, const QVector<FieldReader<Msg>> &table)
+{
+    Msg m;
+    auto f = table.constBegin();
+    for (auto it = data.constBegin(); it != data.constEnd() && f != table.constEnd(); ++it) {
+        const QString key = it.key();
+        while (f != table.constEnd() && f->key < key) ++f;
+        if (f != table.constEnd() && f->key == key) {
+            f->read(m, it.value());
+            ++f;
+        }
+    }
+    return m;
+}
+
+#define MATCH3_FIELD_READER(type, member, key, def) \
+    { QLatin1String(key), [](Msg &m, const QJsonValue &v) { readField(v, m.member); } },
+#define MATCH3_FIELD_WRITE(type, member, key, def) \
+    if (member != type(def)) data.insert(QLatin1String(key), writeField(member));
+
+#define MATCH3_MESSAGE_CODEC(Name, FIELDS) \
+    Protocol::Name Protocol::Name::fromJson(const QJsonObject &data) \
+    { \
+        using Msg = Name; \
+        static const QVector<FieldReader<Msg>> table = sortedFields<Msg>({ FIELDS(MATCH3_FIELD_READER) }); \
+        return readFields(data, table); \
+    } \
+    QJsonObject Protocol::Name::toJson() const \
+    { \
+        QJsonObject data; \
+        FIELDS(MATCH3_FIELD_WRITE) \
+        return data; \
+    }
+
+MATCH3_MESSAGE_CODEC(GameMove, MATCH3_GAME_MOVE_FIELDS)
+MATCH3_MESSAGE_CODEC(Login, MATCH3_LOGIN_FIELDS)
+MATCH3_MESSAGE_CODEC(LoginResult, MATCH3_LOGIN_RESULT_FIELDS)
+MATCH3_MESSAGE_CODEC(MatchRequest, MATCH3_MATCH_REQUEST_FIELDS)
+MATCH3_MESSAGE_CODEC(MatchResponse, MATCH3_MATCH_RESPONSE_FIELDS)
+MATCH3_MESSAGE_CODEC(MatchFound, MATCH3_MATCH_FOUND_FIELDS)
+MATCH3_MESSAGE_CODEC(Chat, MATCH3_CHAT_FIELDS)
+MATCH3_MESSAGE_CODEC(UserStatus, MATCH3_USER_STATUS_FIELDS)
+MATCH3_MESSAGE_CODEC(Resume, MATCH3_RESUME_FIELDS)
+MATCH3_MESSAGE_CODEC(ResumeResult, MATCH3_RESUME_RESULT_FIELDS)
+MATCH3_MESSAGE_CODEC(OnlineList, MATCH3_ONLINE_LIST_FIELDS)
+MATCH3_MESSAGE_CODEC(PresenceDiff, MATCH3_PRESENCE_DIFF_FIELDS)
+
+#undef MATCH3_MESSAGE_CODEC
+#undef MATCH3_FIELD_WRITE
+#undef MATCH3_FIELD_READER
@@ -0,0 +1,193 @@
+// protocol.h
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <QString>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QMetaType>
+
+/* 客户端、服务器共用的协议定义：消息表和对局帧字段都只在这里写一次，
+ * 枚举、名字表和编解码函数都由下面的 X 宏展开。编号就是表里的顺序，新消息只能追加在表尾。
+ *
+ * 信封只有一种，上下行相同：{"v": 2, "id": 编号, "type": 名字, "data": {...}}，
+ * 收方取 id 直接 switch 分发，处理函数拿到的永远是 data 这一层。
+ * 没有 "v" 的旧版消息不再支持（旧版也不带长度帧，见 FrameCodec），按不认识的消息处理 */
+#define MATCH3_MESSAGES(X) \
+    X(Welcome,        "welcome") \
+    X(Login,          "login") \
+    X(LoginResult,    "login_result") \
+    X(Logout,         "logout") \
+    X(GetOnlineList,  "get_online_list") \
+    X(OnlineList,     "online_list") \
+    X(MatchRequest,   "match_request") \
+    X(MatchResponse,  "match_response") \
+    X(MatchFound,     "match_found") \
+    X(CancelMatch,    "cancel_match") \
+    X(MatchCancelled, "match_cancelled") \
+    X(Chat,           "chat") \
+    X(GameStart,      "game_start") \
+    X(GameMove,       "game_move") \
+    X(GameEnd,        "game_end") \
+    X(GameUpdate,     "game_update") \
+    X(OpponentReady,  "opponent_ready") \
+    X(PlayerQuit,     "player_quit") \
+    X(Heartbeat,      "heartbeat") \
+    X(HeartbeatAck,   "heartbeat_ack") \
+    X(UserStatus,     "user_status") \
+    X(System,         "system") \
+    X(ServerShutdown, "server_shutdown") \
+    X(Resume,         "resume") \
+    X(ResumeResult,   "resume_result") \
+    X(OpponentLink,   "opponent_link") \
+    X(PresenceDiff,   "presence_diff")
+
+/* 各消息负载的字段表：(类型, 成员, 键, 缺省值)，每张表展开成 Protocol 里的一个结构体。
+ * 编码时等于缺省值的字段不写，解码时缺的字段取缺省值，所以缺省值要选“不会真出现”的值
+ * （分数、序号这类 0 有意义的用 -1）。
+ * 没有表的消息（welcome、system、game_start/end 等）负载只在一处读写，仍直接用 QJsonObject */
+
+// 对局帧 game_move
+#define MATCH3_GAME_MOVE_FIELDS(F) \
+    F(QString,    roomId,    "room_id",   QString()) \
+    F(QString,    player,    "player",    QString()) \
+    F(QString,    opponent,  "opponent",  QString()) \
+    F(int,        score,     "score",     -1) \
+    F(QString,    op,        "op",        QString()) \
+    F(int,        seq,       "seq",       0) \
+    F(QJsonArray, mv,        "mv",        QJsonArray()) \
+    F(QString,    skill,     "id",        QString()) \
+    F(qint64,     seed,      "seed",      -1) \
+    F(qint64,     hash,      "hash",      -1) \
+    F(QJsonArray, board,     "board",     QJsonArray()) \
+    F(QString,    timestamp, "timestamp", QString())
+
+// login：codecs 按偏好排序的负载格式
+#define MATCH3_LOGIN_FIELDS(F) \
+    F(QString,     username,     "username",      QString()) \
+    F(QString,     password,     "password",      QString()) \
+    F(QJsonArray,  codecs,       "codecs",        QJsonArray())
+
+// login_result：session_token / resume_grace 为空表示服务器不支持会话恢复；codec 是协商出的负载格式
+#define MATCH3_LOGIN_RESULT_FIELDS(F) \
+    F(bool,        success,      "success",       false) \
+    F(QString,     message,      "message",       QString()) \
+    F(QString,     username,     "username",      QString()) \
+    F(QString,     sessionToken, "session_token", QString()) \
+    F(int,         resumeGrace,  "resume_grace",  0) \
+    F(QString,     codec,        "codec",         QString()) \
+    F(QJsonObject, userData,     "user_data",     QJsonObject())
+
+#define MATCH3_MATCH_REQUEST_FIELDS(F) \
+    F(QString,     mode,         "mode",          QString())
+
+#define MATCH3_MATCH_RESPONSE_FIELDS(F) \
+    F(bool,        success,      "success",       false) \
+    F(QString,     message,      "message",       QString()) \
+    F(int,         queuePosition, "queue_position", -1)
+
+// match_found：seed 为 0 表示服务器不支持确定性同步
+#define MATCH3_MATCH_FOUND_FIELDS(F) \
+    F(QString,     roomId,       "room_id",       QString()) \
+    F(QString,     player1,      "player1",       QString()) \
+    F(QString,     player2,      "player2",       QString()) \
+    F(QString,     gameMode,     "game_mode",     QString()) \
+    F(qint64,      seed,         "seed",          0) \
+    F(QString,     matchTime,    "match_time",    QString())
+
+// chat：上行带 to（用户名或 "all"），下行带 from 和服务器时间
+#define MATCH3_CHAT_FIELDS(F) \
+    F(QString,     to,           "to",            QString()) \
+    F(QString,     from,         "from",          QString()) \
+    F(QString,     message,      "message",       QString()) \
+    F(QString,     timestamp,    "timestamp",     QString())
+
+#define MATCH3_USER_STATUS_FIELDS(F) \
+    F(QString,     status,       "status",        QString()) \
+    F(QString,     gameMode,     "game_mode",     QString()) \
+    F(QString,     opponent,     "opponent",      QString()) \
+    F(QString,     username,     "username",      QString())
+
+#define MATCH3_RESUME_FIELDS(F) \
+    F(QString,     username,     "username",      QString()) \
+    F(QString,     token,        "token",         QString())
+
+// resume_result：房间字段只在对局中重连时有；missed 是掉线期间错过的完整信封，按原顺序
+#define MATCH3_RESUME_RESULT_FIELDS(F) \
+    F(bool,        success,      "success",       false) \
+    F(QString,     message,      "message",       QString()) \
+    F(QString,     username,     "username",      QString()) \
+    F(QString,     codec,        "codec",         QString()) \
+    F(QString,     roomId,       "room_id",       QString()) \
+    F(qint64,      seed,         "seed",          0) \
+    F(QString,     opponent,     "opponent",      QString()) \
+    F(int,         myScore,      "my_score",      -1) \
+    F(int,         opponentScore, "opponent_score", -1) \
+    F(QJsonArray,  opponentBoard, "opponent_board", QJsonArray()) \
+    F(QJsonArray,  missed,       "missed",        QJsonArray()) \
+    F(bool,        missedTruncated, "missed_truncated", false)
+
+// online_list：全量快照，version 是在线表版本，之后的增量从它接着打
+#define MATCH3_ONLINE_LIST_FIELDS(F) \
+    F(QJsonArray,  users,        "users",         QJsonArray()) \
+    F(int,         count,        "count",         -1) \
+    F(qint64,      version,      "version",       -1) \
+    F(QString,     timestamp,    "timestamp",     QString())
+
+// presence_diff：base 是它所接的版本；removed 只有用户名
+#define MATCH3_PRESENCE_DIFF_FIELDS(F) \
+    F(qint64,      base,         "base",          -1) \
+    F(qint64,      version,      "version",       -1) \
+    F(QJsonArray,  added,        "added",         QJsonArray()) \
+    F(QJsonArray,  updated,      "updated",       QJsonArray()) \
+    F(QJsonArray,  removed,      "removed",       QJsonArray()) \
+    F(int,         count,        "count",         -1)
+
+// 一张字段表展开成一个结构体：成员带缺省值，fromJson / toJson 在 protocol.cpp 里同样由表展开
+#define MATCH3_FIELD_DECL(type, member, key, def) type member = def;
+#define MATCH3_MESSAGE_STRUCT(Name, FIELDS) \
+    struct Name { \
+        FIELDS(MATCH3_FIELD_DECL) \
+        static Name fromJson(const QJsonObject &data); \
+        QJsonObject toJson() const; \
+    };
+
+namespace Protocol
+{
+    enum class MsgId : quint8 {
+        Unknown = 0,
+#define MATCH3_MSG_ENUM(id, name) id,
+        MATCH3_MESSAGES(MATCH3_MSG_ENUM)
+#undef MATCH3_MSG_ENUM
+        Count
+    };
+
+    const char *name(MsgId id);
+
+    const int EnvelopeVersion = 2;
+
+    QJsonObject envelope(MsgId id, const QJsonObject &data);
+    // 解信封，返回编号，data 取出负载；版本不对或编号越界返回 Unknown
+    MsgId open(const QJsonObject &message, QJsonObject &data);
+
+    /* 对局帧：整盘同步（board + score）、确定性同步的操作（op/seq/mv/id/seed/hash）
+     * 和局末分数（op = "final"）共用这一种消息 */
+    MATCH3_MESSAGE_STRUCT(GameMove, MATCH3_GAME_MOVE_FIELDS)
+
+    MATCH3_MESSAGE_STRUCT(Login, MATCH3_LOGIN_FIELDS)
+    MATCH3_MESSAGE_STRUCT(LoginResult, MATCH3_LOGIN_RESULT_FIELDS)
+    MATCH3_MESSAGE_STRUCT(MatchRequest, MATCH3_MATCH_REQUEST_FIELDS)
+    MATCH3_MESSAGE_STRUCT(MatchResponse, MATCH3_MATCH_RESPONSE_FIELDS)
+    MATCH3_MESSAGE_STRUCT(MatchFound, MATCH3_MATCH_FOUND_FIELDS)
+    MATCH3_MESSAGE_STRUCT(Chat, MATCH3_CHAT_FIELDS)
+    MATCH3_MESSAGE_STRUCT(UserStatus, MATCH3_USER_STATUS_FIELDS)
+    MATCH3_MESSAGE_STRUCT(Resume, MATCH3_RESUME_FIELDS)
+    MATCH3_MESSAGE_STRUCT(ResumeResult, MATCH3_RESUME_RESULT_FIELDS)
+    MATCH3_MESSAGE_STRUCT(OnlineList, MATCH3_ONLINE_LIST_FIELDS)
+    MATCH3_MESSAGE_STRUCT(PresenceDiff, MATCH3_PRESENCE_DIFF_FIELDS)
+}
+
+Q_DECLARE_METATYPE(Protocol::GameMove)
+Q_DECLARE_METATYPE(Protocol::ResumeResult)
+
+#endif // PROTOCOL_H
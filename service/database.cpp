@@ -74,6 +74,13 @@ bool Database::createTables()
         }
     }
 
+    // 等级分字段（匹配按分段找对手），老库补一列，已有玩家从初始分起步
+    if (!query.exec("SHOW COLUMNS FROM user LIKE 'online_rating'") || !query.next()) {
+        if (!query.exec("ALTER TABLE user ADD COLUMN IF NOT EXISTS online_rating INT DEFAULT 1500")) {
+            qDebug() << "添加等级分字段失败:" << query.lastError().text();
+        }
+    }
+
     return true;
 }
 
@@ -114,7 +121,7 @@ QJsonObject Database::getUserData(const QString &username)
 
     QSqlQuery query(m_db);
     query.prepare(
-        "SELECT points, skill_points, online_wins, online_losses, online_points "
+        "SELECT points, skill_points, online_wins, online_losses, online_points, online_rating "
         "FROM user WHERE username = ?"
         );
     query.addBindValue(username);
@@ -125,6 +132,7 @@ QJsonObject Database::getUserData(const QString &username)
         userData["online_wins"] = query.value(2).toInt();
         userData["online_losses"] = query.value(3).toInt();
         userData["online_points"] = query.value(4).toInt();
+        userData["online_rating"] = query.value(5).toInt();
     }
 
     return userData;
@@ -200,6 +208,20 @@ bool Database::saveOnlineMatch(const QString &player1, const QString &player2,
     return true;
 }
 
+bool Database::updateOnlineRating(const QString &username, int rating)
+{
+    QSqlQuery query(m_db);
+    query.prepare("UPDATE user SET online_rating = ? WHERE username = ?");
+    query.addBindValue(rating);
+    query.addBindValue(username);
+
+    if (!query.exec()) {
+        qDebug() << "更新等级分失败:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
 QJsonObject Database::getRankings(int limit)
 {
     QJsonObject result;
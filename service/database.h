@@ -29,6 +29,7 @@ public:
 
     bool saveOnlineMatch(const QString &player1, const QString &player2,
                          int score1, int score2, const QString &winner);
+    bool updateOnlineRating(const QString &username, int rating);
 
 private:
     QSqlDatabase m_db;
@@ -0,0 +1,37 @@
+#include "dbworker.h"
+#include "database.h"
+
+DbWorker::DbWorker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+Database *DbWorker::database()
+{
+    if (!m_db) {
+        m_db = new Database(this);
+        m_db->connect();              // 失败也没关系，verifyUser 会在用到时重连
+    }
+    return m_db;
+}
+
+void DbWorker::verifyLogin(ClientId id, const QString &username, const QString &password,
+                           const QJsonObject &request)
+{
+    Database *db = database();
+    const bool ok = db->verifyUser(username, password);
+    emit loginVerified(id, username, ok, ok ? db->getUserData(username) : QJsonObject(), request);
+}
+
+void DbWorker::saveOnlineMatch(const QString &player1, const QString &player2,
+                               int score1, int score2, const QString &winner)
+{
+    database()->saveOnlineMatch(player1, player2, score1, score2, winner);
+}
+
+void DbWorker::saveRatings(const QString &player1, int rating1, const QString &player2, int rating2)
+{
+    Database *db = database();
+    db->updateOnlineRating(player1, rating1);
+    db->updateOnlineRating(player2, rating2);
+}
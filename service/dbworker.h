@@ -0,0 +1,38 @@
+#ifndef DBWORKER_H
+#define DBWORKER_H
+
+#include <QObject>
+#include <QJsonObject>
+#include "ioworker.h"
+
+class Database;
+
+/* 数据库线程的工作对象：登录校验和对战记录都是同步的 MySQL 往返，放到这里排队执行，
+ * 不再卡住 ServerCore 的事件循环。QSqlDatabase 连接只能在创建它的线程里用，
+ * 所以 Database 在第一次调用时于本线程创建，之后一直复用这一条连接 */
+class DbWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DbWorker(QObject *parent = nullptr);
+
+public slots:
+    void verifyLogin(ClientId id, const QString &username, const QString &password,
+                     const QJsonObject &request);
+    void saveOnlineMatch(const QString &player1, const QString &player2,
+                         int score1, int score2, const QString &winner);
+    void saveRatings(const QString &player1, int rating1, const QString &player2, int rating2);
+
+signals:
+    // request 原样带回，ServerCore 在自己的线程里接着完成登录
+    void loginVerified(ClientId id, const QString &username, bool ok,
+                       const QJsonObject &userData, const QJsonObject &request);
+
+private:
+    Database *database();
+
+    Database *m_db = nullptr;
+};
+
+#endif // DBWORKER_H
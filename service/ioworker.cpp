@@ -0,0 +1,118 @@
+#include "ioworker.h"
+#include "../logger.h"
+#include <QTcpSocket>
+#include <QElapsedTimer>
+
+IoWorker::IoWorker(int maxFrameSize, QObject *parent)
+    : QObject(parent)
+    , m_maxFrameSize(maxFrameSize)
+{
+}
+
+void IoWorker::adopt(qintptr descriptor, ClientId id)
+{
+    QTcpSocket *socket = new QTcpSocket(this);
+    if (!socket->setSocketDescriptor(descriptor)) {
+        LOG_WARN("io", "接管连接失败 #%1: %2", id, socket->errorString());
+        delete socket;
+        emit closed(id);
+        return;
+    }
+
+    // 限制套接字自己的读缓冲：处理不过来时由 TCP 窗口给对端背压，而不是在内存里无限堆积
+    socket->setReadBufferSize(4 * m_maxFrameSize);
+
+    Connection &conn = m_connections[id];
+    conn.socket = socket;
+    conn.reader = FrameReader(m_maxFrameSize);
+
+    connect(socket, &QTcpSocket::readyRead, this, [this, id]() { readFrames(id); });
+    connect(socket, &QTcpSocket::disconnected, this, [this, id]() {
+        auto it = m_connections.find(id);
+        if (it == m_connections.end()) return;
+        it->socket->deleteLater();
+        m_connections.erase(it);
+        emit closed(id);
+    });
+
+    emit opened(id, socket->peerAddress().toString());
+}
+
+void IoWorker::readFrames(ClientId id)
+{
+    auto it = m_connections.find(id);
+    if (it == m_connections.end()) return;
+    it->reader.readFrom(it->socket);
+
+    // 负载直接指向接收缓冲区，解码在本线程完成，交给 ServerCore 的只有 QJsonObject
+    QByteArray payload;
+    while (it->reader.next(payload)) {
+        QJsonObject message;
+        if (WireCodec::decode(payload, message)) {
+            emit messageReceived(id, message);
+        } else {
+            emit protocolError(id, QString("消息解析错误，长度 %1").arg(payload.size()), false);
+        }
+    }
+    if (it->reader.hasError()) {
+        it->reader.clear();
+        emit protocolError(id, "帧长度超出上限", true);
+    }
+}
+
+void IoWorker::send(ClientId id, const QJsonObject &message, WireCodec::Format codec)
+{
+    auto it = m_connections.constFind(id);
+    if (it == m_connections.constEnd() || !it->socket->isValid()) return;
+
+    // 只进套接字的写缓冲，不 flush：回到事件循环后统一写出，同一轮里的多条消息合成一次系统调用
+    it->socket->write(FrameCodec::encode(WireCodec::encode(message, codec)));
+}
+
+void IoWorker::sendFrame(const QVector<ClientId> &ids, const QByteArray &frame)
+{
+    for (ClientId id : ids) {
+        auto it = m_connections.constFind(id);
+        if (it == m_connections.constEnd() || !it->socket->isValid()) continue;
+        it->socket->write(frame);
+    }
+}
+
+void IoWorker::close(ClientId id, bool abort)
+{
+    auto it = m_connections.constFind(id);
+    if (it == m_connections.constEnd()) return;
+
+    // 断开后 disconnected 信号负责清理和通知
+    if (abort) it->socket->abort();
+    else it->socket->disconnectFromHost();
+}
+
+void IoWorker::closeAll()
+{
+    const QList<ClientId> ids = m_connections.keys();
+    for (ClientId id : ids) close(id, false);
+}
+
+void IoWorker::drain(int timeoutMs)
+{
+    // 事件循环马上要停，写缓冲只能在这里同步写出；总时长有上限，写不动的对端直接断开
+    QElapsedTimer timer;
+    timer.start();
+    const QList<ClientId> ids = m_connections.keys();
+    for (ClientId id : ids) {
+        auto it = m_connections.constFind(id);
+        if (it == m_connections.constEnd()) continue;
+        QTcpSocket *socket = it->socket;
+        while (socket->bytesToWrite() > 0 && timer.elapsed() < timeoutMs) {
+            if (!socket->waitForBytesWritten(int(timeoutMs - timer.elapsed()))) break;
+        }
+    }
+    // abort 会同步触发 disconnected，清理时会改 m_connections，所以按编号重新查
+    for (ClientId id : m_connections.keys()) {
+        auto it = m_connections.constFind(id);
+        if (it == m_connections.constEnd()) continue;
+        if (it->socket->bytesToWrite() > 0) LOG_WARN("io", "退出时 #%1 仍有 %2 字节未写出", id, it->socket->bytesToWrite());
+        it->socket->abort();
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef IOWORKER_H
+#define IOWORKER_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QHash>
+#include <QVector>
+#include <QJsonObject>
+#include "../framecodec.h"
+#include "../wirecodec.h"
+
+class QTcpSocket;
+
+typedef quint64 ClientId;                 // 连接编号，单调递增不复用；0 表示没有连接
+
+// 监听线程只接受连接，不创建套接字：描述符交给 ServerCore 分配到 I/O 线程里再建 QTcpSocket
+class ListenServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    using QTcpServer::QTcpServer;
+
+signals:
+    void descriptorReady(qintptr descriptor);
+
+protected:
+    void incomingConnection(qintptr descriptor) override { emit descriptorReady(descriptor); }
+};
+
+/* 一个 I/O 线程的工作对象：在自己的事件循环里持有分到的套接字，负责分帧、解码和编码写出。
+ * 房间、会话、在线表都只在 ServerCore 线程访问，两边只交换已解码的消息和连接编号，
+ * 套接字指针从不离开本线程。所有槽都由 ServerCore 排队调用 */
+class IoWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IoWorker(int maxFrameSize, QObject *parent = nullptr);
+
+public slots:
+    void adopt(qintptr descriptor, ClientId id);
+    void send(ClientId id, const QJsonObject &message, WireCodec::Format codec);
+    // 广播：帧已在 ServerCore 编码好，同一块共享缓冲区写给本线程里的每个收件人
+    void sendFrame(const QVector<ClientId> &ids, const QByteArray &frame);
+    void close(ClientId id, bool abort);
+    void closeAll();
+    // 线程退出前由 ServerCore 阻塞调用：此前排队的发送和断开都已执行，这里把写缓冲真正写出去
+    void drain(int timeoutMs);
+
+signals:
+    void opened(ClientId id, const QString &ipAddress);
+    void messageReceived(ClientId id, const QJsonObject &message);
+    void protocolError(ClientId id, const QString &reason, bool fatal);
+    void closed(ClientId id);
+
+private:
+    struct Connection {
+        QTcpSocket *socket = nullptr;
+        FrameReader reader;               // 接收缓冲区，跨 readyRead 保留半帧
+    };
+
+    void readFrames(ClientId id);
+
+    QHash<ClientId, Connection> m_connections;
+    int m_maxFrameSize;
+};
+
+#endif // IOWORKER_H
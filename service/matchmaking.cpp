@@ -0,0 +1,219 @@
+#include "matchmaking.h"
+#include <QJsonArray>
+#include <QtMath>
+
+double Rating::expected(int rating, int opponent)
+{
+    return 1.0 / (1.0 + qPow(10.0, (opponent - rating) / 400.0));
+}
+
+int Rating::kFactor(int gamesPlayed)
+{
+    return gamesPlayed < ProvisionalGames ? 32 : 16;
+}
+
+int Rating::update(int rating, int opponent, double score, int gamesPlayed)
+{
+    return rating + qRound(kFactor(gamesPlayed) * (score - expected(rating, opponent)));
+}
+
+static const int WaitEdgesMs[] = { 1000, 2000, 5000, 10000, 20000, 30000, 60000 };
+static const int SpreadEdges[] = { 25, 50, 100, 200, 400, 800 };
+
+static const int WaitSlots = int(sizeof(WaitEdgesMs) / sizeof(int));
+static const int SpreadSlots = int(sizeof(SpreadEdges) / sizeof(int));
+
+static int bucketOf(int rating)
+{
+    // 向下取整，负分也落在正确的桶里
+    return rating >= 0 ? rating / Matchmaker::BucketWidth
+                       : -((-rating + Matchmaker::BucketWidth - 1) / Matchmaker::BucketWidth);
+}
+
+template <int N>
+static int histogramSlot(const int (&edges)[N], qint64 value)
+{
+    for (int i = 0; i < N; ++i)
+        if (value < edges[i]) return i;
+    return N;
+}
+
+int Matchmaker::windowFor(qint64 waitedMs)
+{
+    return int(qMin<qint64>(qint64(MaxWindow), BaseWindow + waitedMs * WindowGrowthPerSec / 1000));
+}
+
+int Matchmaker::enqueue(const QString &username, const QString &mode, int rating, qint64 nowMs)
+{
+    auto found = m_index.constFind(username);
+    if (found != m_index.constEnd()) {
+        if (found->mode == mode) return found->it->position;
+        cancel(username);
+    }
+
+    ModeQueue &q = m_queues[mode];
+    Ticket ticket;
+    ticket.username = username;
+    ticket.mode = mode;
+    ticket.rating = rating;
+    ticket.enqueuedMs = nowMs;
+    ticket.position = int(q.arrivals.size()) + 1;   // 排在队尾，前面都是有效的票
+    q.arrivals.push_back(ticket);
+
+    Entry entry;
+    entry.mode = mode;
+    entry.it = std::prev(q.arrivals.end());
+    Bucket &bucket = q.buckets[bucketOf(rating)];
+    bucket.push_back(entry.it);
+    entry.slot = std::prev(bucket.end());
+    m_index.insert(username, entry);
+    return ticket.position;
+}
+
+void Matchmaker::remove(ModeQueue &q, const Entry &entry)
+{
+    // 队尾离开不影响别人的名次
+    if (std::next(entry.it) != q.arrivals.end()) m_dirtyModes.insert(entry.mode);
+
+    auto b = q.buckets.find(bucketOf(entry.it->rating));
+    b->erase(entry.slot);
+    if (b->empty()) q.buckets.erase(b);
+    m_index.remove(entry.it->username);
+    q.arrivals.erase(entry.it);
+}
+
+bool Matchmaker::cancel(const QString &username)
+{
+    auto found = m_index.constFind(username);
+    if (found == m_index.constEnd()) return false;
+
+    const Entry entry = found.value();
+    ModeQueue &q = m_queues[entry.mode];
+    remove(q, entry);
+    if (q.arrivals.empty()) {
+        m_queues.remove(entry.mode);
+        m_dirtyModes.remove(entry.mode);
+    }
+    return true;
+}
+
+Matchmaker::Queue::iterator Matchmaker::findOpponent(ModeQueue &q, Queue::iterator self, qint64 nowMs)
+{
+    const int window = windowFor(nowMs - self->enqueuedMs);
+    const int low = bucketOf(self->rating - window);
+    const int high = bucketOf(self->rating + window);
+
+    // 二分到窗口下沿，每个桶只看最早入队的那张票（是自己就看下一张）
+    Queue::iterator best = q.arrivals.end();
+    int bestGap = window + 1;
+    for (auto b = q.buckets.lowerBound(low); b != q.buckets.end() && b.key() <= high; ++b) {
+        auto slot = b->begin();
+        if (*slot == self && ++slot == b->end()) continue;
+        const int gap = qAbs((*slot)->rating - self->rating);
+        if (gap < bestGap) {
+            best = *slot;
+            bestGap = gap;
+        }
+    }
+    return best;
+}
+
+QVector<Matchmaker::Pairing> Matchmaker::formMatches(qint64 nowMs)
+{
+    QVector<Pairing> pairs;
+    for (auto m = m_queues.begin(); m != m_queues.end(); ) {
+        ModeQueue &q = m.value();
+
+        // 按入队顺序找：等得最久的人窗口最宽，先给他挑
+        for (auto it = q.arrivals.begin(); it != q.arrivals.end(); ) {
+            Queue::iterator other = findOpponent(q, it, nowMs);
+            if (other == q.arrivals.end()) {
+                ++it;
+                continue;
+            }
+
+            Pairing p;
+            p.first = *it;
+            p.second = *other;
+            pairs.append(p);
+            recordMatch(p, nowMs);
+
+            // 先挪走遍历位置再删：对手可能正好是下一个
+            auto next = std::next(it);
+            if (next == other) ++next;
+            const Entry a = m_index.value(p.first.username);
+            const Entry b = m_index.value(p.second.username);
+            remove(q, a);
+            remove(q, b);
+            it = next;
+        }
+
+        if (q.arrivals.empty()) {
+            m_dirtyModes.remove(m.key());
+            m = m_queues.erase(m);
+        } else {
+            ++m;
+        }
+    }
+    return pairs;
+}
+
+void Matchmaker::recordMatch(const Pairing &pair, qint64 nowMs)
+{
+    if (m_waitHistogram.isEmpty()) {
+        m_waitHistogram.fill(0, WaitSlots + 1);
+        m_spreadHistogram.fill(0, SpreadSlots + 1);
+    }
+
+    for (const Ticket *t : { &pair.first, &pair.second }) {
+        const qint64 waited = nowMs - t->enqueuedMs;
+        ++m_waitHistogram[histogramSlot(WaitEdgesMs, waited)];
+        m_totalWaitMs += waited;
+    }
+    const int spread = qAbs(pair.first.rating - pair.second.rating);
+    ++m_spreadHistogram[histogramSlot(SpreadEdges, spread)];
+    m_totalSpread += spread;
+    m_maxSpread = qMax(m_maxSpread, spread);
+    ++m_matches;
+}
+
+QVector<Matchmaker::PositionUpdate> Matchmaker::takePositionUpdates()
+{
+    QVector<PositionUpdate> updates;
+    for (const QString &mode : m_dirtyModes) {
+        auto q = m_queues.find(mode);
+        if (q == m_queues.end()) continue;
+        int position = 0;
+        for (Ticket &t : q->arrivals) {
+            if (t.position == ++position) continue;
+            t.position = position;
+            updates.append({t.username, position});
+        }
+    }
+    m_dirtyModes.clear();
+    return updates;
+}
+
+QJsonObject Matchmaker::metrics() const
+{
+    auto histogram = [](const int *edges, int count, const QVector<quint64> &values, const char *unit) {
+        QJsonArray out;
+        for (int i = 0; i <= count; ++i) {
+            QJsonObject slot;
+            slot["le"] = i < count ? QString("%1%2").arg(edges[i]).arg(unit) : QString("+inf");
+            slot["count"] = double(i < values.size() ? values[i] : 0);
+            out.append(slot);
+        }
+        return out;
+    };
+
+    QJsonObject m;
+    m["queued"] = size();
+    m["matches"] = double(m_matches);
+    m["avg_wait_ms"] = m_matches ? double(m_totalWaitMs) / (2 * m_matches) : 0.0;
+    m["avg_rating_spread"] = m_matches ? double(m_totalSpread) / m_matches : 0.0;
+    m["max_rating_spread"] = m_maxSpread;
+    m["wait_histogram"] = histogram(WaitEdgesMs, WaitSlots, m_waitHistogram, "ms");
+    m["spread_histogram"] = histogram(SpreadEdges, SpreadSlots, m_spreadHistogram, "");
+    return m;
+}
@@ -0,0 +1,105 @@
+#ifndef MATCHMAKING_H
+#define MATCHMAKING_H
+
+#include <QString>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QVector>
+#include <QJsonObject>
+#include <list>
+
+// Elo 等级分：新号 1500，前 RatingProvisionalGames 局 K 取大值，分数收敛得快
+namespace Rating
+{
+    const int Initial = 1500;
+    const int ProvisionalGames = 30;
+
+    double expected(int rating, int opponent);               // 对 opponent 的期望得分 (0~1)
+    int kFactor(int gamesPlayed);
+    // score: 1 胜、0.5 平、0 负；返回新分数
+    int update(int rating, int opponent, double score, int gamesPlayed);
+}
+
+/* 匹配队列：每个模式一条按入队顺序的链表，外加按等级分分桶的有序索引（桶宽 BucketWidth）。
+ * 入队、取消 O(log 桶数)，找对手时从桶索引里按搜索窗口二分定位，只看窗口内的桶首；
+ * 搜索窗口随等待时间放宽，等得越久能接受的分差越大。
+ * 配对不在请求里做，而是由 ServerCore 的短周期定时器批量调用 formMatches()；
+ * 排队名次按入队顺序，每个周期只为有人离队的模式重算一遍，变化了才通知客户端。
+ * 只在 ServerCore 线程使用 */
+class Matchmaker
+{
+public:
+    static const int BucketWidth = 50;
+    static const int BaseWindow = 100;    // 刚入队时能接受的分差
+    static const int WindowGrowthPerSec = 50;
+    static const int MaxWindow = 1000;    // 等够久之后基本谁都能配
+
+    struct Ticket {
+        QString username;
+        QString mode;
+        int rating = Rating::Initial;
+        qint64 enqueuedMs = 0;            // 入队时间
+        int position = 0;                 // 最近一次告诉客户端的名次（从 1 开始）
+    };
+
+    struct Pairing {
+        Ticket first;                     // 先入队的一方做 player1
+        Ticket second;
+    };
+
+    struct PositionUpdate {
+        QString username;
+        int position;
+    };
+
+    static int windowFor(qint64 waitedMs);
+
+    // 入队并返回名次；已在同一模式排队时保持原位，换了模式则移到新模式队尾
+    int enqueue(const QString &username, const QString &mode, int rating, qint64 nowMs);
+    bool cancel(const QString &username);
+    bool contains(const QString &username) const { return m_index.contains(username); }
+    int size() const { return m_index.size(); }
+    bool isEmpty() const { return m_index.isEmpty(); }
+
+    // 按入队顺序给每个人在窗口内找分差最小的对手，配上的人出队
+    QVector<Pairing> formMatches(qint64 nowMs);
+    // 名次有变化的玩家（只扫描本周期有人离队的模式）
+    QVector<PositionUpdate> takePositionUpdates();
+
+    // 调参用：等待时长分布、每场分差分布
+    QJsonObject metrics() const;
+
+private:
+    typedef std::list<Ticket> Queue;
+    typedef std::list<Queue::iterator> Bucket;
+
+    struct ModeQueue {
+        Queue arrivals;                   // 入队顺序
+        QMap<int, Bucket> buckets;        // 分桶号 -> 桶内按入队顺序
+    };
+
+    struct Entry {
+        QString mode;
+        Queue::iterator it;
+        Bucket::iterator slot;
+    };
+
+    void remove(ModeQueue &q, const Entry &entry);
+    Queue::iterator findOpponent(ModeQueue &q, Queue::iterator self, qint64 nowMs);
+    void recordMatch(const Pairing &pair, qint64 nowMs);
+
+    QHash<QString, ModeQueue> m_queues;   // mode -> 队列
+    QHash<QString, Entry> m_index;        // username -> 所在模式和节点
+    QSet<QString> m_dirtyModes;           // 有人离队、后面名次会变的模式
+
+    // 统计：直方图按上界分档（分档表在 .cpp 里），最后一档收纳超出的
+    QVector<quint64> m_waitHistogram;
+    QVector<quint64> m_spreadHistogram;
+    quint64 m_matches = 0;
+    qint64 m_totalWaitMs = 0;
+    qint64 m_totalSpread = 0;
+    int m_maxSpread = 0;
+};
+
+#endif // MATCHMAKING_H
@@ -0,0 +1,52 @@
+#include "presence.h"
+#include <QJsonArray>
+#include <QDateTime>
+
+bool Presence::Entry::operator==(const Entry &o) const
+{
+    return username == o.username && status == o.status && gameMode == o.gameMode
+        && connectTime == o.connectTime && ipAddress == o.ipAddress;
+}
+
+QJsonObject Presence::Entry::toJson() const
+{
+    QJsonObject obj;
+    obj["username"] = username;
+    obj["status"] = status;
+    obj["game_mode"] = gameMode;
+    obj["connect_time"] = connectTime;
+    obj["ip_address"] = ipAddress;
+    return obj;
+}
+
+bool Presence::publish(const QHash<QString, Entry> &current, Protocol::PresenceDiff &diff)
+{
+    // 空数组在编码时省略，和以前一样只写有内容的那几项
+    diff = Protocol::PresenceDiff();
+    for (auto it = current.constBegin(); it != current.constEnd(); ++it) {
+        auto old = m_published.constFind(it.key());
+        if (old == m_published.constEnd()) diff.added.append(it->toJson());
+        else if (*old != it.value()) diff.updated.append(it->toJson());
+    }
+    for (auto it = m_published.constBegin(); it != m_published.constEnd(); ++it) {
+        if (!current.contains(it.key())) diff.removed.append(it.key());
+    }
+
+    if (diff.added.isEmpty() && diff.updated.isEmpty() && diff.removed.isEmpty()) return false;
+
+    m_published = current;
+    diff.base = qint64(m_version);
+    diff.version = qint64(++m_version);
+    diff.count = m_published.size();
+    return true;
+}
+
+Protocol::OnlineList Presence::snapshot() const
+{
+    Protocol::OnlineList list;
+    for (const Entry &e : m_published) list.users.append(e.toJson());
+    list.count = list.users.size();
+    list.version = qint64(m_version);
+    list.timestamp = QDateTime::currentDateTime().toString(Qt::ISODate);
+    return list;
+}
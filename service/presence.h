@@ -0,0 +1,41 @@
+#ifndef PRESENCE_H
+#define PRESENCE_H
+
+#include <QString>
+#include <QHash>
+#include <QJsonObject>
+#include "../protocol.h"
+
+/* 在线表：带版本号的已发布状态。ServerCore 把一个周期内的状态变化攒起来，
+ * 周期到了拿当前全表调一次 publish()，这里和上一版比较，只把增、删、改的玩家打成一份增量，
+ * 版本号加一；没有净变化（比如上线又下线）就什么也不发。
+ * 客户端发现增量的 base 和自己手里的版本对不上，就要一份快照重新对齐。只在 ServerCore 线程使用 */
+class Presence
+{
+public:
+    struct Entry {
+        QString username;
+        QString status;
+        QString gameMode;
+        QString connectTime;
+        QString ipAddress;
+
+        bool operator==(const Entry &o) const;
+        bool operator!=(const Entry &o) const { return !(*this == o); }
+        QJsonObject toJson() const;
+    };
+
+    quint64 version() const { return m_version; }
+    int size() const { return m_published.size(); }
+
+    // 与上一版比较并发布，增量写进 diff；没有变化返回 false
+    bool publish(const QHash<QString, Entry> &current, Protocol::PresenceDiff &diff);
+    // 已发布状态的全量快照，字段与旧版 online_list 相同，另带 version
+    Protocol::OnlineList snapshot() const;
+
+private:
+    QHash<QString, Entry> m_published;    // username -> 最近一次发布的状态
+    quint64 m_version = 0;
+};
+
+#endif // PRESENCE_H
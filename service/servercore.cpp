@@ -1,20 +1,49 @@
 #include "servercore.h"
-#include "database.h"
 #include "matchmaking.h"
+#include "../logger.h"
 #include <QNetworkInterface>
 #include <QRandomGenerator>
+#include <QThread>
 #include <QTimer>
 
+static const int SessionGraceSecs = 30;      // 对局中掉线后保留房间的时间
+static const int MaxMissedMessages = 256;    // 掉线期间最多缓存的消息数
+static const int ClientMaxFrameSize = 64 * 1024;  // 上行只有操作、整盘和聊天，远用不到客户端的 4MB 上限
+static const int MaxProtocolErrors = 8;      // 单个连接累计这么多次协议错误就断开
+static const int PresenceTickMs = 250;      // 在线表增量的合并周期
+static const int MatchTickMs = 100;          // 配对周期：请求先入队，下一个周期统一配对
+static const int ShutdownDrainMs = 2000;     // 关服时每个 I/O 线程写出剩余数据的时限
+
+// 统一的消息信封，sendResponse 和掉线缓存共用
+static QJsonObject envelope(Protocol::MsgId id, const QJsonObject &data)
+{
+    QJsonObject response = Protocol::envelope(id, data);
+    response["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    return response;
+}
+
 ServerCore::ServerCore(QObject *parent)
     : QObject(parent)
-    , m_tcpServer(new QTcpServer(this))
+    , m_tcpServer(new ListenServer(this))
 {
-    connect(m_tcpServer, &QTcpServer::newConnection, this, &ServerCore::onNewConnection);
+    qRegisterMetaType<ClientId>("ClientId");
+    connect(m_tcpServer, &ListenServer::descriptorReady, this, &ServerCore::onIncomingConnection);
+    startWorkers();
+
     // 初始化房间清理定时器
     m_roomCleanupTimer = new QTimer(this);
     m_roomCleanupTimer->setInterval(60000); // 每分钟清理一次
     connect(m_roomCleanupTimer, &QTimer::timeout, this, &ServerCore::cleanupExpiredRooms);
     m_roomCleanupTimer->start();
+
+    m_matchTimer = new QTimer(this);
+    m_matchTimer->setInterval(MatchTickMs);
+    connect(m_matchTimer, &QTimer::timeout, this, &ServerCore::onMatchTick);
+
+    m_presenceTimer = new QTimer(this);
+    m_presenceTimer->setSingleShot(true);
+    m_presenceTimer->setInterval(PresenceTickMs);
+    connect(m_presenceTimer, &QTimer::timeout, this, &ServerCore::onPresenceTick);
 }
 
 bool ServerCore::startServer(quint16 port)
@@ -56,61 +85,147 @@ void ServerCore::stopServer()
         shutdownMsg["type"] = "server_shutdown";
         shutdownMsg["message"] = "服务器维护中，请稍后重连";
 
-        for (QTcpSocket *socket : m_clients.keys()) {
-            sendResponse(socket, "system", shutdownMsg);
-            socket->disconnectFromHost();
-        }
+        // 同一连接的发送和断开在它的 I/O 线程里按顺序执行，通知一定先发出去
+        QVector<ClientId> sockets;
+        for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) sockets.append(it.key());
+        broadcast(sockets, Protocol::MsgId::System, shutdownMsg);
+        for (ClientId socket : sockets) closeClient(socket);
 
         m_tcpServer->close();
         m_clients.clear();
         m_usernameToSocket.clear();
+        for (Session &s : m_sessions) {
+            if (s.graceTimer) s.graceTimer->deleteLater();
+        }
+        m_sessions.clear();
 
         emit logMessage("服务器已停止", QColor("#FF9800"));
     }
 }
 
-void ServerCore::onNewConnection()
+void ServerCore::startWorkers()
+{
+    // 一个核给 ServerCore 自己（GUI 也在这个线程），其余做 I/O；数据库单独一个线程
+    const int count = qMax(1, QThread::idealThreadCount() - 1);
+    for (int i = 0; i < count; ++i) {
+        QThread *thread = new QThread(this);
+        thread->setObjectName(QString("io-%1").arg(i));
+        IoWorker *worker = new IoWorker(ClientMaxFrameSize);
+        worker->moveToThread(thread);
+        connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+
+        connect(worker, &IoWorker::opened, this, &ServerCore::onClientOpened);
+        connect(worker, &IoWorker::messageReceived, this, &ServerCore::onClientMessage);
+        connect(worker, &IoWorker::protocolError, this, &ServerCore::onProtocolError);
+        connect(worker, &IoWorker::closed, this, &ServerCore::onClientClosed);
+
+        m_ioThreads.append(thread);
+        m_ioWorkers.append(worker);
+        m_ioLoad.append(0);
+        thread->start();
+    }
+
+    m_dbThread = new QThread(this);
+    m_dbThread->setObjectName("db");
+    m_dbWorker = new DbWorker;
+    m_dbWorker->moveToThread(m_dbThread);
+    connect(m_dbThread, &QThread::finished, m_dbWorker, &QObject::deleteLater);
+    connect(m_dbWorker, &DbWorker::loginVerified, this, &ServerCore::onLoginVerified);
+    m_dbThread->start();
+}
+
+void ServerCore::stopWorkers()
 {
-    while (m_tcpServer->hasPendingConnections()) {
-        QTcpSocket *socket = m_tcpServer->nextPendingConnection();
-        QString ipAddress = socket->peerAddress().toString();
+    // quit() 之后事件循环不再处理排队的调用，所以先各排一个阻塞调用：
+    // 它执行时前面排队的关服通知、断开和落库都已跑完，I/O 线程顺带把写缓冲写出去
+    for (IoWorker *worker : m_ioWorkers) {
+        QMetaObject::invokeMethod(worker, [worker]() { worker->drain(ShutdownDrainMs); },
+                                  Qt::BlockingQueuedConnection);
+    }
+    if (m_dbWorker) QMetaObject::invokeMethod(m_dbWorker, []() {}, Qt::BlockingQueuedConnection);
+
+    for (QThread *thread : m_ioThreads) thread->quit();
+    if (m_dbThread) m_dbThread->quit();
+    for (QThread *thread : m_ioThreads) thread->wait();
+    if (m_dbThread) m_dbThread->wait();
+    m_ioThreads.clear();
+    m_ioWorkers.clear();
+    m_ioLoad.clear();
+    m_dbThread = nullptr;
+    m_dbWorker = nullptr;
+}
 
-        // 添加到临时客户端列表（未登录）
-        ClientInfo info;
-        info.ipAddress = ipAddress;
-        info.connectTime = QDateTime::currentDateTime();
-        info.status = "未登录";
-        info.socket = socket;
+void ServerCore::onIncomingConnection(qintptr descriptor)
+{
+    // 新连接交给当前连接数最少的 I/O 线程，在那边创建套接字
+    int worker = 0;
+    for (int i = 1; i < m_ioLoad.size(); ++i) {
+        if (m_ioLoad[i] < m_ioLoad[worker]) worker = i;
+    }
+    ++m_ioLoad[worker];
+
+    // 先登记再交出去：同一线程发来的 opened 一定排在这条连接的任何消息之前
+    const ClientId socket = m_nextClientId++;
+    ClientInfo info;
+    info.connectTime = QDateTime::currentDateTime();
+    info.status = "未登录";
+    info.socket = socket;
+    info.worker = worker;
+    m_clients.insert(socket, info);
+
+    IoWorker *io = m_ioWorkers[worker];
+    QMetaObject::invokeMethod(io, [io, descriptor, socket]() { io->adopt(descriptor, socket); },
+                              Qt::QueuedConnection);
+}
 
-        m_clients.insert(socket, info);
+void ServerCore::closeClient(ClientId socket, bool abort)
+{
+    auto it = m_clients.constFind(socket);
+    if (it == m_clients.constEnd()) return;
+    IoWorker *io = m_ioWorkers[it->worker];
+    QMetaObject::invokeMethod(io, [io, socket, abort]() { io->close(socket, abort); },
+                              Qt::QueuedConnection);
+}
 
-        connect(socket, &QTcpSocket::disconnected, this, &ServerCore::onClientDisconnected);
-        connect(socket, &QTcpSocket::readyRead, this, &ServerCore::onReadyRead);
+void ServerCore::onClientOpened(ClientId socket, const QString &ipAddress)
+{
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end()) return;
+    it->ipAddress = ipAddress;
 
-        emit logMessage(QString("新的连接: %1").arg(ipAddress), QColor("#2196F3"));
-        emit clientConnected();
+    emit logMessage(QString("新的连接: %1").arg(ipAddress), QColor("#2196F3"));
+    emit clientConnected();
 
-        // 发送欢迎消息
-        QJsonObject welcomeMsg;
-        welcomeMsg["message"] = "欢迎连接到Match3游戏服务器";
-        welcomeMsg["version"] = "1.0.0";
-        welcomeMsg["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    // 发送欢迎消息
+    QJsonObject welcomeMsg;
+    welcomeMsg["message"] = "欢迎连接到Match3游戏服务器";
+    welcomeMsg["version"] = "1.0.0";
+    welcomeMsg["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
 
-        sendResponse(socket, "welcome", welcomeMsg);
-    }
+    sendResponse(socket, Protocol::MsgId::Welcome, welcomeMsg);
 }
 
 // servercore.cpp - 确保onClientDisconnected函数正确发射信号
-void ServerCore::onClientDisconnected()
+void ServerCore::onClientClosed(ClientId socket)
 {
-    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
-    if (!socket) return;
+    const int worker = m_ioWorkers.indexOf(qobject_cast<IoWorker*>(sender()));
+    if (worker >= 0) --m_ioLoad[worker];
 
     if (m_clients.contains(socket)) {
         ClientInfo info = m_clients[socket];
         QString username = info.username;
 
         if (!username.isEmpty()) {
+            m_matchmaker.cancel(username);
+
+            // 对局中掉线：房间和会话保留一段时间等重连，到期再按原逻辑结束
+            if (detachSession(socket, info)) {
+                m_clients.remove(socket);
+                broadcastOnlineList();
+                return;
+            }
+            if (m_sessions.value(username).socket == socket) m_sessions.remove(username);
+
             // 【关键修复】确保从所有映射中移除用户
             m_usernameToSocket.remove(username);
 
@@ -133,70 +248,81 @@ void ServerCore::onClientDisconnected()
         }
 
         m_clients.remove(socket);
-        socket->deleteLater();
 
         // 广播在线列表更新
         broadcastOnlineList();
     }
 }
 
-void ServerCore::onReadyRead()
+void ServerCore::onClientMessage(ClientId socket, const QJsonObject &message)
 {
-    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
-    if (!socket) return;
-
-    QByteArray data = socket->readAll();
-    QJsonParseError error;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    // 已被顶掉或断开的连接，I/O 线程里还没送达的消息直接丢弃
+    if (!m_clients.contains(socket)) return;
+    handleMessage(socket, message);
+}
 
-    if (error.error != QJsonParseError::NoError) {
-        emit logMessage(QString("JSON解析错误: %1").arg(error.errorString()), Qt::red);
-        return;
-    }
+void ServerCore::onProtocolError(ClientId socket, const QString &reason, bool fatal)
+{
+    recordProtocolError(socket, reason, fatal);
+}
 
-    if (!doc.isObject()) {
-        emit logMessage("无效的消息格式", Qt::red);
-        return;
+void ServerCore::recordProtocolError(ClientId socket, const QString &reason, bool fatal)
+{
+    ++m_protocolErrors;
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end()) return;
+
+    const int count = ++it->protocolErrors;
+    const QString who = it->username.isEmpty() ? it->ipAddress : it->username;
+    LOG_WARN("server", "协议错误 [%1] %2，本连接第 %3 次，累计 %4", who, reason, count, m_protocolErrors);
+
+    // 长度头错了后面的字节无法再对齐；连续发坏消息的连接也不再处理
+    if (fatal || count >= MaxProtocolErrors) {
+        emit logMessage(QString("协议错误过多，断开连接 [%1]: %2").arg(who).arg(reason), Qt::red);
+        closeClient(socket, true);
     }
+}
 
-    QJsonObject msg = doc.object();
-    QString type = msg["type"].toString();
-
-
-    // 记录收到的消息（过滤心跳包）
-    if (type != "heartbeat") {
+void ServerCore::handleMessage(ClientId socket, const QJsonObject &msg)
+{
+    // 信封带数字 id，直接 switch；处理函数拿到的都是 data 这一层
+    QJsonObject data;
+    const Protocol::MsgId id = Protocol::open(msg, data);
+    const char *type = Protocol::name(id);
+
+    // 记录收到的消息：心跳和对局帧频率太高，不进界面日志，只走异步日志
+    if (id == Protocol::MsgId::Heartbeat || id == Protocol::MsgId::GameMove) {
+        LOG_TRACE("server", "收到消息 [%1]: %2", m_clients.value(socket).username, type);
+    } else {
         QString from = m_clients.contains(socket) ? m_clients[socket].username : "未知";
         emit logMessage(QString("收到消息 [%1]: %2").arg(from).arg(type), Qt::cyan);
     }
 
-    // 根据消息类型处理
-    if (type == "login") {
-        processLogin(socket, msg);
-    } else if (type == "match_request") {
-        processMatchRequest(socket, msg);
-    } else if (type == "game_move") {
-        processGameMove(socket, msg);
-    } else if (type == "chat") {
-        processChatMessage(socket, msg);
-    } else if (type == "heartbeat") {
-        processHeartbeat(socket, msg);
-    } else if (type == "user_status") {  // 新增：处理用户状态更新
-        processUserStatus(socket, msg);
-    }else if (type == "game_start") {
-        processGameStart(socket, msg);
-    } else if (type == "game_move") {
-        processGameMove(socket, msg);
-    } else if (type == "player_quit") {  // 新增：处理玩家退出
-        processPlayerQuit(socket, msg);
-    } else if (type == "game_end") {
-        processGameEnd(socket, msg);
-    } else {
-        emit logMessage(QString("未知的消息类型: %1").arg(type), Qt::yellow);
+    switch (id) {
+    case Protocol::MsgId::Login:        processLogin(socket, data); break;
+    case Protocol::MsgId::MatchRequest: processMatchRequest(socket, data); break;
+    case Protocol::MsgId::CancelMatch:  processCancelMatch(socket, data); break;
+    case Protocol::MsgId::GameMove:     processGameMove(socket, data); break;
+    case Protocol::MsgId::Chat:         processChatMessage(socket, data); break;
+    case Protocol::MsgId::Heartbeat:    processHeartbeat(socket, data); break;
+    case Protocol::MsgId::UserStatus:   processUserStatus(socket, data); break;
+    case Protocol::MsgId::GameStart:    processGameStart(socket, data); break;
+    case Protocol::MsgId::PlayerQuit:   processPlayerQuit(socket, data); break;
+    case Protocol::MsgId::GameEnd:      processGameEnd(socket, data); break;
+    case Protocol::MsgId::Resume:       processResume(socket, data); break;
+    case Protocol::MsgId::GetOnlineList: processGetOnlineList(socket, data); break;
+    case Protocol::MsgId::Unknown:
+        recordProtocolError(socket, QString("未知的消息类型: %1").arg(msg["type"].toString()));
+        break;
+    default:
+        // 协议表里有、但服务器不处理的消息（如 logout）
+        emit logMessage(QString("未处理的消息类型: %1").arg(type), Qt::yellow);
+        break;
     }
 }
 
 // 实现processGameEnd函数
-void ServerCore::processGameEnd(QTcpSocket *socket, const QJsonObject &data)
+void ServerCore::processGameEnd(ClientId socket, const QJsonObject &data)
 {
     if (!m_clients.contains(socket)) return;
 
@@ -230,14 +356,14 @@ void ServerCore::processGameEnd(QTcpSocket *socket, const QJsonObject &data)
             // 只有一方结束，通知对手
             QString opponent = (room.player1 == username) ? room.player2 : room.player1;
             if (m_usernameToSocket.contains(opponent)) {
-                QTcpSocket *opponentSocket = m_usernameToSocket[opponent];
+                ClientId opponentSocket = m_usernameToSocket[opponent];
 
                 QJsonObject opponentMsg;
                 opponentMsg["type"] = "opponent_finished";
                 opponentMsg["username"] = username;
                 opponentMsg["score"] = finalScore;
 
-                sendResponse(opponentSocket, "game_update", opponentMsg);
+                sendResponse(opponentSocket, Protocol::MsgId::GameUpdate, opponentMsg);
 
                 emit logMessage(QString("玩家 %1 已完成游戏，分数: %2").arg(username).arg(finalScore),
                                 QColor("#4CAF50"));
@@ -246,23 +372,49 @@ void ServerCore::processGameEnd(QTcpSocket *socket, const QJsonObject &data)
     }
 }
 
-void ServerCore::processLogin(QTcpSocket *socket, const QJsonObject &data)
+void ServerCore::processLogin(ClientId socket, const QJsonObject &data)
 {
-    QString username = data["username"].toString();
-    QString password = data["password"].toString();
+    const Protocol::Login login = Protocol::Login::fromJson(data);
+    const QString username = login.username;
+    const QString password = login.password;
+
+    // 数据库校验在 DB 线程里做，结果回到 onLoginVerified 接着处理
+    DbWorker *db = m_dbWorker;
+    QMetaObject::invokeMethod(db, [db, socket, username, password, data]() {
+        db->verifyLogin(socket, username, password, data);
+    }, Qt::QueuedConnection);
+}
 
-    QJsonObject response;
+void ServerCore::onLoginVerified(ClientId socket, const QString &username, bool ok,
+                                 const QJsonObject &userData, const QJsonObject &data)
+{
+    // 校验期间连接已经断开
+    if (!m_clients.contains(socket)) return;
 
-    // 检查数据库验证
-    Database db;
-    if (db.verifyUser(username, password)) {
+    const Protocol::Login login = Protocol::Login::fromJson(data);
+    Protocol::LoginResult response;
+    WireCodec::Format codec = WireCodec::Json;
+
+    // 负载格式协商：按客户端给出的偏好顺序取第一个认识的；一个都不认识（含不带 codecs 的旧版）就不让登录
+    bool negotiated = false;
+    for (const QJsonValue &v : login.codecs) {
+        if (WireCodec::fromName(v.toString(), codec)) {
+            negotiated = true;
+            break;
+        }
+    }
+
+    if (ok && !negotiated) {
+        response.success = false;
+        response.message = "客户端版本过旧，请更新后再登录";
+    } else if (ok) {
         // 检查是否已经登录
         if (m_usernameToSocket.contains(username)) {
             // 如果是同一用户重新连接，更新socket映射
-            QTcpSocket *oldSocket = m_usernameToSocket[username];
+            ClientId oldSocket = m_usernameToSocket[username];
             if (oldSocket != socket) {
                 // 关闭旧的连接
-                oldSocket->disconnectFromHost();
+                closeClient(oldSocket);
                 m_clients.remove(oldSocket);
                 m_usernameToSocket[username] = socket;
             }
@@ -277,13 +429,21 @@ void ServerCore::processLogin(QTcpSocket *socket, const QJsonObject &data)
         // 【关键修复】确保用户名到socket的映射正确建立
         m_usernameToSocket[username] = socket;
 
-        response["success"] = true;
-        response["message"] = "登录成功";
-        response["username"] = username;
+        RatingState &rating = m_ratings[username];
+        rating.rating = userData.value("online_rating").toInt(Rating::Initial);
+        rating.games = userData.value("online_wins").toInt() + userData.value("online_losses").toInt();
+
+        response.success = true;
+        response.message = "登录成功";
+        response.username = username;
 
         // 发送用户数据
-        QJsonObject userData = db.getUserData(username);
-        response["user_data"] = userData;
+        response.userData = userData;
+
+        // 会话令牌：对局中掉线后凭它重连，不用重新登录和匹配
+        response.sessionToken = openSession(username, socket);
+        response.resumeGrace = SessionGraceSecs;
+        response.codec = WireCodec::name(codec);
 
         // 如果用户在房间中，更新房间中的socket映射
         if (m_userToRoom.contains(username)) {
@@ -301,43 +461,216 @@ void ServerCore::processLogin(QTcpSocket *socket, const QJsonObject &data)
         // 广播在线列表更新
         broadcastOnlineList();
     } else {
-        response["success"] = false;
-        response["message"] = "用户名或密码错误";
+        response.success = false;
+        response.message = "用户名或密码错误";
     }
 
-    sendResponse(socket, "login_result", response);
+    sendResponse(socket, Protocol::MsgId::LoginResult, response.toJson());
+
+    // login_result 本身仍按 JSON 发出，之后的下行才切换
+    if (m_clients.contains(socket)) m_clients[socket].codec = codec;
 }
 
-void ServerCore::processPlayerQuit(QTcpSocket *socket, const QJsonObject &data)
+QString ServerCore::openSession(const QString &username, ClientId socket)
 {
-    if (!m_clients.contains(socket)) return;
+    // 同一用户重新登录：旧会话作废，掉线中的对局按原逻辑结束
+    if (m_sessions.contains(username) && !m_sessions[username].socket) expireSession(username);
+    if (m_sessions.contains(username) && m_sessions[username].graceTimer) {
+        m_sessions[username].graceTimer->deleteLater();
+    }
 
-    QString quitter = data["quitter"].toString();
-    QString opponent = data["opponent"].toString();
+    QByteArray raw(16, Qt::Uninitialized);
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32*>(raw.data()), raw.size() / 4);
 
-    qDebug() << "处理玩家退出，退出者:" << quitter << "，对手:" << opponent;
+    Session s;
+    s.token = QString::fromLatin1(raw.toHex());
+    s.socket = socket;
+    m_sessions[username] = s;
+    return s.token;
+}
 
-    // 根据用户名查找房间ID
-    QString roomId;
+bool ServerCore::detachSession(ClientId socket, const ClientInfo &info)
+{
+    const QString username = info.username;
+    auto it = m_sessions.find(username);
+    if (it == m_sessions.end() || it->socket != socket) return false;
+
+    // 只有进行中的对局值得保留，其它情况直接按下线处理
+    const QString roomId = m_userToRoom.value(username);
+    if (roomId.isEmpty() || !m_gameRooms.contains(roomId) || m_gameRooms[roomId].gameEnded) return false;
+
+    Session &s = it.value();
+    s.socket = 0;
+    s.status = info.status;
+    s.gameMode = info.gameMode;
+    s.codec = info.codec;
+    s.missed.clear();
+    s.missedOverflow = false;
+
+    s.graceTimer = new QTimer(this);
+    s.graceTimer->setSingleShot(true);
+    connect(s.graceTimer, &QTimer::timeout, this, [this, username]() { expireSession(username); });
+    s.graceTimer->start(SessionGraceSecs * 1000);
+
+    m_usernameToSocket.remove(username);
+    notifyOpponentLink(username, "lost");
+
+    emit logMessage(QString("玩家 %1 对局中掉线，保留房间 %2 秒等待重连")
+                        .arg(username).arg(SessionGraceSecs), QColor("#FF9800"));
+    return true;
+}
+
+void ServerCore::expireSession(const QString &username)
+{
+    auto it = m_sessions.find(username);
+    if (it == m_sessions.end() || it->socket) return;
+
+    if (it->graceTimer) it->graceTimer->deleteLater();
+    m_sessions.erase(it);
+
+    // 宽限期内没回来：与以前掉线的处理一致
+    notifyOpponentLink(username, "expired");
+    if (m_userToRoom.contains(username)) {
+        QString roomId = m_userToRoom[username];
+        m_userToRoom.remove(username);
+
+        if (m_gameRooms.contains(roomId)) {
+            GameRoom &room = m_gameRooms[roomId];
+            if (!room.gameEnded) {
+                // 超时未归按判负结算，在线的一方收到结束消息
+                room.gameEnded = true;
+                const QString winner = (username == room.player1) ? room.player2 : room.player1;
+
+                QJsonObject endMsg;
+                endMsg["room_id"] = roomId;
+                endMsg["player1_score"] = room.player1Score;
+                endMsg["player2_score"] = room.player2Score;
+                endMsg["player1"] = room.player1;
+                endMsg["player2"] = room.player2;
+                endMsg["winner"] = winner;
+                endMsg["reason"] = "对手断线超时";
+                endMsg["quitter"] = username;
+                settleRatings(room, winner, endMsg);
+
+                ClientId winnerSocket = m_usernameToSocket.value(winner);
+                if (m_clients.contains(winnerSocket)) sendResponse(winnerSocket, Protocol::MsgId::GameEnd, endMsg);
+            }
+            cleanupRoom(roomId);
+        }
+    }
+
+    emit logMessage(QString("玩家 %1 重连超时，对局结束").arg(username), QColor("#FF9800"));
+    emit clientDisconnected(username);
+}
+
+bool ServerCore::queueMissed(const QString &username, Protocol::MsgId id, const QJsonObject &data)
+{
+    auto it = m_sessions.find(username);
+    if (it == m_sessions.end() || it->socket) return false;
 
-    // 首先尝试用退出者查找
-    if (m_userToRoom.contains(quitter)) {
-        roomId = m_userToRoom[quitter];
-        qDebug() << "通过退出者找到房间ID:" << roomId;
+    if (it->missed.size() < MaxMissedMessages) it->missed.append(envelope(id, data));
+    else it->missedOverflow = true;
+    return true;
+}
+
+void ServerCore::notifyOpponentLink(const QString &username, const QString &state)
+{
+    const QString roomId = m_userToRoom.value(username);
+    if (!m_gameRooms.contains(roomId)) return;
+
+    const GameRoom &room = m_gameRooms[roomId];
+    const QString opponent = (room.player1 == username) ? room.player2 : room.player1;
+
+    QJsonObject msg;
+    msg["player"] = username;
+    msg["state"] = state;                 // lost / restored / expired
+    msg["grace"] = SessionGraceSecs;
+    sendResponse(m_usernameToSocket.value(opponent), Protocol::MsgId::OpponentLink, msg);
+}
+
+void ServerCore::processResume(ClientId socket, const QJsonObject &data)
+{
+    const Protocol::Resume request = Protocol::Resume::fromJson(data);
+    const QString username = request.username;
+
+    Protocol::ResumeResult response;
+    auto it = m_sessions.find(username);
+    if (request.token.isEmpty() || it == m_sessions.end() || it->token != request.token) {
+        response.success = false;
+        response.message = "会话已过期，请重新登录";
+        sendResponse(socket, Protocol::MsgId::ResumeResult, response.toJson());
+        return;
     }
-    // 如果找不到，尝试用对手查找
-    else if (m_userToRoom.contains(opponent)) {
-        roomId = m_userToRoom[opponent];
-        qDebug() << "通过对手找到房间ID:" << roomId;
+
+    Session &s = it.value();
+    if (s.socket && s.socket != socket) {
+        // 服务器还没发现旧连接断开（半开连接），直接顶掉
+        ClientId oldSocket = s.socket;
+        closeClient(oldSocket, true);
+        m_clients.remove(oldSocket);
     }
-    // 如果都找不到，尝试从数据中获取
-    else if (data.contains("room_id")) {
-        roomId = data["room_id"].toString();
-        qDebug() << "从数据中获取房间ID:" << roomId;
+    if (s.graceTimer) {
+        s.graceTimer->stop();
+        s.graceTimer->deleteLater();
+        s.graceTimer = nullptr;
     }
+    s.socket = socket;
+
+    ClientInfo &info = m_clients[socket];
+    info.username = username;
+    info.status = s.status.isEmpty() ? "在线" : s.status;
+    info.gameMode = s.gameMode.isEmpty() ? "空闲" : s.gameMode;
+    m_usernameToSocket[username] = socket;
+
+    response.success = true;
+    response.username = username;
+    response.codec = WireCodec::name(s.codec);
+
+    // 状态快照：房间、双方分数和服务器记录的最后一份棋盘
+    const QString roomId = m_userToRoom.value(username);
+    if (m_gameRooms.contains(roomId)) {
+        const GameRoom &room = m_gameRooms[roomId];
+        const bool first = room.player1 == username;
+        response.roomId = roomId;
+        response.seed = room.seed;
+        response.opponent = first ? room.player2 : room.player1;
+        response.myScore = first ? room.player1Score : room.player2Score;
+        response.opponentScore = first ? room.player2Score : room.player1Score;
+        response.opponentBoard = first ? room.player2Board : room.player1Board;
+    }
+
+    // 掉线期间错过的消息，按原顺序补发
+    for (const QJsonObject &m : s.missed) response.missed.append(m);
+    response.missedTruncated = s.missedOverflow;
+    const int missedCount = s.missed.size();
+    s.missed.clear();
+    s.missedOverflow = false;
+
+    sendResponse(socket, Protocol::MsgId::ResumeResult, response.toJson());
+    if (m_clients.contains(socket)) m_clients[socket].codec = s.codec;
+
+    notifyOpponentLink(username, "restored");
+    emit logMessage(QString("玩家 %1 重连成功，补发 %2 条消息").arg(username).arg(missedCount),
+                    QColor("#4CAF50"));
+    broadcastOnlineList();
+}
+
+void ServerCore::processPlayerQuit(ClientId socket, const QJsonObject &data)
+{
+    if (!m_clients.contains(socket)) return;
+
+    // 退出者只认这条连接登录的用户，负载里的 quitter / opponent 不可信（会触发等级分结算）
+    const QString quitter = m_clients[socket].username;
+    if (quitter.isEmpty()) return;
+
+    qDebug() << "处理玩家退出，退出者:" << quitter;
+
+    // 根据用户名查找房间ID；负载里的 room_id 只作后备，下面还要核对退出者在不在房间里
+    QString roomId = m_userToRoom.value(quitter);
+    if (roomId.isEmpty()) roomId = data["room_id"].toString();
 
     if (roomId.isEmpty()) {
-        qDebug() << "无法找到房间，退出者:" << quitter << "，对手:" << opponent;
+        qDebug() << "无法找到房间，退出者:" << quitter;
         emit logMessage(QString("无法处理玩家 %1 退出：找不到对应的房间")
                             .arg(quitter), QColor("#FF9800"));
         return;
@@ -360,9 +693,17 @@ void ServerCore::processPlayerQuit(QTcpSocket *socket, const QJsonObject &data)
             winner = room.player1;
         }
 
-        // 更新分数
-        room.player1Score = data["player1_score"].toInt();
-        room.player2Score = data["player2_score"].toInt();
+        // 中途退出按判负结算；对局已经正常结束（结算过）的不再重复算。
+        // 分数用服务器自己从对局帧里记下的，不信负载里的 player1_score / player2_score
+        QJsonObject endMsg;
+        endMsg["room_id"] = roomId;
+        endMsg["player1_score"] = room.player1Score;
+        endMsg["player2_score"] = room.player2Score;
+        endMsg["player1"] = room.player1;
+        endMsg["player2"] = room.player2;
+        endMsg["winner"] = winner;
+        endMsg["quitter"] = quitter;
+        if (!room.gameEnded) settleRatings(room, winner, endMsg);
 
         // 标记游戏结束
         room.gameEnded = true;
@@ -376,19 +717,10 @@ void ServerCore::processPlayerQuit(QTcpSocket *socket, const QJsonObject &data)
                  << "，房间ID:" << roomId;
 
         // 发送游戏结束消息给获胜者
-        QTcpSocket *winnerSocket = m_usernameToSocket.value(winner);
-        if (winnerSocket && winnerSocket->isValid()) {
-            QJsonObject endMsg;
-            endMsg["room_id"] = roomId;
-            endMsg["player1_score"] = room.player1Score;
-            endMsg["player2_score"] = room.player2Score;
-            endMsg["player1"] = room.player1;
-            endMsg["player2"] = room.player2;
-            endMsg["winner"] = winner;
+        ClientId winnerSocket = m_usernameToSocket.value(winner);
+        if (m_clients.contains(winnerSocket)) {
             endMsg["reason"] = "对手退出";
-            endMsg["quitter"] = quitter;
-
-            sendResponse(winnerSocket, "game_end", endMsg);
+            sendResponse(winnerSocket, Protocol::MsgId::GameEnd, endMsg);
 
             qDebug() << "发送获胜消息给:" << winner;
 
@@ -401,19 +733,10 @@ void ServerCore::processPlayerQuit(QTcpSocket *socket, const QJsonObject &data)
         }
 
         // 如果退出者还在线，也发送结束消息
-        QTcpSocket *quitterSocket = m_usernameToSocket.value(quitter);
-        if (quitterSocket && quitterSocket->isValid()) {
-            QJsonObject endMsg;
-            endMsg["room_id"] = roomId;
-            endMsg["player1_score"] = room.player1Score;
-            endMsg["player2_score"] = room.player2Score;
-            endMsg["player1"] = room.player1;
-            endMsg["player2"] = room.player2;
-            endMsg["winner"] = winner;
+        ClientId quitterSocket = m_usernameToSocket.value(quitter);
+        if (m_clients.contains(quitterSocket)) {
             endMsg["reason"] = "你已退出";
-            endMsg["quitter"] = quitter;
-
-            sendResponse(quitterSocket, "game_end", endMsg);
+            sendResponse(quitterSocket, Protocol::MsgId::GameEnd, endMsg);
         }
 
         // 延迟清理房间（给客户端处理时间）
@@ -440,119 +763,139 @@ void ServerCore::processPlayerQuit(QTcpSocket *socket, const QJsonObject &data)
 }
 
 // 修改 processMatchRequest 函数中的房间创建和状态更新部分
-void ServerCore::processMatchRequest(QTcpSocket *socket, const QJsonObject &data)
+void ServerCore::processMatchRequest(ClientId socket, const QJsonObject &data)
 {
     if (!m_clients.contains(socket)) return;
 
     ClientInfo &info = m_clients[socket];
     QString username = info.username;
-    QString gameMode = data["mode"].toString();
-
-    // 创建房间ID
-    QString roomId = QString("room_%1_%2").arg(QDateTime::currentSecsSinceEpoch()).arg(QRandomGenerator::global()->bounded(1000));
+    QString gameMode = Protocol::MatchRequest::fromJson(data).mode;
 
-    // 检查是否有等待中的玩家
-    QString waitingPlayer;
-    for (const ClientInfo &client : m_clients.values()) {
-        if (client.status == "匹配中" && client.username != username) {
-            waitingPlayer = client.username;
-            break;
-        }
+    Protocol::MatchResponse response;
+    if (username.isEmpty()) {
+        response.success = false;
+        response.message = "请先登录";
+        sendResponse(socket, Protocol::MsgId::MatchResponse, response.toJson());
+        return;
     }
 
-    QJsonObject response;
-
-    if (!waitingPlayer.isEmpty()) {
-        // 找到对手，创建房间
-        GameRoom room;
-        room.roomId = roomId;
-        room.player1 = waitingPlayer;
-        room.player2 = username;
-        room.player1Score = 0;
-        room.player2Score = 0;
-        room.gameStarted = false;
-        room.gameEnded = false;
-        room.player1Ready = false;
-        room.player2Ready = false;
-        room.timer = nullptr;
-
-        // 【关键修复】确保房间和用户映射正确建立
-        m_gameRooms[roomId] = room;
-        m_userToRoom[waitingPlayer] = roomId;
-        m_userToRoom[username] = roomId;
-
-        // 获取双方的socket - 确保能从映射中找到
-        QTcpSocket *player1Socket = m_usernameToSocket.value(waitingPlayer);
-        QTcpSocket *player2Socket = m_usernameToSocket.value(username);
-
-        // 【关键修复】如果找不到socket，可能是映射有问题
-        if (!player1Socket) {
-            qDebug() << "找不到玩家1的socket:" << waitingPlayer;
-            // 尝试从m_clients中查找
-            for (QTcpSocket *sock : m_clients.keys()) {
-                if (m_clients[sock].username == waitingPlayer) {
-                    player1Socket = sock;
-                    break;
-                }
-            }
-        }
-
-        if (!player2Socket) {
-            qDebug() << "找不到玩家2的socket:" << username;
-            // player2Socket 应该是当前的socket
-            player2Socket = socket;
-        }
+    // 只入队，配对由 onMatchTick 批量完成
+    const int rating = m_ratings.value(username).rating;
+    const int position = m_matchmaker.enqueue(username, gameMode, rating,
+                                              QDateTime::currentMSecsSinceEpoch());
+    info.status = "匹配中";
+    info.gameMode = gameMode;
+    if (!m_matchTimer->isActive()) m_matchTimer->start();
 
-        // 确保两个socket都存在
-        if (player1Socket && player2Socket) {
-            // 更新双方状态
-            if (m_clients.contains(player1Socket)) {
-                m_clients[player1Socket].status = "联机游戏中";
-                m_clients[player1Socket].gameMode = gameMode;
-            }
-            if (m_clients.contains(player2Socket)) {
-                m_clients[player2Socket].status = "联机游戏中";
-                m_clients[player2Socket].gameMode = gameMode;
-            }
+    response.success = true;
+    response.message = "已加入匹配队列";
+    response.queuePosition = position;
 
-            // 发送匹配成功消息
-            QJsonObject matchSuccess1;
-            matchSuccess1["room_id"] = roomId;
-            matchSuccess1["player1"] = waitingPlayer;
-            matchSuccess1["player2"] = username;
-            matchSuccess1["game_mode"] = gameMode;
-            matchSuccess1["match_time"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-            sendResponse(player1Socket, "match_found", matchSuccess1);
+    sendResponse(socket, Protocol::MsgId::MatchResponse, response.toJson());
+    broadcastOnlineList();
+}
 
-            QJsonObject matchSuccess2;
-            matchSuccess2["room_id"] = roomId;
-            matchSuccess2["player1"] = waitingPlayer;
-            matchSuccess2["player2"] = username;
-            matchSuccess2["game_mode"] = gameMode;
-            matchSuccess2["match_time"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-            sendResponse(player2Socket, "match_found", matchSuccess2);
-        }
+void ServerCore::processCancelMatch(ClientId socket, const QJsonObject &data)
+{
+    Q_UNUSED(data);
+    if (!m_clients.contains(socket)) return;
 
-        response["success"] = true;
-        response["message"] = "匹配成功";
-        response["room_id"] = roomId;
+    ClientInfo &info = m_clients[socket];
+    if (!m_matchmaker.cancel(info.username)) return;   // 已经配上了，以 match_found 为准
 
-    } else {
-        // 没有找到对手，加入等待队列
-        info.status = "匹配中";
-        info.gameMode = gameMode;
+    info.status = "在线";
+    sendResponse(socket, Protocol::MsgId::MatchCancelled);
+    broadcastOnlineList();
+}
 
-        response["success"] = true;
-        response["message"] = "已加入匹配队列";
-        response["queue_position"] = 1;
+void ServerCore::onMatchTick()
+{
+    const QVector<Matchmaker::Pairing> pairs = m_matchmaker.formMatches(QDateTime::currentMSecsSinceEpoch());
+    for (const Matchmaker::Pairing &pair : pairs) startMatch(pair);
+
+    // 前面有人配上或取消，名次前移了的告诉客户端
+    const QVector<Matchmaker::PositionUpdate> updates = m_matchmaker.takePositionUpdates();
+    for (const Matchmaker::PositionUpdate &u : updates) {
+        Protocol::MatchResponse response;
+        response.success = true;
+        response.message = "匹配中";
+        response.queuePosition = u.position;
+        sendResponse(m_usernameToSocket.value(u.username), Protocol::MsgId::MatchResponse, response.toJson());
     }
 
-    sendResponse(socket, "match_response", response);
-    broadcastOnlineList();
+    if (m_matchmaker.isEmpty()) m_matchTimer->stop();
+    if (!pairs.isEmpty()) broadcastOnlineList();
+}
+
+void ServerCore::startMatch(const Matchmaker::Pairing &pair)
+{
+    const QString waitingPlayer = pair.first.username;
+    const QString username = pair.second.username;
+    const QString gameMode = pair.first.mode;
+
+    // 创建房间ID；同一周期可能一次开好几个房间，撞号就重取
+    QString roomId;
+    do {
+        roomId = QString("room_%1_%2").arg(QDateTime::currentSecsSinceEpoch()).arg(QRandomGenerator::global()->bounded(1000));
+    } while (m_gameRooms.contains(roomId));
+
+    emit logMessage(QString("匹配成功 [%1]: %2(%3) vs %4(%5)，排队 %6 ms")
+                        .arg(gameMode)
+                        .arg(waitingPlayer).arg(pair.first.rating)
+                        .arg(username).arg(pair.second.rating)
+                        .arg(QDateTime::currentMSecsSinceEpoch() - pair.first.enqueuedMs),
+                    QColor("#4CAF50"));
+
+    GameRoom room;
+    room.roomId = roomId;
+    room.player1 = waitingPlayer;
+    room.player2 = username;
+    room.player1Score = 0;
+    room.player2Score = 0;
+    room.gameStarted = false;
+    room.gameEnded = false;
+    room.player1Ready = false;
+    room.player2Ready = false;
+    room.timer = nullptr;
+    room.seed = QRandomGenerator::global()->bounded(1u, 0xFFFFFFFFu);  // 0 留给“不支持确定性同步”
+
+    // 【关键修复】确保房间和用户映射正确建立
+    m_gameRooms[roomId] = room;
+    m_userToRoom[waitingPlayer] = roomId;
+    m_userToRoom[username] = roomId;
+
+    // 排队的人断线时已经出队，映射一定在
+    ClientId player1Socket = m_usernameToSocket.value(waitingPlayer);
+    ClientId player2Socket = m_usernameToSocket.value(username);
+
+    // 确保两个socket都存在
+    if (player1Socket && player2Socket) {
+        // 更新双方状态
+        if (m_clients.contains(player1Socket)) {
+            m_clients[player1Socket].status = "联机游戏中";
+            m_clients[player1Socket].gameMode = gameMode;
+        }
+        if (m_clients.contains(player2Socket)) {
+            m_clients[player2Socket].status = "联机游戏中";
+            m_clients[player2Socket].gameMode = gameMode;
+        }
+
+        // 发送匹配成功消息：双方内容相同
+        Protocol::MatchFound match;
+        match.roomId = roomId;
+        match.player1 = waitingPlayer;
+        match.player2 = username;
+        match.gameMode = gameMode;
+        match.seed = room.seed;
+        match.matchTime = QDateTime::currentDateTime().toString(Qt::ISODate);
+        const QJsonObject matchMsg = match.toJson();
+        sendResponse(player1Socket, Protocol::MsgId::MatchFound, matchMsg);
+        sendResponse(player2Socket, Protocol::MsgId::MatchFound, matchMsg);
+    }
 }
 
 // 实现processGameStart函数
-void ServerCore::processGameStart(QTcpSocket *socket, const QJsonObject &data)
+void ServerCore::processGameStart(ClientId socket, const QJsonObject &data)
 {
     if (!m_clients.contains(socket)) return;
 
@@ -585,57 +928,54 @@ void ServerCore::processGameStart(QTcpSocket *socket, const QJsonObject &data)
     }
 }
 
-void ServerCore::processGameMove(QTcpSocket *socket, const QJsonObject &data)
+void ServerCore::processGameMove(ClientId socket, const QJsonObject &data)
 {
     if (!m_clients.contains(socket)) return;
 
     QString username = m_clients[socket].username;
 
     // 【添加调试信息】查看原始数据
-    qDebug() << "收到game_move消息，用户:" << username;
-    qDebug() << "原始数据:" << QJsonDocument(data).toJson(QJsonDocument::Compact);
+    LOG_DEBUG("server", "收到game_move，用户 %1", username);
+    LOG_TRACE("server", "game_move 原始数据 %1", data);   // JSON 在写线程里序列化
+
+    Protocol::GameMove mv = Protocol::GameMove::fromJson(data);
 
     // 检查是否有房间ID
-    QString roomId = data["room_id"].toString();
+    QString roomId = mv.roomId;
     if (roomId.isEmpty() && m_userToRoom.contains(username)) {
         roomId = m_userToRoom[username];
     }
 
     if (roomId.isEmpty()) {
-        qDebug() << "房间ID为空，无法处理";
+        LOG_WARN("server", "game_move 房间ID为空，用户 %1", username);
         return;
     }
 
-    qDebug() << "房间ID:" << roomId;
 
     if (m_gameRooms.contains(roomId)) {
         GameRoom &room = m_gameRooms[roomId];
 
-        // 更新棋盘状态和分数
-        QJsonArray board = data["board"].toArray();
-        int score = data["score"].toInt();
-
-        // 【添加调试】检查棋盘数据
-        qDebug() << "棋盘数组大小:" << board.size();
-        qDebug() << "分数:" << score;
-
+        // 操作帧只带分数，整盘快照才带 board；没带的字段不覆盖房间里的记录
         if (room.player1 == username) {
-            room.player1Board = board;
-            room.player1Score = score;
+            if (!mv.board.isEmpty()) room.player1Board = mv.board;
+            if (mv.score >= 0) room.player1Score = mv.score;
         } else if (room.player2 == username) {
-            room.player2Board = board;
-            room.player2Score = score;
+            if (!mv.board.isEmpty()) room.player2Board = mv.board;
+            if (mv.score >= 0) room.player2Score = mv.score;
         }
 
-        // 转发给对手
+        // 转发给对手：原样转发操作字段，只改写来源
         QString opponent = (room.player1 == username) ? room.player2 : room.player1;
-        qDebug() << "对手:" << opponent;
+        mv.roomId = roomId;
+        mv.opponent = username;  // 发送者是当前用户
+        mv.player = username;
+        const QJsonObject forwardData = mv.toJson();
 
-        QTcpSocket *opponentSocket = m_usernameToSocket.value(opponent);
+        ClientId opponentSocket = m_usernameToSocket.value(opponent);
 
         if (!opponentSocket) {
             // 如果找不到，从客户端列表中查找
-            for (QTcpSocket *sock : m_clients.keys()) {
+            for (ClientId sock : m_clients.keys()) {
                 if (m_clients[sock].username == opponent) {
                     opponentSocket = sock;
                     break;
@@ -643,27 +983,14 @@ void ServerCore::processGameMove(QTcpSocket *socket, const QJsonObject &data)
             }
         }
 
-        if (opponentSocket && opponentSocket->isValid()) {
-            // 【关键修复】创建标准格式的消息
-            QJsonObject forwardData;
-            forwardData["type"] = "game_move";
-            forwardData["room_id"] = roomId;
-            forwardData["opponent"] = username;  // 发送者是当前用户
-            forwardData["board"] = board;        // 棋盘数据在顶层
-            forwardData["score"] = score;        // 分数在顶层
-            forwardData["player"] = username;    // 添加player字段
-            forwardData["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-
-            // 添加调试信息
-            qDebug() << "转发数据给对手:" << opponent;
-            qDebug() << "转发数据大小:" << board.size();
-
-            sendResponse(opponentSocket, "game_move", forwardData);
-        } else {
-            qDebug() << "找不到对手socket或socket无效:" << opponent;
+        if (m_clients.contains(opponentSocket)) {
+            LOG_TRACE("server", "转发给 %1，房间 %2，操作 %3", opponent, roomId, mv.op);
+            sendResponse(opponentSocket, Protocol::MsgId::GameMove, forwardData);
+        } else if (!queueMissed(opponent, Protocol::MsgId::GameMove, forwardData)) {
+            LOG_WARN("server", "找不到对手socket或socket无效: %1", opponent);
         }
     } else {
-        qDebug() << "房间不存在:" << roomId;
+        LOG_WARN("server", "game_move 房间不存在: %1", roomId);
     }
 }
 
@@ -677,8 +1004,8 @@ void ServerCore::handleGameStart(const QString &roomId)
     room.startTime = QDateTime::currentDateTime();
 
     // 发送开始信号给双方
-    QTcpSocket *socket1 = m_usernameToSocket.value(room.player1);
-    QTcpSocket *socket2 = m_usernameToSocket.value(room.player2);
+    ClientId socket1 = m_usernameToSocket.value(room.player1);
+    ClientId socket2 = m_usernameToSocket.value(room.player2);
 
     if (socket1 && socket2) {
         QJsonObject startMsg;
@@ -688,10 +1015,10 @@ void ServerCore::handleGameStart(const QString &roomId)
         startMsg["game_mode"] = "闪电";
         startMsg["duration"] = 180; // 3分钟
 
-        sendResponse(socket1, "game_start", startMsg);
+        sendResponse(socket1, Protocol::MsgId::GameStart, startMsg);
 
         startMsg["opponent"] = room.player1;
-        sendResponse(socket2, "game_start", startMsg);
+        sendResponse(socket2, Protocol::MsgId::GameStart, startMsg);
 
         // 设置游戏结束定时器（3分钟）
         room.timer = new QTimer(this);
@@ -699,10 +1026,8 @@ void ServerCore::handleGameStart(const QString &roomId)
         room.timer->setInterval(180000); // 3分钟 = 180000毫秒
 
         connect(room.timer, &QTimer::timeout, this, [this, roomId]() {
-            if (m_gameRooms.contains(roomId)) {
-                m_gameRooms[roomId].gameEnded = true;
-                handleGameEnd(roomId);
-            }
+            // gameEnded 由 handleGameEnd 自己置位，这里先置位会让它当成已结算直接返回
+            handleGameEnd(roomId);
         });
 
         room.timer->start();
@@ -753,32 +1078,40 @@ void ServerCore::handleGameEnd(const QString &roomId)
         winner = "draw"; // 平局
     }
 
+    QJsonObject endMsg;
+    endMsg["room_id"] = roomId;
+    endMsg["player1_score"] = room.player1Score;
+    endMsg["player2_score"] = room.player2Score;
+    endMsg["winner"] = winner;
+    endMsg["duration"] = duration;
+    endMsg["game_mode"] = "闪电";
+    endMsg["end_time"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    settleRatings(room, winner, endMsg);
+
     // 发送结束信号给双方
-    QTcpSocket *socket1 = m_usernameToSocket.value(room.player1);
-    QTcpSocket *socket2 = m_usernameToSocket.value(room.player2);
+    ClientId socket1 = m_usernameToSocket.value(room.player1);
+    ClientId socket2 = m_usernameToSocket.value(room.player2);
 
     if (socket1 || socket2) {
-        QJsonObject endMsg;
-        endMsg["room_id"] = roomId;
-        endMsg["player1_score"] = room.player1Score;
-        endMsg["player2_score"] = room.player2Score;
-        endMsg["winner"] = winner;
-        endMsg["duration"] = duration;
-        endMsg["game_mode"] = "闪电";
-        endMsg["end_time"] = QDateTime::currentDateTime().toString(Qt::ISODate);
 
         if (socket1) {
-            sendResponse(socket1, "game_end", endMsg);
+            sendResponse(socket1, Protocol::MsgId::GameEnd, endMsg);
+        } else {
+            queueMissed(room.player1, Protocol::MsgId::GameEnd, endMsg);
         }
         if (socket2) {
-            sendResponse(socket2, "game_end", endMsg);
+            sendResponse(socket2, Protocol::MsgId::GameEnd, endMsg);
+        } else {
+            queueMissed(room.player2, Protocol::MsgId::GameEnd, endMsg);
         }
 
         // 保存对战记录到数据库
-        Database db;
-        db.saveOnlineMatch(room.player1, room.player2,
-                           room.player1Score, room.player2Score,
-                           winner);
+        DbWorker *db = m_dbWorker;
+        const QString player1 = room.player1, player2 = room.player2;
+        const int score1 = room.player1Score, score2 = room.player2Score;
+        QMetaObject::invokeMethod(db, [=]() {
+            db->saveOnlineMatch(player1, player2, score1, score2, winner);
+        }, Qt::QueuedConnection);
 
         emit logMessage(QString("游戏房间 %1 结束: %2 %3 vs %4 %5, 胜者: %6")
                             .arg(roomId)
@@ -795,6 +1128,33 @@ void ServerCore::handleGameEnd(const QString &roomId)
     });
 }
 
+// Elo 结算：双方都按赛前分数算，一起写回缓存，新分和变化写进结束消息，再交给 DB 线程落库。
+// winner 为 "draw" 表示平局；中途退出、重连超时按判负处理，同样走这里
+void ServerCore::settleRatings(const GameRoom &room, const QString &winner, QJsonObject &endMsg)
+{
+    RatingState &rating1 = m_ratings[room.player1];
+    RatingState &rating2 = m_ratings[room.player2];
+    const double result1 = winner == "draw" ? 0.5 : (winner == room.player1 ? 1.0 : 0.0);
+    const int newRating1 = Rating::update(rating1.rating, rating2.rating, result1, rating1.games);
+    const int newRating2 = Rating::update(rating2.rating, rating1.rating, 1.0 - result1, rating2.games);
+
+    endMsg["player1_rating"] = newRating1;
+    endMsg["player2_rating"] = newRating2;
+    endMsg["player1_rating_change"] = newRating1 - rating1.rating;
+    endMsg["player2_rating_change"] = newRating2 - rating2.rating;
+
+    rating1.rating = newRating1;
+    rating2.rating = newRating2;
+    ++rating1.games;
+    ++rating2.games;
+
+    DbWorker *db = m_dbWorker;
+    const QString player1 = room.player1, player2 = room.player2;
+    QMetaObject::invokeMethod(db, [=]() {
+        db->saveRatings(player1, newRating1, player2, newRating2);
+    }, Qt::QueuedConnection);
+}
+
 // 实现cleanupRoom函数
 void ServerCore::cleanupRoom(const QString &roomId)
 {
@@ -812,8 +1172,8 @@ void ServerCore::cleanupRoom(const QString &roomId)
         }
 
         // 更新用户状态为在线
-        QTcpSocket *socket1 = m_usernameToSocket.value(room.player1);
-        QTcpSocket *socket2 = m_usernameToSocket.value(room.player2);
+        ClientId socket1 = m_usernameToSocket.value(room.player1);
+        ClientId socket2 = m_usernameToSocket.value(room.player2);
 
         if (socket1 && m_clients.contains(socket1)) {
             m_clients[socket1].status = "在线";
@@ -860,55 +1220,66 @@ void ServerCore::cleanupExpiredRooms()
     for (const QString &roomId : roomsToRemove) {
         cleanupRoom(roomId);
     }
+
+    // 匹配统计随清理周期打一行，调窗口参数时看等待时长和分差的分布
+    const QJsonObject metrics = m_matchmaker.metrics();
+    if (metrics["matches"].toDouble() > 0) {
+        emit logMessage(QString("匹配统计: %1")
+                            .arg(QString::fromUtf8(QJsonDocument(metrics).toJson(QJsonDocument::Compact))),
+                        QColor("#607D8B"));
+    }
 }
 
-void ServerCore::processChatMessage(QTcpSocket *socket, const QJsonObject &data)
+void ServerCore::processChatMessage(ClientId socket, const QJsonObject &data)
 {
     if (!m_clients.contains(socket)) return;
 
-    QString from = m_clients[socket].username;
-    QString to = data["to"].toString();
-    QString message = data["message"].toString();
+    const Protocol::Chat request = Protocol::Chat::fromJson(data);
+    const QString from = m_clients[socket].username;
+    const QString to = request.to;
 
-    QJsonObject chatMsg;
-    chatMsg["from"] = from;
-    chatMsg["message"] = message;
-    chatMsg["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    Protocol::Chat chat;
+    chat.from = from;
+    chat.message = request.message;
+    chat.timestamp = QDateTime::currentDateTime().toString(Qt::ISODate);
+    const QJsonObject chatMsg = chat.toJson();
 
     if (to == "all") {
         // 广播给所有在线用户
-        for (QTcpSocket *clientSocket : m_clients.keys()) {
-            if (clientSocket != socket) {
-                sendResponse(clientSocket, "chat", chatMsg);
-            }
+        QVector<ClientId> sockets;
+        for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+            if (it.key() != socket) sockets.append(it.key());
         }
+        broadcast(sockets, Protocol::MsgId::Chat, chatMsg);
         emit logMessage(QString("聊天广播: %1").arg(from), Qt::cyan);
     } else {
         // 私聊给指定用户
         if (m_usernameToSocket.contains(to)) {
-            QTcpSocket *toSocket = m_usernameToSocket[to];
-            sendResponse(toSocket, "chat", chatMsg);
+            ClientId toSocket = m_usernameToSocket[to];
+            sendResponse(toSocket, Protocol::MsgId::Chat, chatMsg);
 
             // 也发回给自己（确认发送）
-            sendResponse(socket, "chat", chatMsg);
+            sendResponse(socket, Protocol::MsgId::Chat, chatMsg);
 
             emit logMessage(QString("私聊: %1 -> %2").arg(from).arg(to), Qt::cyan);
         }
     }
 }
 
-void ServerCore::processHeartbeat(QTcpSocket *socket, const QJsonObject &data)
+void ServerCore::processHeartbeat(ClientId socket, const QJsonObject &data)
 {
     // 更新客户端活跃时间
     if (m_clients.contains(socket)) {
         QJsonObject response;
         response["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-        sendResponse(socket, "heartbeat_ack", response);
+        // 客户端的单调时钟时间戳原样带回，客户端据此测 RTT
+        if (data.contains("t")) response["t"] = data["t"];
+        sendResponse(socket, Protocol::MsgId::HeartbeatAck, response);
     }
 }
 
 // servercore.cpp - 修复processUserStatus函数
-void ServerCore::processUserStatus(QTcpSocket *socket, const QJsonObject &data){
+void ServerCore::processUserStatus(ClientId socket, const QJsonObject &data){
     if (!m_clients.contains(socket)) return;
 
     ClientInfo &info = m_clients[socket];
@@ -919,12 +1290,13 @@ void ServerCore::processUserStatus(QTcpSocket *socket, const QJsonObject &data){
         return;
     }
 
-    QString status = data["status"].toString();
-    QString gameMode = data["game_mode"].toString();
-    QString opponent = data["opponent"].toString();
+    const Protocol::UserStatus update = Protocol::UserStatus::fromJson(data);
+    const QString status = update.status;
+    const QString gameMode = update.gameMode;
 
-    // 更新客户端信息
+    // 更新客户端信息；离开“匹配中”就退出匹配队列
     info.status = status;
+    if (status != "匹配中") m_matchmaker.cancel(username);
     if (!gameMode.isEmpty()) {
         info.gameMode = gameMode;
     }
@@ -943,55 +1315,91 @@ void ServerCore::processUserStatus(QTcpSocket *socket, const QJsonObject &data){
 }
 
 // 修改 sendResponse 函数，确保格式正确
-void ServerCore::sendResponse(QTcpSocket *socket, const QString &type, const QJsonObject &data)
+void ServerCore::sendResponse(ClientId socket, Protocol::MsgId id, const QJsonObject &data)
 {
-    if (!socket || !socket->isValid()) return;
-
-    QJsonObject response;
-    response["type"] = type;
-    response["data"] = data;
-    response["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-    QJsonDocument doc(response);
-    socket->write(doc.toJson());
+    auto it = m_clients.constFind(socket);
+    if (it == m_clients.constEnd()) return;
+
+    // 编码和写出都在连接所在的 I/O 线程里做
+    const QJsonObject response = envelope(id, data);
+    const WireCodec::Format codec = it->codec;
+    IoWorker *io = m_ioWorkers[it->worker];
+    QMetaObject::invokeMethod(io, [io, socket, response, codec]() { io->send(socket, response, codec); },
+                              Qt::QueuedConnection);
+}
 
-    socket->flush();
+void ServerCore::broadcast(const QVector<ClientId> &sockets, Protocol::MsgId id, const QJsonObject &data)
+{
+    // 按 (格式, I/O 线程) 分组：信封只包一次，每种格式只编码一次，
+    // 每个 I/O 线程只排一次调用；QByteArray 隐式共享，各线程写的是同一块缓冲区
+    QHash<int, QVector<QVector<ClientId>>> targets;   // codec -> 每个 I/O 线程的收件人
+    for (ClientId socket : sockets) {
+        auto it = m_clients.constFind(socket);
+        if (it == m_clients.constEnd()) continue;
+        QVector<QVector<ClientId>> &perWorker = targets[int(it->codec)];
+        if (perWorker.isEmpty()) perWorker.resize(m_ioWorkers.size());
+        perWorker[it->worker].append(socket);
+    }
+    if (targets.isEmpty()) return;
+
+    const QJsonObject message = envelope(id, data);
+    for (auto t = targets.constBegin(); t != targets.constEnd(); ++t) {
+        const QByteArray frame = FrameCodec::encode(WireCodec::encode(message, WireCodec::Format(t.key())));
+        for (int w = 0; w < t->size(); ++w) {
+            const QVector<ClientId> ids = t->at(w);
+            if (ids.isEmpty()) continue;
+            IoWorker *io = m_ioWorkers[w];
+            QMetaObject::invokeMethod(io, [io, ids, frame]() { io->sendFrame(ids, frame); },
+                                      Qt::QueuedConnection);
+        }
+    }
 }
 
-// servercore.cpp - 修改broadcastOnlineList函数以包含更多信息
 void ServerCore::broadcastOnlineList()
 {
-    QJsonObject onlineList;
-    QJsonArray usersArray;
-
-    for (const ClientInfo &info : m_clients.values()) {
-        if (!info.username.isEmpty()) {
-            QJsonObject userObj;
-            userObj["username"] = info.username;
-            userObj["status"] = info.status;
-            userObj["game_mode"] = info.gameMode;
-            userObj["connect_time"] = info.connectTime.toString(Qt::ISODate);
-            userObj["ip_address"] = info.ipAddress;
+    // 登录、断线、状态变化都会走到这里；同一周期里的多次变化只发一份增量
+    if (!m_presenceTimer->isActive()) m_presenceTimer->start();
+}
 
-            usersArray.append(userObj);
-        }
+void ServerCore::onPresenceTick()
+{
+    QHash<QString, Presence::Entry> current;
+    for (const ClientInfo &info : m_clients) {
+        if (info.username.isEmpty()) continue;
+        Presence::Entry e;
+        e.username = info.username;
+        e.status = info.status;
+        e.gameMode = info.gameMode;
+        e.connectTime = info.connectTime.toString(Qt::ISODate);
+        e.ipAddress = info.ipAddress;
+        current.insert(e.username, e);
     }
 
-    onlineList["users"] = usersArray;
-    onlineList["count"] = usersArray.size();
-    onlineList["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    Protocol::PresenceDiff diff;
+    if (!m_presence.publish(current, diff)) return;
 
-    // 广播给所有已登录用户
-    for (QTcpSocket *socket : m_clients.keys()) {
-        if (!m_clients[socket].username.isEmpty()) {
-            sendResponse(socket, "online_list", onlineList);
-        }
+    // 已登录的客户端都收增量；断档的自己来要快照（get_online_list）
+    QVector<ClientId> clients;
+    for (auto it = m_clients.constBegin(); it != m_clients.constEnd(); ++it) {
+        if (!it->username.isEmpty()) clients.append(it.key());
     }
+    broadcast(clients, Protocol::MsgId::PresenceDiff, diff.toJson());
+}
+
+void ServerCore::processGetOnlineList(ClientId socket, const QJsonObject &data)
+{
+    Q_UNUSED(data);
+    if (m_clients.value(socket).username.isEmpty()) return;
+
+    // 刚登录或增量断档的客户端：给一份已发布状态的快照，之后的增量从它的 version 接着打
+    sendResponse(socket, Protocol::MsgId::OnlineList, m_presence.snapshot().toJson());
 }
 
 // 修改析构函数
 ServerCore::~ServerCore()
 {
     stopServer();
+    stopWorkers();
 
     // 清理所有定时器
     if (m_roomCleanupTimer) {
@@ -2,15 +2,23 @@
 #define SERVERCORE_H
 
 #include <QObject>
-#include <QTcpServer>
-#include <QTcpSocket>
 #include <QHash>
+#include <QVector>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QDateTime>
 #include <QColor>
 #include <QTimer>
+#include "../framecodec.h"
+#include "../wirecodec.h"
+#include "../protocol.h"
+#include "ioworker.h"
+#include "dbworker.h"
+#include "matchmaking.h"
+#include "presence.h"
+
+class QThread;
 
 struct ClientInfo {
     QString username;
@@ -18,7 +26,10 @@ struct ClientInfo {
     QDateTime connectTime;
     QString status;
     QString gameMode;
-    QTcpSocket *socket;
+    ClientId socket = 0;
+    int worker = 0;                       // 所在 I/O 线程
+    int protocolErrors = 0;               // 解不开、不认识的消息数，超过上限断开
+    WireCodec::Format codec = WireCodec::Json;  // 登录时协商的下行格式，协商前是 JSON
 };
 
 struct GameRoom {
@@ -35,7 +46,29 @@ struct GameRoom {
     bool gameEnded;
     QDateTime startTime;
     QTimer *timer;
+    quint32 seed;                         // 局种子，双方客户端据此推演同样的棋盘
+};
+
+// 等级分缓存：登录时从库里取，对局结束在这里算好再交给 DB 线程落库
+struct RatingState {
+    int rating = Rating::Initial;
+    int games = 0;                        // 已结算的联机局数，决定 K 值
+};
+
+// 登录会话：对局中掉线时保留一段宽限期，客户端凭令牌重连后接回原房间
+struct Session {
+    QString token;
+    ClientId socket = 0;                  // 掉线等待重连期间为 0
+    QTimer *graceTimer = nullptr;
+    QString status;                       // 掉线前的状态，重连后恢复
+    QString gameMode;
+    WireCodec::Format codec = WireCodec::Json;
+    QVector<QJsonObject> missed;          // 掉线期间发给他的消息（完整信封），重连时补发
+    bool missedOverflow = false;          // 超出上限被丢弃过，客户端需要重新要快照
 };
+/* 线程模型：监听和房间、会话、在线表等全部状态都在 ServerCore 所在线程，只有这一个线程读写，
+ * 不需要加锁；套接字分散在 N 个 I/O 线程里（IoWorker），分帧、解码、编码和收发都在那边做；
+ * 数据库调用在单独的线程（DbWorker）。线程之间只通过排队信号/槽传连接编号和 QJsonObject */
 class ServerCore : public QObject
 {
     Q_OBJECT
@@ -47,6 +80,10 @@ public:
     bool startServer(quint16 port);
     void stopServer();
 
+    // 启动以来所有连接累计的协议错误（超长帧、解析失败、未知消息）
+    quint64 protocolErrorCount() const { return m_protocolErrors; }
+    QJsonObject matchmakingMetrics() const { return m_matchmaker.metrics(); }
+
 signals:
     void logMessage(const QString &message, const QColor &color = Qt::white);
     void clientConnected();
@@ -57,35 +94,73 @@ signals:
     void userLoggedIn(const QString &username, const QString &ipAddress);
 
 private slots:
-    void onNewConnection();
-    void onClientDisconnected();
-    void onReadyRead();
+    void onIncomingConnection(qintptr descriptor);
+    void onClientOpened(ClientId socket, const QString &ipAddress);
+    void onClientClosed(ClientId socket);
+    void onClientMessage(ClientId socket, const QJsonObject &message);
+    void onProtocolError(ClientId socket, const QString &reason, bool fatal);
+    void onLoginVerified(ClientId socket, const QString &username, bool ok,
+                         const QJsonObject &userData, const QJsonObject &request);
+    void onPresenceTick();
 
 private:
-    void processLogin(QTcpSocket *socket, const QJsonObject &data);
-    void processMatchRequest(QTcpSocket *socket, const QJsonObject &data);
-    void processGameMove(QTcpSocket *socket, const QJsonObject &data);
-    void processChatMessage(QTcpSocket *socket, const QJsonObject &data);
-    void processHeartbeat(QTcpSocket *socket, const QJsonObject &data);
-    void processUserStatus(QTcpSocket *socket, const QJsonObject &data);
-    void processGameStart(QTcpSocket *socket, const QJsonObject &data);
-    void processGameEnd(QTcpSocket *socket, const QJsonObject &data);
-    void processPlayerQuit(QTcpSocket *socket, const QJsonObject &data);  // 新增
-    void sendResponse(QTcpSocket *socket, const QString &type, const QJsonObject &data = QJsonObject());
-    void broadcastOnlineList();
+    void startWorkers();
+    void stopWorkers();
+    void closeClient(ClientId socket, bool abort = false);
+    void handleMessage(ClientId socket, const QJsonObject &msg);
+    void recordProtocolError(ClientId socket, const QString &reason, bool fatal = false);
+    void processLogin(ClientId socket, const QJsonObject &data);
+    void processMatchRequest(ClientId socket, const QJsonObject &data);
+    void processCancelMatch(ClientId socket, const QJsonObject &data);
+    void processGameMove(ClientId socket, const QJsonObject &data);
+    void processChatMessage(ClientId socket, const QJsonObject &data);
+    void processHeartbeat(ClientId socket, const QJsonObject &data);
+    void processUserStatus(ClientId socket, const QJsonObject &data);
+    void processGameStart(ClientId socket, const QJsonObject &data);
+    void processGameEnd(ClientId socket, const QJsonObject &data);
+    void processPlayerQuit(ClientId socket, const QJsonObject &data);  // 新增
+    void processResume(ClientId socket, const QJsonObject &data);
+    void processGetOnlineList(ClientId socket, const QJsonObject &data);
+    void sendResponse(ClientId socket, Protocol::MsgId id, const QJsonObject &data = QJsonObject());
+    // 一条消息发给多人：每种格式只编码一次，各 I/O 线程共享同一份帧
+    void broadcast(const QVector<ClientId> &sockets, Protocol::MsgId id, const QJsonObject &data);
+    void broadcastOnlineList();           // 只标记在线表有变化，下一个周期统一发增量
+
+    // 会话
+    QString openSession(const QString &username, ClientId socket);
+    bool detachSession(ClientId socket, const ClientInfo &info);  // 对局中掉线才保留，返回是否保留
+    void expireSession(const QString &username);
+    bool queueMissed(const QString &username, Protocol::MsgId id, const QJsonObject &data);
+    void notifyOpponentLink(const QString &username, const QString &state);
 
     QHash<QString, GameRoom> m_gameRooms; // roomId -> GameRoom
     QHash<QString, QString> m_userToRoom; // username -> roomId
     void handleGameStart(const QString &roomId);
+    void onMatchTick();
+    void startMatch(const Matchmaker::Pairing &pair);
     void handleGameEnd(const QString &roomId);
+    void settleRatings(const GameRoom &room, const QString &winner, QJsonObject &endMsg);
     void broadcastRoomUpdate(const QString &roomId, const QString &excludeUser = "");
     void cleanupRoom(const QString &roomId);
     void cleanupExpiredRooms();
 
-    QTcpServer *m_tcpServer;
-    QHash<QTcpSocket*, ClientInfo> m_clients;
-    QHash<QString, QTcpSocket*> m_usernameToSocket;
+    ListenServer *m_tcpServer;
+    QVector<QThread*> m_ioThreads;
+    QVector<IoWorker*> m_ioWorkers;
+    QVector<int> m_ioLoad;                    // 每个 I/O 线程当前的连接数，新连接给最空的
+    QThread *m_dbThread = nullptr;
+    DbWorker *m_dbWorker = nullptr;
+    ClientId m_nextClientId = 1;
+    QHash<ClientId, ClientInfo> m_clients;
+    QHash<QString, ClientId> m_usernameToSocket;
+    QHash<QString, Session> m_sessions;       // username -> 会话
     QTimer *m_roomCleanupTimer;               // 房间清理定时器
+    Matchmaker m_matchmaker;
+    QHash<QString, RatingState> m_ratings;    // username -> 等级分，登录过的玩家
+    QTimer *m_matchTimer;                     // 批量配对，队列空了就停
+    Presence m_presence;
+    QTimer *m_presenceTimer;                  // 单次定时器：一个周期内的状态变化合成一份增量
+    quint64 m_protocolErrors = 0;
 };
 
 #endif // SERVERCORE_H
@@ -0,0 +1,109 @@
+// tilesprites.cpp
+#include "tilesprites.h"
+#include <QGuiApplication>
+#include <QPainter>
+#include <QDir>
+#include <QDebug>
+
+// 格子尺寸档位（逻辑像素）
+static const int kBuckets[] = { 32, 40, 48, 56, 64, 80, 96 };
+
+TileSprites& TileSprites::instance()
+{
+    static TileSprites sprites;
+    return sprites;
+}
+
+int TileSprites::bucketFor(int maxCellSize)
+{
+    int bucket = kBuckets[0];
+    for (int b : kBuckets)
+        if (b <= maxCellSize) bucket = b;
+    return bucket;
+}
+
+void TileSprites::preload(int cellSize, qreal dpr)
+{
+    rasterize(cellSize, dpr);
+}
+
+bool TileSprites::rasterize(int cellSize, qreal dpr)
+{
+    loadSources();
+    const int bucket = bucketFor(cellSize);
+    if (m_loaded && bucket == m_cellSize && qFuzzyCompare(dpr, m_dpr)) return false;
+
+    m_cellSize = bucket;
+    m_dpr = dpr;
+    m_pixmapCache.clear();
+    m_loaded = true;
+
+    // 当前档位的图集先拼好，第一帧就是纯贴图
+    atlas(bucket, dpr);
+    return true;
+}
+
+void TileSprites::loadSources()
+{
+    if (m_sourcesLoaded) return;
+    for (int i = 0; i < COLOR_COUNT; ++i) {
+        QString path = QString("%1%2.png").arg(QDir::currentPath() + "/").arg(i);
+        m_sources[i] = QPixmap(path);
+        if (m_sources[i].isNull()) qWarning() << "方块图片加载失败:" << path;
+    }
+    m_sourcesLoaded = true;
+}
+
+void TileSprites::ensureLoaded()
+{
+    // 兜底：没在启动时预加载就在第一次使用时加载
+    if (!m_loaded) preload(m_cellSize, qGuiApp ? qGuiApp->devicePixelRatio() : 1.0);
+}
+
+QPixmap TileSprites::pixmap(int color, int size)
+{
+    loadSources();
+    if (color < 0 || color >= COLOR_COUNT) return QPixmap();
+
+    const int key = size * COLOR_COUNT + color;
+    auto it = m_pixmapCache.constFind(key);
+    if (it != m_pixmapCache.constEnd()) return it.value();
+
+    QPixmap pix = scaled(color, qRound(size * m_dpr));
+    pix.setDevicePixelRatio(m_dpr);
+    m_pixmapCache.insert(key, pix);
+    return pix;
+}
+
+/* 6 种方块横向拼成一张，按格子尺寸和 DPR 预先缩放好，绘制时只按源矩形贴图 */
+const QPixmap &TileSprites::atlas(int size, qreal dpr)
+{
+    ensureLoaded();
+    if (m_atlas.isNull() || m_atlasSize != size || m_atlasDpr != dpr) {
+        const int px = qRound(size * dpr);
+        m_atlas = QPixmap(px * COLOR_COUNT, px);
+        m_atlas.fill(Qt::transparent);
+
+        QPainter p(&m_atlas);
+        for (int i = 0; i < COLOR_COUNT; ++i)
+            p.drawPixmap(i * px, 0, scaled(i, px));
+
+        m_atlasSize = size;
+        m_atlasDpr = dpr;
+    }
+    return m_atlas;
+}
+
+QPixmap TileSprites::scaled(int color, int px) const
+{
+    QPixmap out(px, px);
+    out.fill(Qt::transparent);
+
+    const QPixmap &src = m_sources[color];
+    if (src.isNull()) return out;
+
+    QPixmap img = src.scaled(px, px, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    QPainter p(&out);
+    p.drawPixmap((px - img.width()) / 2, (px - img.height()) / 2, img);
+    return out;
+}
@@ -0,0 +1,52 @@
+// tilesprites.h
+#ifndef TILESPRITES_H
+#define TILESPRITES_H
+
+#include <QPixmap>
+#include <QHash>
+#include "gameboard.h"
+
+/* 进程级方块精灵缓存：启动时把 0..5.png 解码一次。BoardView 从 atlas() 取一张按格子档位
+ * 和 DPR 预缩放好的横向图集，每帧只按源矩形贴图，不再缩放原图；窗口尺寸跨档（或换到
+ * 不同 DPR 的屏幕）时 rasterize() 才重做。pixmap() 给棋盘外的单张预览图。只在 GUI 线程使用 */
+class TileSprites
+{
+public:
+    static TileSprites& instance();
+
+    // 格子尺寸档位：返回不超过 maxCellSize 的最大档位（不足最小档时取最小档）
+    static int bucketFor(int maxCellSize);
+
+    // 启动时调用：按格子档位和 DPR 预栅格化全部颜色
+    void preload(int cellSize, qreal dpr);
+    // 档位或 DPR 变化时才重新栅格化，返回是否重做
+    bool rasterize(int cellSize, qreal dpr);
+    int cellSize() const { return m_cellSize; }
+    qreal dpr() const { return m_dpr; }
+
+    QPixmap pixmap(int color, int size);          // 任意逻辑尺寸（如变身模式的预览图）
+    const QPixmap &atlas(int size, qreal dpr);    // BoardView 用的横向图集
+
+private:
+    TileSprites() = default;
+    TileSprites(const TileSprites&) = delete;
+    TileSprites& operator=(const TileSprites&) = delete;
+
+    void loadSources();
+    void ensureLoaded();
+    QPixmap scaled(int color, int px) const;      // 等比缩放并居中到 px×px
+
+    QPixmap m_sources[COLOR_COUNT];               // 原图，只解码一次
+    QHash<int, QPixmap> m_pixmapCache;            // key = size * COLOR_COUNT + color
+
+    QPixmap m_atlas;
+    int m_atlasSize = 0;
+    qreal m_atlasDpr = 0;
+
+    int m_cellSize = 48;
+    qreal m_dpr = 1.0;
+    bool m_sourcesLoaded = false;
+    bool m_loaded = false;
+};
+
+#endif // TILESPRITES_H
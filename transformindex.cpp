@@ -0,0 +1,93 @@
+// transformindex.cpp
+#include "transformindex.h"
+#include <QtAlgorithms>
+
+void TransformIndex::rebuild(const Grid &g)
+{
+    for (int c = 0; c < COLOR_COUNT; ++c) m_targets[c] = 0;
+    for (int i = 0; i < ROW * COL; ++i) m_mask[i] = 0;
+    for (int r = 0; r < ROW; ++r)
+        for (int c = 0; c < COL; ++c)
+            setMask(r * COL + c, computeMask(g, r, c));
+    m_dirty = 0;
+}
+
+/* 一个格子能否成三只取决于同行/同列左右上下各 2 格，
+ * 所以 (r,c) 变化时只影响它自己和十字方向 ±2 的格子 */
+void TransformIndex::markDirty(int r, int c)
+{
+    for (int d = -2; d <= 2; ++d) {
+        int nr = r + d, nc = c + d;
+        if (nr >= 0 && nr < ROW) m_dirty |= quint64(1) << (nr * COL + c);
+        if (nc >= 0 && nc < COL) m_dirty |= quint64(1) << (r * COL + nc);
+    }
+}
+
+void TransformIndex::refresh(const Grid &g)
+{
+    while (m_dirty) {
+        int idx = qCountTrailingZeroBits(m_dirty);
+        m_dirty &= m_dirty - 1;
+        setMask(idx, computeMask(g, idx / COL, idx % COL));
+    }
+}
+
+bool TransformIndex::canMatch(int r, int c, int color) const
+{
+    if (color < 0 || color >= COLOR_COUNT) return false;
+    return m_mask[r * COL + c] & (1u << color);
+}
+
+bool TransformIndex::hasAnyTarget() const
+{
+    for (int c = 0; c < COLOR_COUNT; ++c)
+        if (m_targets[c]) return true;
+    return false;
+}
+
+bool TransformIndex::firstTarget(int color, int &outR, int &outC) const
+{
+    if (color < 0 || color >= COLOR_COUNT || !m_targets[color]) return false;
+    int idx = qCountTrailingZeroBits(m_targets[color]);
+    outR = idx / COL;
+    outC = idx % COL;
+    return true;
+}
+
+/* 只看邻居组成的三种形态：左左、右右、左右（纵向同理），
+ * 哪种颜色能把 (r,c) 补成三连就置位；已经是该颜色的不算（变身无意义） */
+quint8 TransformIndex::computeMask(const Grid &g, int r, int c)
+{
+    auto at = [&g](int rr, int cc) {
+        return (rr >= 0 && rr < ROW && cc >= 0 && cc < COL) ? g[rr][cc].pic : -1;
+    };
+
+    quint8 mask = 0;
+    auto pair = [&mask](int a, int b) {
+        if (a >= 0 && a == b) mask |= quint8(1u << a);
+    };
+
+    pair(at(r, c - 1), at(r, c - 2));
+    pair(at(r, c + 1), at(r, c + 2));
+    pair(at(r, c - 1), at(r, c + 1));
+    pair(at(r - 1, c), at(r - 2, c));
+    pair(at(r + 1, c), at(r + 2, c));
+    pair(at(r - 1, c), at(r + 1, c));
+
+    int own = g[r][c].pic;
+    if (own >= 0) mask &= quint8(~(1u << own));
+    return mask;
+}
+
+void TransformIndex::setMask(int idx, quint8 mask)
+{
+    quint8 old = m_mask[idx];
+    if (old == mask) return;
+    m_mask[idx] = mask;
+
+    quint64 bit = quint64(1) << idx;
+    for (int c = 0; c < COLOR_COUNT; ++c) {
+        if (mask & (1u << c)) m_targets[c] |= bit;
+        else m_targets[c] &= ~bit;
+    }
+}
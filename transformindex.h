@@ -0,0 +1,36 @@
+// transformindex.h
+#ifndef TRANSFORMINDEX_H
+#define TRANSFORMINDEX_H
+
+#include <QtGlobal>
+#include "gameboard.h"
+
+/* 变身模式的目标索引：记录每个格子变成某种颜色后能否立即成三连
+ * 表大小 64×6，每格一个 6 位掩码；格子变化后只重算同行/同列距离 2 以内的格子 */
+class TransformIndex
+{
+public:
+    void rebuild(const Grid &g);         // 全盘重建（开局、洗牌、悔棋）
+    void markDirty(int r, int c);        // 标记 (r,c) 已变化
+    void refresh(const Grid &g);         // 重算所有脏格（需在棋盘稳定后调用）
+
+    bool canMatch(int r, int c, int color) const;
+
+    // 某种颜色的全部目标格，位序号 = r * COL + c，可直接用于后续动物的预判
+    quint64 targets(int color) const { return m_targets[color]; }
+    bool hasTarget(int color) const { return m_targets[color] != 0; }
+    bool hasAnyTarget() const;           // 任何颜色都无法成三即为死局
+
+    // 取行优先的第一个目标格（与原先逐格扫描的顺序一致）
+    bool firstTarget(int color, int &outR, int &outC) const;
+
+private:
+    static quint8 computeMask(const Grid &g, int r, int c);
+    void setMask(int idx, quint8 mask);
+
+    quint8  m_mask[ROW * COL] = {};      // 格子 -> 颜色掩码
+    quint64 m_targets[COLOR_COUNT] = {}; // 颜色 -> 格子位图（同一张表的转置）
+    quint64 m_dirty = 0;
+};
+
+#endif // TRANSFORMINDEX_H
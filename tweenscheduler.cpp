@@ -0,0 +1,207 @@
+// tweenscheduler.cpp
+#include "tweenscheduler.h"
+#include <QHash>
+#include <QtMath>
+
+TweenScheduler::TweenScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.setTimerType(Qt::PreciseTimer);
+    m_clock.setInterval(16); // ~60 FPS
+    connect(&m_clock, &QTimer::timeout, this, &TweenScheduler::onClockTick);
+    m_elapsed.start();
+}
+
+const QEasingCurve &TweenScheduler::curve(QEasingCurve::Type type)
+{
+    static QHash<int, QEasingCurve> curves;
+    auto it = curves.find(type);
+    if (it == curves.end()) it = curves.insert(type, QEasingCurve(type));
+    return it.value();
+}
+
+/* ========================================================= */
+/* 阶段 */
+/* ========================================================= */
+
+int TweenScheduler::beginPhase()
+{
+    Phase ph;
+    ph.id = m_nextPhase++;
+    ph.pending = 0;
+    ph.sealed = false;
+    m_phases.append(ph);
+    return ph.id;
+}
+
+void TweenScheduler::endPhase(int phase, std::function<void()> onFinished)
+{
+    for (int i = 0; i < m_phases.size(); ++i) {
+        if (m_phases[i].id != phase) continue;
+        m_phases[i].sealed = true;
+        m_phases[i].onFinished = std::move(onFinished);
+        if (m_phases[i].pending == 0) firePhase(i);
+        return;
+    }
+}
+
+void TweenScheduler::finishTween(int phase)
+{
+    if (phase == 0) return;
+    for (int i = 0; i < m_phases.size(); ++i) {
+        if (m_phases[i].id != phase) continue;
+        if (--m_phases[i].pending == 0 && m_phases[i].sealed) firePhase(i);
+        return;
+    }
+}
+
+void TweenScheduler::firePhase(int index)
+{
+    std::function<void()> cb = std::move(m_phases[index].onFinished);
+    m_phases.remove(index);
+    if (!cb) return;
+
+    const int gen = m_generation;
+    QTimer::singleShot(0, this, [this, gen, cb]() {
+        if (gen == m_generation) cb();
+    });
+}
+
+void TweenScheduler::stop()
+{
+    m_tweens.clear();
+    m_phases.clear();
+    m_loops = 0;
+    ++m_generation;
+    m_clock.stop();
+    emit stopped();
+}
+
+/* ========================================================= */
+/* 补间 */
+/* ========================================================= */
+
+void TweenScheduler::animate(const void *target, int channel, qreal from, qreal to, int duration,
+                             Setter setter, QEasingCurve::Type easing, int phase, int delay)
+{
+    addTween({target, channel, Ease, from, to, 0, duration, easing, phase, std::move(setter)}, delay);
+}
+
+void TweenScheduler::shake(const void *target, int channel, qreal amplitude, int duration,
+                           Setter setter, int phase)
+{
+    addTween({target, channel, Shake, 0, amplitude, 0, duration, QEasingCurve::Linear, phase,
+              std::move(setter)}, 0);
+}
+
+void TweenScheduler::pulse(const void *target, int channel, qreal from, qreal to, int period, Setter setter)
+{
+    addTween({target, channel, Pulse, from, to, 0, period, QEasingCurve::InOutSine, 0,
+              std::move(setter)}, 0);
+}
+
+void TweenScheduler::cancel(const void *target, int channel)
+{
+    QVector<int> phases;
+    for (int i = m_tweens.size() - 1; i >= 0; --i) {
+        const Tween &tw = m_tweens[i];
+        if (tw.target != target || (channel >= 0 && tw.channel != channel)) continue;
+        phases.append(tw.phase);
+        removeAt(i);
+    }
+    for (int phase : phases) finishTween(phase);
+}
+
+void TweenScheduler::removeAt(int index)
+{
+    if (m_tweens[index].kind == Pulse) --m_loops;
+    m_tweens.remove(index);
+}
+
+void TweenScheduler::addTween(Tween tw, int delay)
+{
+    if (!tw.setter) return;
+
+    // 同一目标的同一通道只保留最新的补间
+    for (int i = 0; i < m_tweens.size(); ++i) {
+        if (m_tweens[i].target == tw.target && m_tweens[i].channel == tw.channel) {
+            int old = m_tweens[i].phase;
+            removeAt(i);
+            finishTween(old);
+            break;
+        }
+    }
+
+    if (m_speed <= 0) {
+        // 瞬间：不进补间表，也不占阶段计数
+        tw.setter(valueAt(tw, tw.kind == Pulse ? 0.0 : 1.0));
+        return;
+    }
+
+    tw.start = m_elapsed.elapsed() + qRound(delay / m_speed);
+    tw.duration = qRound(tw.duration / m_speed);
+    tw.setter(valueAt(tw, 0));
+
+    for (Phase &ph : m_phases)
+        if (ph.id == tw.phase) { ++ph.pending; break; }
+    if (tw.kind == Pulse) ++m_loops;
+    m_tweens.append(std::move(tw));
+
+    if (!m_clock.isActive()) m_clock.start();
+}
+
+qreal TweenScheduler::valueAt(const Tween &tw, qreal progress) const
+{
+    switch (tw.kind) {
+    case Ease:
+        return tw.from + (tw.to - tw.from) * curve(tw.easing).valueForProgress(progress);
+    case Shake:
+        // 左 → 右 → 回原位
+        return -tw.to * qSin(progress * 2 * M_PI);
+    case Pulse:
+        // 前半周期 from → to，后半周期原路返回
+        return tw.from + (tw.to - tw.from) * curve(tw.easing).valueForProgress(1 - qAbs(progress * 2 - 1));
+    }
+    return tw.to;
+}
+
+void TweenScheduler::onClockTick()
+{
+    const qint64 now = m_elapsed.elapsed();
+    QVector<int> finished;
+
+    // 一帧内把全部数值写完，持有者在 frameAdvanced 里统一重绘一次
+    int keep = 0;
+    for (int i = 0; i < m_tweens.size(); ++i) {
+        Tween &tw = m_tweens[i];
+        const qint64 t = now - tw.start;
+        if (t < 0) {                                // 还在延迟中
+            if (keep != i) m_tweens[keep] = std::move(tw);
+            ++keep;
+            continue;
+        }
+
+        if (tw.kind == Pulse) {
+            tw.setter(valueAt(tw, tw.duration > 0 ? qreal(t % tw.duration) / tw.duration : 0.0));
+            if (keep != i) m_tweens[keep] = std::move(tw);
+            ++keep;
+            continue;
+        }
+
+        const qreal progress = tw.duration > 0 ? qMin<qreal>(qreal(t) / tw.duration, 1.0) : 1.0;
+        tw.setter(valueAt(tw, progress));
+
+        if (progress >= 1.0) {
+            finished.append(tw.phase);
+        } else {
+            if (keep != i) m_tweens[keep] = std::move(tw);
+            ++keep;
+        }
+    }
+    m_tweens.resize(keep);
+
+    emit frameAdvanced(m_tweens.size());
+
+    for (int phase : finished) finishTween(phase);
+    if (m_tweens.isEmpty()) m_clock.stop();
+}
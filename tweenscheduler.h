@@ -0,0 +1,99 @@
+// tweenscheduler.h
+#ifndef TWEENSCHEDULER_H
+#define TWEENSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QEasingCurve>
+#include <QVector>
+#include <functional>
+
+/* 棋盘动画调度器：每个棋盘一个（由 BoardView 持有）。所有补间（方块位移、缩放、透明度、
+ * 抖动，以及特效、选中框）放在一个扁平数组里，由同一个定时器推进；每帧推进完发一次
+ * frameAdvanced，棋盘据此只重绘一次。补间只是“目标 + 通道 + 数值区间 + 写回函数”，
+ * 不创建 QPropertyAnimation 树，也不用 QGraphicsOpacityEffect。
+ *
+ * 阶段(phase)：beginPhase() 拿到编号，往里加补间，最后 endPhase() 挂上完成回调。
+ * 回调总是异步触发，可以在回调里直接开始下一阶段（交换 → 消除 → 下落 → 连击检测） */
+class TweenScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Setter = std::function<void(qreal)>;
+
+    explicit TweenScheduler(QObject *parent = nullptr);
+
+    int beginPhase();
+    void endPhase(int phase, std::function<void()> onFinished = {});  // 一个补间都没有也照常回调
+
+    // 数值补间：from 立即写入（带延迟的也是，用来在开始前隐藏），之后每帧把插值交给 setter。
+    // 同一 target 的同一 channel 只保留最新的补间
+    void animate(const void *target, int channel, qreal from, qreal to, int duration, Setter setter,
+                 QEasingCurve::Type easing = QEasingCurve::Linear, int phase = 0, int delay = 0);
+    // 抖动：0 → -amplitude → +amplitude → 0（正数先左后右）
+    void shake(const void *target, int channel, qreal amplitude, int duration, Setter setter, int phase = 0);
+    // 呼吸：from → to → from 循环，直到 cancel；不属于任何阶段，也不算忙
+    void pulse(const void *target, int channel, qreal from, qreal to, int period, Setter setter);
+
+    // 丢弃补间（不写终值），所属阶段照常计完；channel < 0 表示该目标的全部通道
+    void cancel(const void *target, int channel = -1);
+    void stop();                                    // 丢弃全部补间和阶段，不回调（退出、跳过动画时用）
+
+    bool isBusy() const { return m_tweens.size() > m_loops || !m_phases.isEmpty(); }
+    int activeCount() const { return m_tweens.size(); }
+
+    // 播放速度：之后开始的补间时长和延迟都除以它（已在播的不受影响）；
+    // 0 = 瞬间，补间直接落到终点，阶段照常异步回调
+    void setSpeed(qreal speed) { m_speed = qMax<qreal>(speed, 0); }
+    qreal speed() const { return m_speed; }
+
+    // 缓动曲线按类型只建一次
+    static const QEasingCurve &curve(QEasingCurve::Type type);
+
+signals:
+    void frameAdvanced(int activeTweens);           // 每帧推进后发出（重绘、性能面板用）
+    void stopped();                                 // stop() 之后发出，持有者据此清掉残留状态
+
+private:
+    enum Kind { Ease, Shake, Pulse };
+
+    struct Tween {
+        const void *target;
+        int channel;
+        Kind kind;
+        qreal from, to;
+        qint64 start;                               // 相对时钟的开始时间 (ms)
+        int duration;
+        QEasingCurve::Type easing;
+        int phase;
+        Setter setter;
+    };
+
+    struct Phase {
+        int id;
+        int pending;
+        bool sealed;                                // endPhase 之后才允许回调
+        std::function<void()> onFinished;
+    };
+
+    void addTween(Tween tw, int delay);
+    void removeAt(int index);
+    qreal valueAt(const Tween &tw, qreal progress) const;
+    void finishTween(int phase);
+    void firePhase(int index);
+    void onClockTick();
+
+    QVector<Tween> m_tweens;
+    QVector<Phase> m_phases;
+    int m_loops = 0;                                // m_tweens 里呼吸补间的个数
+    int m_nextPhase = 1;
+    int m_generation = 0;                           // stop() 后作废已投递的回调
+    qreal m_speed = 1;
+
+    QTimer m_clock;
+    QElapsedTimer m_elapsed;
+};
+
+#endif // TWEENSCHEDULER_H
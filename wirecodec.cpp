@@ -0,0 +1,82 @@
+// wirecodec.cpp
+#include "wirecodec.h"
+#include "boardcodec.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QCborMap>
+#include <QCborValue>
+
+static const QString kBoardKey = QStringLiteral("board");
+
+static QCborMap toCborMap(const QJsonObject &obj)
+{
+    QCborMap map;
+    for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+        const QJsonValue v = it.value();
+        if (it.key() == kBoardKey && v.isArray()) {
+            Grid g{};
+            if (BoardCodec::fromJson(v.toArray(), g)) {
+                map.insert(it.key(), QCborValue(BoardCodec::pack(g)));
+                continue;
+            }
+        }
+        if (v.isObject()) map.insert(it.key(), toCborMap(v.toObject()));
+        else map.insert(it.key(), QCborValue::fromJsonValue(v));
+    }
+    return map;
+}
+
+static QJsonObject fromCborMap(const QCborMap &map)
+{
+    QJsonObject obj;
+    for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+        const QString key = it.key().toString();
+        const QCborValue v = it.value();
+        if (key == kBoardKey && v.isByteArray()) {
+            Grid g{};
+            if (BoardCodec::unpack(v.toByteArray(), g)) obj.insert(key, BoardCodec::toJson(g));
+            continue;
+        }
+        if (v.isMap()) obj.insert(key, fromCborMap(v.toMap()));
+        else obj.insert(key, v.toJsonValue());
+    }
+    return obj;
+}
+
+QString WireCodec::name(Format format)
+{
+    return format == Cbor ? QStringLiteral("cbor") : QStringLiteral("json");
+}
+
+bool WireCodec::fromName(const QString &name, Format &format)
+{
+    if (name == "cbor") { format = Cbor; return true; }
+    if (name == "json") { format = Json; return true; }
+    return false;
+}
+
+QByteArray WireCodec::encode(const QJsonObject &message, Format format)
+{
+    if (format == Cbor) return QCborValue(toCborMap(message)).toCbor();
+    return QJsonDocument(message).toJson(QJsonDocument::Compact);
+}
+
+bool WireCodec::decode(const QByteArray &payload, QJsonObject &message)
+{
+    if (payload.isEmpty()) return false;
+
+    const uchar first = uchar(payload.at(0));
+    if (first >= 0xA0 && first <= 0xBF) {
+        QCborParserError error;
+        QCborValue v = QCborValue::fromCbor(payload, &error);
+        if (error.error != QCborError::NoError || !v.isMap()) return false;
+        message = fromCborMap(v.toMap());
+        return true;
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(payload, &error);
+    if (error.error != QJsonParseError::NoError || !doc.isObject()) return false;
+    message = doc.object();
+    return true;
+}
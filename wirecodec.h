@@ -0,0 +1,26 @@
+// wirecodec.h
+#ifndef WIRECODEC_H
+#define WIRECODEC_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+
+/* 帧负载编码：紧凑 JSON 或 CBOR，客户端、服务器共用。
+ * 登录时协商：客户端在 login 里带 codecs 列表，服务器在 login_result 里回选中的 codec；
+ * 协商前（login / login_result 本身）用 JSON。没有共同格式的一方版本不兼容，登录失败。
+ * 解码按首字节自动识别（JSON 对象以 '{' 开头，CBOR map 是 0xA0~0xBF），切换时不会错帧。
+ * CBOR 下名为 board 的 64 格数组打包成 24 字节的字节串（见 BoardCodec），
+ * 上层拿到的仍是普通 QJsonObject，收发代码不用区分格式 */
+namespace WireCodec
+{
+    enum Format { Json, Cbor };
+
+    QString name(Format format);
+    bool fromName(const QString &name, Format &format);
+
+    QByteArray encode(const QJsonObject &message, Format format);
+    bool decode(const QByteArray &payload, QJsonObject &message);
+}
+
+#endif // WIRECODEC_H